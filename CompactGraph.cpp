@@ -0,0 +1,781 @@
+/*
+   @file    CompactGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include "CompactGraph.hh"
+#include "Kernels.hh"
+#include "Parallel.hh"
+
+using namespace GraphLib;
+
+int CompactGraph::reverseCuthillMcKee = 0;
+int CompactGraph::degreeSort = 1;
+int CompactGraph::hubClustering = 2;
+int CompactGraph::gorder = 3;
+const unsigned CompactGraph::unreachable;
+
+/**
+   Build the CSR arrays from G
+
+   @param  G graph to compact
+*/
+CompactGraph::CompactGraph(const Graph& G) : _directed(G.isOriented()) {
+   GRAPH_STAT_TIMER("compact");
+   for(auto v = G._node.begin(); v != G._node.end(); ++v) {
+      if(G._alive(v) && _id.insert(std::make_pair(*v, _name.size())).second)
+         _name.push_back(*v);
+   }
+
+   /** out-edges, in the order of the Graph's successor lists */
+   _offset.assign(nodes() + 1, 0);
+   for(unsigned v = 0; v < nodes(); ++v) {
+      const Graph::nodeList& succ = G._adjacent(_name[v]);
+      for(auto w = succ.begin(); w != succ.end(); ++w) {
+         _target.push_back(_id[*w]);
+         _weight.push_back(G.weight(_name[v], *w));
+      }
+      _offset[v + 1] = _target.size();
+   }
+   _buildInEdges();
+}
+
+/**
+   Constructor, empty graph
+
+   @param  directed graph oriented or not
+*/
+CompactGraph::CompactGraph(bool directed) : _directed(directed), _offset(1, 0) {
+}
+
+/**
+   Reverse CSR from the out-edges: counting sort of the edges by target
+
+   @return void
+*/
+void CompactGraph::_buildInEdges() {
+   _inOffset.assign(nodes() + 1, 0);
+   for(unsigned long e = 0; e < edges(); ++e)
+      ++_inOffset[_target[e] + 1];
+   for(unsigned v = 0; v < nodes(); ++v)
+      _inOffset[v + 1] += _inOffset[v];
+
+   std::vector<unsigned long> next(_inOffset.begin(), _inOffset.end() - 1);
+   _source.resize(edges());
+   _inEdge.resize(edges());
+   for(unsigned v = 0; v < nodes(); ++v) {
+      for(unsigned long e = begin(v); e < end(v); ++e) {
+         unsigned long slot = next[_target[e]]++;
+         _source[slot] = v;
+         _inEdge[slot] = e;
+      }
+   }
+}
+
+/**
+   @param  node name of the node in the Graph
+   @return id of the node, nodes() if it doesn't exist
+*/
+unsigned CompactGraph::id(const std::string& node) const {
+   std::map<std::string, unsigned>::const_iterator v = _id.find(node);
+   return v != _id.end() ? v->second : nodes();
+}
+
+/**
+   PageRank with uniform teleport
+
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node, indexed by id, summing to 1
+*/
+std::vector<double> CompactGraph::pageRank(double damping, double tolerance,
+                                           unsigned maxIterations, unsigned threads) const {
+   return personalizedPageRank(std::vector<double>(nodes(), 1), damping, tolerance,
+                               maxIterations, threads);
+}
+
+/**
+   Personalized PageRank, pull-based power iteration over the in-edges.
+   The walk restarts from the teleport distribution with probability
+   1 - damping, and always restarts from a dangling node
+
+   @param  teleport      restart weight of every node (normalized here),
+                         uniform if it sums to 0
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node, indexed by id, summing to 1
+*/
+std::vector<double> CompactGraph::personalizedPageRank(const std::vector<double>& teleport,
+                                                       double damping, double tolerance,
+                                                       unsigned maxIterations,
+                                                       unsigned threads) const {
+   return kernels::pageRank(*this, teleport, damping, tolerance, maxIterations, threads);
+}
+
+/**
+   Approximate personalized PageRank of source by local pushes
+   (Andersen-Chung-Lang): only the nodes around source are touched.
+   Every node keeps less than epsilon * max(degree, 1) residual
+
+   @param  source  node id of the seed
+   @param  alpha   restart probability (1 - damping)
+   @param  epsilon residual tolerance
+   @return approximate rank of the nodes reached, indexed by id
+*/
+std::map<unsigned, double> CompactGraph::approximatePageRank(unsigned source, double alpha,
+                                                             double epsilon) const {
+   GRAPH_STAT_TIMER("approximatePageRank");
+   std::map<unsigned, double> estimate;
+   if(source >= nodes())
+      return estimate;
+
+   std::map<unsigned, double> residual;
+   std::vector<unsigned> queue(1, source);
+   residual[source] = 1;
+
+   while(!queue.empty()) {
+      unsigned u = queue.back();
+      queue.pop_back();
+      double r = residual[u];
+      if(r < epsilon * std::max(degree(u), 1u))
+         continue;
+
+      estimate[u] += alpha * r;
+      residual[u] = 0;
+
+      double total = 0;
+      for(unsigned long e = begin(u); e < end(u); ++e)
+         total += std::max(_weight[e], 0.0);
+
+      /** a dangling node gives its mass back to the seed */
+      if(total <= 0) {
+         double& rs = residual[source];
+         rs += (1 - alpha) * r;
+         if(rs >= epsilon * std::max(degree(source), 1u))
+            queue.push_back(source);
+         continue;
+      }
+      for(unsigned long e = begin(u); e < end(u); ++e) {
+         unsigned v = _target[e];
+         double& rv = residual[v];
+         double threshold = epsilon * std::max(degree(v), 1u);
+         bool below = rv < threshold;
+         rv += (1 - alpha) * r * std::max(_weight[e], 0.0) / total;
+         if(below && rv >= threshold)
+            queue.push_back(v);
+      }
+   }
+   return estimate;
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return number of triangles of the graph
+*/
+unsigned long CompactGraph::triangles(unsigned threads) const {
+   std::vector<unsigned long> count = triangleCount(threads);
+   unsigned long total = 0;
+   for(auto c = count.begin(); c != count.end(); ++c)
+      total += *c;
+   return total / 3;
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return triangles through every node, indexed by id
+*/
+std::vector<unsigned long> CompactGraph::triangleCount(unsigned threads) const {
+   return kernels::triangleCount(*this, threads);
+}
+
+/**
+   Local clustering coefficient: fraction of the pairs of neighbours of a
+   node that are themselves adjacent, 0 for nodes with less than two
+   neighbours
+
+   @param  threads worker threads, 0 = all cores
+   @return coefficient per node, indexed by id
+*/
+std::vector<double> CompactGraph::clusteringCoefficient(unsigned threads) const {
+   return kernels::clusteringCoefficient(*this, threads);
+}
+
+/**
+   k-truss: largest subgraph where every edge belongs to at least k - 2
+   triangles. Edges are peeled in order of support; removing an edge
+   lowers the support of the two other edges of each of its triangles
+
+   @param  k truss order, k <= 2 keeps every edge
+   @return undirected edges (u < v) of the k-truss
+*/
+std::vector<std::pair<unsigned, unsigned> > CompactGraph::kTruss(unsigned k) const {
+   return kernels::kTruss(*this, k);
+}
+
+/**
+   Minimum spanning forest of the undirected graph underneath (self loops
+   ignored, the cheapest of parallel edges used).
+   Graph::kruskal sorts the edge list (one range per thread, then merged)
+   and keeps every edge joining two components of a union-find.
+   Graph::boruvka works in rounds: every node looks for its cheapest edge
+   leaving its component (in parallel over the nodes), every component
+   takes the cheapest of those, and the components are merged; the number
+   of components at least halves each round
+
+   @param  forest  edges selected, as (u, v) with u < v
+   @param  method  Graph::kruskal or Graph::boruvka
+   @param  threads worker threads, 0 = all cores
+   @return total weight of the forest
+*/
+double CompactGraph::minimumSpanningForest(std::vector<std::pair<unsigned, unsigned> >& forest,
+                                           int method, unsigned threads) const {
+   return kernels::minimumSpanningForest(*this, forest, method, threads);
+}
+
+namespace {
+   /**
+      Highest-label push-relabel (first phase: a maximum preflow, enough
+      for the value of the flow and the minimum cut).
+      The residual graph is kept in flat arrays: the arcs of v are its
+      out-edges followed by the reverse of its in-edges, and _pair[a] is
+      the index of the opposite arc of a. Heights are reset by a reverse
+      BFS from the sink (global relabeling) after every n relabels, and
+      when no node is left at some height the nodes above it are lifted
+      to n at once (gap heuristic): they can't reach the sink any more
+   */
+   class Preflow {
+
+   public:
+      Preflow(const CompactGraph& C, unsigned source, unsigned sink)
+         : _n(C.nodes()), _source(source), _sink(sink) {
+         std::vector<unsigned long> slot(C.edges());
+         _offset.assign(_n + 1, 0);
+         for(unsigned v = 0; v < _n; ++v) {
+            for(unsigned long i = C.inBegin(v); i < C.inEnd(v); ++i)
+               slot[C.inEdge(i)] = i;
+            _offset[v + 1] = _offset[v] + (C.end(v) - C.begin(v)) + (C.inEnd(v) - C.inBegin(v));
+         }
+
+         _head.resize(_offset[_n]);
+         _capacity.resize(_offset[_n]);
+         _pair.resize(_offset[_n]);
+         for(unsigned v = 0; v < _n; ++v) {
+            for(unsigned long e = C.begin(v); e < C.end(v); ++e) {
+               unsigned w = C.target(e);
+               unsigned long a = _offset[v] + (e - C.begin(v));
+               unsigned long b = _offset[w] + (C.end(w) - C.begin(w)) + (slot[e] - C.inBegin(w));
+               _head[a] = w;
+               _capacity[a] = std::max(C.weight(e), 0.0);
+               _pair[a] = b;
+               _head[b] = v;
+               _capacity[b] = 0;
+               _pair[b] = a;
+            }
+         }
+      }
+
+      /** @return value of the maximum flow */
+      double run() {
+         _height.assign(_n, 0);
+         _excess.assign(_n, 0);
+         _current.assign(_offset.begin(), _offset.end() - 1);
+         _height[_source] = _n;
+         for(unsigned long a = _offset[_source]; a < _offset[_source + 1]; ++a)
+            _push(_source, a, _capacity[a]);
+         _globalRelabel();
+
+         unsigned long relabels = 0;
+         while(_highest >= 0) {
+            if(_active[_highest].empty()) {
+               --_highest;
+               continue;
+            }
+            unsigned v = _active[_highest].back();
+            _active[_highest].pop_back();
+            if(_height[v] != unsigned(_highest) || _excess[v] <= 0)
+               continue;
+            relabels += _discharge(v);
+            if(relabels >= _n) {
+               _globalRelabel();
+               relabels = 0;
+            }
+         }
+         return _excess[_sink];
+      }
+
+      /** nodes that can't reach the sink in the residual graph */
+      void sourceSide(std::vector<char>& side) const {
+         side.assign(_n, 1);
+         std::vector<unsigned> queue(1, _sink);
+         side[_sink] = 0;
+         for(std::size_t i = 0; i < queue.size(); ++i) {
+            unsigned w = queue[i];
+            for(unsigned long a = _offset[w]; a < _offset[w + 1]; ++a) {
+               unsigned u = _head[a];
+               if(side[u] && _capacity[_pair[a]] > 0) {
+                  side[u] = 0;
+                  queue.push_back(u);
+               }
+            }
+         }
+      }
+
+   private:
+      unsigned _n;
+      unsigned _source;
+      unsigned _sink;
+
+      std::vector<unsigned long> _offset;
+      std::vector<unsigned>      _head;
+      std::vector<double>        _capacity;
+      std::vector<unsigned long> _pair;
+
+      std::vector<unsigned>      _height;
+      std::vector<double>        _excess;
+      std::vector<unsigned long> _current;
+      /** active nodes by height, checked when popped */
+      std::vector<std::vector<unsigned> > _active;
+      long                                _highest;
+      /** every node below n by height, _where[v] = index in _level[_height[v]] */
+      std::vector<std::vector<unsigned> > _level;
+      std::vector<std::size_t>            _where;
+
+      void _push(unsigned v, unsigned long a, double amount) {
+         unsigned w = _head[a];
+         if(amount <= 0)
+            return;
+         if(_excess[w] <= 0 && w != _source && w != _sink && _height[w] < _n && !_active.empty())
+            _activate(w);
+         _capacity[a] -= amount;
+         _capacity[_pair[a]] += amount;
+         _excess[v] -= amount;
+         _excess[w] += amount;
+      }
+
+      void _activate(unsigned v) {
+         _active[_height[v]].push_back(v);
+         _highest = std::max<long>(_highest, _height[v]);
+      }
+
+      void _enter(unsigned v) {
+         _where[v] = _level[_height[v]].size();
+         _level[_height[v]].push_back(v);
+      }
+
+      void _leave(unsigned v) {
+         std::vector<unsigned>& level = _level[_height[v]];
+         unsigned last = level.back();
+         level[_where[v]] = last;
+         _where[last] = _where[v];
+         level.pop_back();
+      }
+
+      /** exact heights: distance to the sink in the residual graph */
+      void _globalRelabel() {
+         _height.assign(_n, _n);
+         _height[_sink] = 0;
+         std::vector<unsigned> queue(1, _sink);
+         for(std::size_t i = 0; i < queue.size(); ++i) {
+            unsigned w = queue[i];
+            for(unsigned long a = _offset[w]; a < _offset[w + 1]; ++a) {
+               unsigned u = _head[a];
+               if(_height[u] == _n && u != _source && _capacity[_pair[a]] > 0) {
+                  _height[u] = _height[w] + 1;
+                  queue.push_back(u);
+               }
+            }
+         }
+         _height[_source] = _n;
+
+         _active.assign(_n, std::vector<unsigned>());
+         _level.assign(_n, std::vector<unsigned>());
+         _where.assign(_n, 0);
+         _highest = -1;
+         for(unsigned v = 0; v < _n; ++v) {
+            _current[v] = _offset[v];
+            if(_height[v] >= _n)
+               continue;
+            _enter(v);
+            if(_excess[v] > 0 && v != _sink)
+               _activate(v);
+         }
+      }
+
+      /** push the excess of v away, relabeling when it's stuck
+          @return number of relabels */
+      unsigned long _discharge(unsigned v) {
+         unsigned long relabels = 0;
+         while(_excess[v] > 0) {
+            if(_current[v] == _offset[v + 1]) {
+               ++relabels;
+               if(!_relabel(v))
+                  return relabels;
+               continue;
+            }
+            unsigned long a = _current[v];
+            if(_capacity[a] > 0 && _height[v] == _height[_head[a]] + 1)
+               _push(v, a, std::min(_excess[v], _capacity[a]));
+            else
+               ++_current[v];
+         }
+         return relabels;
+      }
+
+      /** @return is v still below n? */
+      bool _relabel(unsigned v) {
+         unsigned old = _height[v];
+         unsigned height = _n;
+         for(unsigned long a = _offset[v]; a < _offset[v + 1]; ++a) {
+            if(_capacity[a] > 0)
+               height = std::min(height, _height[_head[a]] + 1);
+         }
+         _leave(v);
+         _current[v] = _offset[v];
+
+         if(_level[old].empty()) {
+            /** gap: nothing above old can reach the sink */
+            for(unsigned h = old + 1; h < _n; ++h) {
+               for(auto u = _level[h].begin(); u != _level[h].end(); ++u)
+                  _height[*u] = _n;
+               _level[h].clear();
+            }
+            height = _n;
+         }
+         _height[v] = height;
+         if(height >= _n)
+            return false;
+         _enter(v);
+         return true;
+      }
+
+   /** class Preflow */
+   };
+}
+
+/**
+   Maximum flow from source to sink, edge weights as capacities (negative
+   weights count as 0); an undirected edge carries up to its weight in
+   each direction. Highest-label push-relabel, see Preflow
+
+   @param  source node id the flow leaves from
+   @param  sink   node id the flow arrives to
+   @return value of the flow, 0 if source == sink or an id is out of range
+*/
+double CompactGraph::maxFlow(unsigned source, unsigned sink) const {
+   std::vector<char> side;
+   return minCut(source, sink, side);
+}
+
+/**
+   Minimum cut between source and sink: the source side is the set of
+   nodes that can't reach the sink in the residual graph of a maximum
+   preflow
+
+   @param  source     node id the flow leaves from
+   @param  sink       node id the flow arrives to
+   @param  sourceSide per node flag, 1 on the side of the source
+   @return capacity of the cut (value of the maximum flow)
+*/
+double CompactGraph::minCut(unsigned source, unsigned sink, std::vector<char>& sourceSide) const {
+   GRAPH_STAT_TIMER("maxFlow");
+   sourceSide.assign(nodes(), 0);
+   if(source >= nodes() || sink >= nodes() || source == sink) {
+      if(source < nodes())
+         sourceSide[source] = 1;
+      return 0;
+   }
+   Preflow preflow(*this, source, sink);
+   double flow = preflow.run();
+   preflow.sourceSide(sourceSide);
+   return flow;
+}
+
+/**
+   Exact betweenness centrality (Brandes): for every node, the number of
+   shortest paths between other pairs that go through it, each pair
+   weighted by 1 / (number of its shortest paths). In an undirected graph
+   every pair is counted once. Weighted paths need positive weights
+
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @return betweenness of every node, indexed by id
+*/
+std::vector<double> CompactGraph::betweenness(bool weighted, unsigned threads) const {
+   return kernels::betweenness(*this, weighted, threads);
+}
+
+/**
+   Number of sampled sources needed so that, with probability at least
+   1 - delta, the betweenness of every node divided by (n - 1)(n - 2) is
+   estimated within epsilon (Hoeffding bound with a union bound over the
+   nodes)
+
+   @param  nodes   number of nodes
+   @param  epsilon error bound on the normalized betweenness
+   @param  delta   probability that some node exceeds the bound
+   @return number of samples
+*/
+unsigned long CompactGraph::betweennessSamples(unsigned nodes, double epsilon, double delta) {
+   if(nodes < 3 || epsilon <= 0 || delta <= 0)
+      return nodes;
+   /** every sample lies in [0, n / (n - 1)] once normalized */
+   double range = double(nodes) / (nodes - 1);
+   return std::ceil(range * range * std::log(2.0 * nodes / delta) / (2 * epsilon * epsilon));
+}
+
+/**
+   Betweenness estimated from sources drawn uniformly at random (with
+   replacement), scaled by n / samples. Falls back to the exact
+   computation when the bound asks for n samples or more
+
+   @param  epsilon  error bound on the normalized betweenness
+   @param  delta    probability that some node exceeds the bound
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @param  seed     seed of the sampling
+   @return estimated betweenness of every node, indexed by id
+*/
+std::vector<double> CompactGraph::approximateBetweenness(double epsilon, double delta,
+                                                         bool weighted, unsigned threads,
+                                                         unsigned seed) const {
+   return kernels::approximateBetweenness(*this, epsilon, delta, weighted, threads, seed);
+}
+
+/**
+   Core number of every node: the largest k such that the node belongs to
+   a subgraph where every node has degree at least k. Nodes are peeled by
+   increasing remaining degree.
+   With one thread: Batagelj-Zaversnik, nodes kept sorted by degree in
+   bucket arrays and moved down one bucket per peeled neighbour, O(V + E).
+   With more: level by level, every node of degree <= k is peeled at once
+   (in parallel), and neighbours whose degree drops to k form the next
+   wave of the same level
+
+   @param  order   nodes in the order they were peeled (degeneracy order)
+   @param  threads 1 = bucket algorithm, otherwise parallel peeling
+                   (0 = all cores)
+   @return core number of every node, indexed by id
+*/
+std::vector<unsigned> CompactGraph::coreNumbers(std::vector<unsigned>& order,
+                                                unsigned threads) const {
+   return kernels::coreNumbers(*this, order, threads);
+}
+
+/**
+   Order of the nodes for a locality strategy (see reorder()):
+   reverseCuthillMcKee: BFS of every component of the undirected graph
+   from a node of least degree, neighbours by increasing degree, reversed.
+   degreeSort: decreasing total degree, ties in current order.
+   hubClustering: nodes of degree above average first, then the others,
+   both in current order.
+   gorder: greedy placement of the node sharing the most with the last
+   5 placed (edges to them and common in-neighbours); in-neighbours of
+   degree above sqrt(n) are not expanded
+
+   @param  strategy CompactGraph::reverseCuthillMcKee, degreeSort,
+                    hubClustering or gorder
+   @return order[i] = id of the node to put at position i
+*/
+std::vector<unsigned> CompactGraph::permutation(int strategy) const {
+   GRAPH_STAT_TIMER("permutation");
+   const unsigned n = nodes();
+   std::vector<unsigned> order;
+   order.reserve(n);
+   std::vector<unsigned long> total(n);
+   for(unsigned v = 0; v < n; ++v)
+      total[v] = (end(v) - begin(v)) + (inEnd(v) - inBegin(v));
+
+   if(strategy == degreeSort || strategy == hubClustering) {
+      for(unsigned v = 0; v < n; ++v)
+         order.push_back(v);
+      if(strategy == degreeSort) {
+         std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+            return total[a] > total[b];
+         });
+      }
+      else {
+         double average = n ? 2.0 * edges() / n : 0;
+         std::stable_partition(order.begin(), order.end(), [&](unsigned v) {
+            return total[v] > average;
+         });
+      }
+      return order;
+   }
+
+   std::vector<char> placed(n, 0);
+   if(strategy == gorder) {
+      const unsigned window = 5;
+      const unsigned long hub = std::sqrt(double(n)) + 1;
+      std::vector<long> score(n, 0);
+      typedef std::pair<long, unsigned> entry;
+      std::priority_queue<entry> heap;
+
+      /** add delta to the score of the unplaced nodes related to v */
+      auto update = [&](unsigned v, long delta) {
+         auto bump = [&](unsigned u) {
+            if(!placed[u]) {
+               score[u] += delta;
+               heap.push(entry(score[u], u));
+            }
+         };
+         for(unsigned long e = begin(v); e < end(v); ++e)
+            bump(_target[e]);
+         for(unsigned long e = inBegin(v); e < inEnd(v); ++e) {
+            unsigned x = _source[e];
+            bump(x);
+            if(end(x) - begin(x) > hub)
+               continue;
+            for(unsigned long f = begin(x); f < end(x); ++f)
+               bump(_target[f]);
+         }
+      };
+
+      unsigned start = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         heap.push(entry(0, v));
+         if(inEnd(v) - inBegin(v) > inEnd(start) - inBegin(start))
+            start = v;
+      }
+      for(unsigned v = start; order.size() < n; ) {
+         placed[v] = 1;
+         order.push_back(v);
+         update(v, 1);
+         if(order.size() > window)
+            update(order[order.size() - window - 1], -1);
+         while(!heap.empty() && (placed[heap.top().second] ||
+                                 heap.top().first != score[heap.top().second]))
+            heap.pop();
+         if(heap.empty())
+            break;
+         v = heap.top().second;
+      }
+      return order;
+   }
+
+   kernels::SortedAdjacency A(*this);
+   std::vector<unsigned> byDegree(n);
+   for(unsigned v = 0; v < n; ++v)
+      byDegree[v] = v;
+   std::stable_sort(byDegree.begin(), byDegree.end(), [&](unsigned a, unsigned b) {
+      return A.degree(a) < A.degree(b);
+   });
+   std::vector<unsigned> neighbours;
+   for(auto root = byDegree.begin(); root != byDegree.end(); ++root) {
+      if(placed[*root])
+         continue;
+      placed[*root] = 1;
+      order.push_back(*root);
+      for(std::size_t q = order.size() - 1; q < order.size(); ++q) {
+         unsigned v = order[q];
+         neighbours.clear();
+         for(unsigned long e = A.offset[v]; e < A.offset[v + 1]; ++e) {
+            if(!placed[A.adjacent[e]]) {
+               placed[A.adjacent[e]] = 1;
+               neighbours.push_back(A.adjacent[e]);
+            }
+         }
+         std::stable_sort(neighbours.begin(), neighbours.end(), [&](unsigned a, unsigned b) {
+            return A.degree(a) < A.degree(b);
+         });
+         order.insert(order.end(), neighbours.begin(), neighbours.end());
+      }
+   }
+   std::reverse(order.begin(), order.end());
+   return order;
+}
+
+/**
+   Renumber the nodes: the node at order[i] gets id i. The out-edges of
+   every node are sorted by new target id. Nothing happens if order is
+   not a permutation of the ids
+
+   @param  order order[i] = current id of the node to put at position i
+   @return void
+*/
+void CompactGraph::relabel(const std::vector<unsigned>& order) {
+   GRAPH_STAT_TIMER("relabel");
+   const unsigned n = nodes();
+   if(order.size() != n)
+      return;
+   std::vector<unsigned> newId(n, n);
+   for(unsigned i = 0; i < n; ++i) {
+      if(order[i] >= n || newId[order[i]] != n)
+         return;
+      newId[order[i]] = i;
+   }
+
+   std::vector<std::string> name(n);
+   std::vector<unsigned long> offset(n + 1, 0);
+   std::vector<unsigned> target;
+   std::vector<double> weight;
+   target.reserve(edges());
+   weight.reserve(edges());
+   std::vector<std::pair<unsigned, double> > row;
+   for(unsigned i = 0; i < n; ++i) {
+      unsigned v = order[i];
+      name[i].swap(_name[v]);
+      _id[name[i]] = i;
+      row.clear();
+      for(unsigned long e = begin(v); e < end(v); ++e)
+         row.push_back(std::make_pair(newId[_target[e]], _weight[e]));
+      std::stable_sort(row.begin(), row.end(),
+                       [](const std::pair<unsigned, double>& a,
+                          const std::pair<unsigned, double>& b) { return a.first < b.first; });
+      for(auto r = row.begin(); r != row.end(); ++r) {
+         target.push_back(r->first);
+         weight.push_back(r->second);
+      }
+      offset[i + 1] = target.size();
+   }
+   _name.swap(name);
+   _offset.swap(offset);
+   _target.swap(target);
+   _weight.swap(weight);
+   _buildInEdges();
+}
+
+/**
+   Relabel the nodes so that neighbours get close ids and the algorithms
+   touch nearby memory; see permutation()
+
+   @param  strategy CompactGraph::reverseCuthillMcKee, degreeSort,
+                    hubClustering or gorder
+   @return void
+*/
+void CompactGraph::reorder(int strategy) {
+   relabel(permutation(strategy));
+}
+
+/**
+   Hop distances from every source. The sources are split in batches of
+   256 that share one multi-source BFS pass; batches run in parallel
+
+   @param  sources node ids
+   @param  threads worker threads, 0 = all cores
+   @return distance[i][v] from sources[i] to v, unreachable if not reached
+*/
+std::vector<std::vector<unsigned> > CompactGraph::distances(const std::vector<unsigned>& sources,
+                                                            unsigned threads) const {
+   return kernels::distances(*this, sources, threads);
+}
+
+/**
+   Answer a batch of "can u reach v?" queries. Queries are grouped by
+   source, 256 distinct sources per multi-source BFS pass, and a pass
+   stops as soon as all of its queries are answered
+
+   @param  queries (u, v) node id pairs
+   @param  threads worker threads, 0 = all cores
+   @return 1 if u reaches v, for every query in order
+*/
+std::vector<char> CompactGraph::reachable(const std::vector<std::pair<unsigned, unsigned> >& queries,
+                                          unsigned threads) const {
+   return kernels::reachable(*this, queries, threads);
+}
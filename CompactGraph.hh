@@ -0,0 +1,146 @@
+/*
+   @file    CompactGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef COMPACT_GRAPH_HH
+#define COMPACT_GRAPH_HH 1
+
+#include <string>
+#include <vector>
+#include <map>
+#include "Graph.hh"
+
+namespace GraphLib {
+
+/** Read-only compressed sparse row (CSR) copy of a Graph.
+    Nodes are numbered 0 ... nodes()-1 in the order they were added to the
+    Graph, until reorder() relabels them for locality (name() and id()
+    keep mapping to the Graph's names); the out-edges of v are targets [begin(v), end(v)) and the
+    in-edges are kept in a second (reverse) CSR for pull-based algorithms
+*/
+class CompactGraph {
+
+   /** builds its bases straight from merged edge lists */
+   friend class DeltaGraph;
+
+public:
+   /** reorder(): reverse Cuthill-McKee, bandwidth minimizing BFS order */
+   static int reverseCuthillMcKee;
+   /** reorder(): by decreasing degree */
+   static int degreeSort;
+   /** reorder(): nodes of degree above average first, order kept otherwise */
+   static int hubClustering;
+   /** reorder(): nodes sharing neighbours placed close together */
+   static int gorder;
+
+   /** distances(): node not reached from the source */
+   static const unsigned unreachable = ~0u;
+
+   explicit CompactGraph(const Graph& G);
+
+   inline unsigned      nodes() const;
+   inline unsigned long edges() const;
+   inline bool          isOriented() const;
+
+   inline const std::string& name(unsigned v) const;
+   unsigned id(const std::string& node) const;
+
+   /** out-edges of v */
+   inline unsigned long begin(unsigned v) const;
+   inline unsigned long end(unsigned v) const;
+   inline unsigned      target(unsigned long e) const;
+   inline double        weight(unsigned long e) const;
+   inline unsigned      degree(unsigned v) const;
+
+   /** in-edges of v */
+   inline unsigned long inBegin(unsigned v) const;
+   inline unsigned long inEnd(unsigned v) const;
+   inline unsigned      source(unsigned long e) const;
+   inline unsigned long inEdge(unsigned long e) const;
+
+   /** neighbour iteration shared with GraphView (see Kernels.hh) */
+   inline unsigned idBound() const;
+   inline bool     contains(unsigned v) const;
+   template<typename F> void forEachOut(unsigned v, F fn) const;
+   template<typename F> void forEachIn(unsigned v, F fn) const;
+
+   /** locality: order[i] = current id of the node to put at position i */
+   std::vector<unsigned> permutation(int strategy) const;
+   void relabel(const std::vector<unsigned>& order);
+   void reorder(int strategy);
+
+   std::vector<double> pageRank(double damping = 0.85, double tolerance = 1e-9,
+                                unsigned maxIterations = 100, unsigned threads = 0) const;
+   std::vector<double> personalizedPageRank(const std::vector<double>& teleport,
+                                            double damping = 0.85, double tolerance = 1e-9,
+                                            unsigned maxIterations = 100,
+                                            unsigned threads = 0) const;
+   std::map<unsigned, double> approximatePageRank(unsigned source, double alpha = 0.15,
+                                                  double epsilon = 1e-6) const;
+
+   /** local structure, on the undirected simple graph underneath */
+   unsigned long                     triangles(unsigned threads = 0) const;
+   std::vector<unsigned long>        triangleCount(unsigned threads = 0) const;
+   std::vector<double>               clusteringCoefficient(unsigned threads = 0) const;
+   std::vector<std::pair<unsigned, unsigned> > kTruss(unsigned k) const;
+
+   /** minimum spanning forest, edge directions ignored */
+   double minimumSpanningForest(std::vector<std::pair<unsigned, unsigned> >& forest,
+                                int method = Graph::kruskal, unsigned threads = 0) const;
+
+   /** flows, edge weights as capacities */
+   double maxFlow(unsigned source, unsigned sink) const;
+   double minCut(unsigned source, unsigned sink, std::vector<char>& sourceSide) const;
+
+   /** betweenness centrality, edge weights as lengths when weighted;
+       empty if a parallel::Scope stopped it */
+   std::vector<double> betweenness(bool weighted = false, unsigned threads = 0) const;
+   std::vector<double> approximateBetweenness(double epsilon = 0.01, double delta = 0.1,
+                                              bool weighted = false, unsigned threads = 0,
+                                              unsigned seed = 1) const;
+   static unsigned long betweennessSamples(unsigned nodes, double epsilon, double delta);
+
+   /** batched traversals, 256 sources per pass (multi-source BFS); empty
+       if a parallel::Scope stopped them */
+   std::vector<std::vector<unsigned> > distances(const std::vector<unsigned>& sources,
+                                                 unsigned threads = 0) const;
+   std::vector<char> reachable(const std::vector<std::pair<unsigned, unsigned> >& queries,
+                               unsigned threads = 0) const;
+
+   /** k-cores of the undirected simple graph underneath */
+   std::vector<unsigned> coreNumbers(std::vector<unsigned>& order, unsigned threads = 1) const;
+
+private:
+   bool _directed;
+
+   /** id -> name and name -> id */
+   std::vector<std::string>        _name;
+   std::map<std::string, unsigned> _id;
+
+   /** out-edges of v: _target[_offset[v]] ... _target[_offset[v + 1] - 1] */
+   std::vector<unsigned long> _offset;
+   std::vector<unsigned>      _target;
+   std::vector<double>        _weight;
+
+   /** in-edges of v: _source[_inOffset[v]] ..., _inEdge is the index of
+       the same edge in the out-edge arrays */
+   std::vector<unsigned long> _inOffset;
+   std::vector<unsigned>      _source;
+   std::vector<unsigned long> _inEdge;
+
+   /** no node, filled by DeltaGraph */
+   explicit CompactGraph(bool directed);
+
+   void _buildInEdges();
+
+/** class CompactGraph */
+};
+
+/** include inline functions */
+#include "CompactGraph_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //COMPACT_GRAPH_HH
@@ -0,0 +1,162 @@
+/*
+   @file    CompactGraph_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef COMPACT_GRAPH_INLINES_HH
+#define COMPACT_GRAPH_INLINES_HH 1
+
+/**
+   @return number of nodes
+*/
+inline unsigned
+CompactGraph::nodes() const {
+   return _name.size();
+}
+
+/**
+   @return number of edges
+*/
+inline unsigned long
+CompactGraph::edges() const {
+   return _target.size();
+}
+
+/**
+   @return graph oriented or not?
+*/
+inline bool
+CompactGraph::isOriented() const {
+   return _directed;
+}
+
+/**
+   @param  v node id
+   @return name of v in the Graph
+*/
+inline const std::string&
+CompactGraph::name(unsigned v) const {
+   return _name[v];
+}
+
+/**
+   @param  v node id
+   @return index of the first out-edge of v
+*/
+inline unsigned long
+CompactGraph::begin(unsigned v) const {
+   return _offset[v];
+}
+
+/**
+   @param  v node id
+   @return one past the index of the last out-edge of v
+*/
+inline unsigned long
+CompactGraph::end(unsigned v) const {
+   return _offset[v + 1];
+}
+
+/**
+   @param  e out-edge index
+   @return node the edge points to
+*/
+inline unsigned
+CompactGraph::target(unsigned long e) const {
+   return _target[e];
+}
+
+/**
+   @param  e out-edge index
+   @return weight of the edge
+*/
+inline double
+CompactGraph::weight(unsigned long e) const {
+   return _weight[e];
+}
+
+/**
+   @param  v node id
+   @return number of out-edges of v
+*/
+inline unsigned
+CompactGraph::degree(unsigned v) const {
+   return _offset[v + 1] - _offset[v];
+}
+
+/**
+   @param  v node id
+   @return index of the first in-edge of v
+*/
+inline unsigned long
+CompactGraph::inBegin(unsigned v) const {
+   return _inOffset[v];
+}
+
+/**
+   @param  v node id
+   @return one past the index of the last in-edge of v
+*/
+inline unsigned long
+CompactGraph::inEnd(unsigned v) const {
+   return _inOffset[v + 1];
+}
+
+/**
+   @param  e in-edge index
+   @return node the edge comes from
+*/
+inline unsigned
+CompactGraph::source(unsigned long e) const {
+   return _source[e];
+}
+
+/**
+   @param  e in-edge index
+   @return index of the same edge among the out-edges
+*/
+inline unsigned long
+CompactGraph::inEdge(unsigned long e) const {
+   return _inEdge[e];
+}
+
+/**
+   @return ids are 0 ... idBound() - 1
+*/
+inline unsigned
+CompactGraph::idBound() const {
+   return nodes();
+}
+
+/**
+   @param  v node id
+   @return is v a node of the graph?
+*/
+inline bool
+CompactGraph::contains(unsigned v) const {
+   return v < nodes();
+}
+
+/**
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double) on the edges v -> w
+   @return void
+*/
+template<typename F> void
+CompactGraph::forEachOut(unsigned v, F fn) const {
+   for(unsigned long e = _offset[v]; e < _offset[v + 1]; ++e)
+      fn(_target[e], _weight[e]);
+}
+
+/**
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double) on the edges w -> v
+   @return void
+*/
+template<typename F> void
+CompactGraph::forEachIn(unsigned v, F fn) const {
+   for(unsigned long e = _inOffset[v]; e < _inOffset[v + 1]; ++e)
+      fn(_source[e], _weight[_inEdge[e]]);
+}
+
+#endif
@@ -0,0 +1,379 @@
+/*
+   @file    CompressedGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cmath>
+#include "CompressedGraph.hh"
+#include "Parallel.hh"
+
+using namespace GraphLib;
+
+namespace {
+   /** shortest run of consecutive ids stored as an interval */
+   const unsigned minInterval = 4;
+
+   /** little endian base 128: 7 bits per byte, high bit = more bytes */
+   void put(std::vector<unsigned char>& data, unsigned long x) {
+      while(x >= 128) {
+         data.push_back(static_cast<unsigned char>(x | 128));
+         x >>= 7;
+      }
+      data.push_back(static_cast<unsigned char>(x));
+   }
+
+   unsigned long get(const unsigned char*& p) {
+      unsigned long x = 0;
+      unsigned shift = 0;
+      while(*p & 128) {
+         x |= static_cast<unsigned long>(*p++ & 127) << shift;
+         shift += 7;
+      }
+      return x | static_cast<unsigned long>(*p++) << shift;
+   }
+
+   /** signed differences as small unsigned numbers: 0, -1, 1, -2, ... */
+   unsigned long zigzag(long x) {
+      return x < 0 ? (static_cast<unsigned long>(-(x + 1)) << 1) | 1
+                   : static_cast<unsigned long>(x) << 1;
+   }
+
+   long unzigzag(unsigned long x) {
+      return x & 1 ? -static_cast<long>(x >> 1) - 1 : static_cast<long>(x >> 1);
+   }
+}
+
+/**
+   Constructor: every list is encoded against each of the previous window
+   nodes (and against none) and the shortest encoding is kept
+
+   @param  C        graph to compress
+   @param  window   how many previous nodes a list may copy from
+   @param  maxChain longest chain of references to decode a list
+*/
+CompressedGraph::CompressedGraph(const CompactGraph& C, unsigned window, unsigned maxChain)
+   : _directed(C.isOriented()), _nodes(C.nodes()), _edges(0), _maxChain(maxChain) {
+   GRAPH_STAT_TIMER("compress");
+   const unsigned n = _nodes;
+   bool weighted = false;
+   for(unsigned long e = 0; e < C.edges() && !weighted; ++e)
+      weighted = C.weight(e) != 1;
+
+   /** the lists of the last window + 1 nodes, by v % (window + 1) */
+   std::vector<std::vector<unsigned> > recent(window + 1);
+   std::vector<unsigned> chain(n, 0);
+   std::vector<std::pair<unsigned, double> > edges;
+   std::vector<unsigned char> best;
+   _offset.assign(n + 1, 0);
+   if(weighted)
+      _first.assign(n + 1, 0);
+
+   for(unsigned v = 0; v < n; ++v) {
+      edges.clear();
+      for(unsigned long e = C.begin(v); e < C.end(v); ++e)
+         edges.push_back(std::make_pair(C.target(e), C.weight(e)));
+      std::stable_sort(edges.begin(), edges.end(),
+                       [](const std::pair<unsigned, double>& a,
+                          const std::pair<unsigned, double>& b) { return a.first < b.first; });
+      std::vector<unsigned>& list = recent[v % (window + 1)];
+      list.clear();
+      for(auto e = edges.begin(); e != edges.end(); ++e) {
+         if(!list.empty() && list.back() == e->first)
+            continue;
+         list.push_back(e->first);
+         if(weighted)
+            _weight.push_back(static_cast<float>(e->second));
+      }
+      _edges += list.size();
+      if(weighted)
+         _first[v + 1] = _weight.size();
+
+      /** no reference first, then every candidate */
+      std::size_t start = _data.size();
+      _encode(v, list, list, 0);
+      best.assign(_data.begin() + start, _data.end());
+      for(unsigned d = 1; d <= window && d <= v && !list.empty(); ++d) {
+         if(chain[v - d] >= maxChain)
+            continue;
+         _data.resize(start);
+         _encode(v, list, recent[(v - d) % (window + 1)], d);
+         if(_data.size() - start < best.size()) {
+            best.assign(_data.begin() + start, _data.end());
+            chain[v] = chain[v - d] + 1;
+         }
+      }
+      _data.resize(start);
+      _data.insert(_data.end(), best.begin(), best.end());
+      _offset[v + 1] = _data.size();
+   }
+   _data.shrink_to_fit();
+}
+
+/**
+   Append the list of v: degree, reference distance (0 = none), copy
+   blocks over the reference list (alternate copied / skipped runs, the
+   skipped tail implicit), intervals and residual gaps
+
+   @param  v         node id
+   @param  list      sorted neighbours of v
+   @param  reference sorted neighbours of v - distance
+   @param  distance  0 for no reference
+   @return void
+*/
+void CompressedGraph::_encode(unsigned v, const std::vector<unsigned>& list,
+                              const std::vector<unsigned>& reference, unsigned distance) {
+   put(_data, list.size());
+   if(list.empty())
+      return;
+   put(_data, distance);
+
+   std::vector<unsigned> rest;
+   if(distance > 0) {
+      std::vector<unsigned long> runs;
+      bool copying = true;
+      unsigned long run = 0;
+      std::vector<unsigned>::const_iterator l = list.begin();
+      for(auto r = reference.begin(); r != reference.end(); ++r) {
+         while(l != list.end() && *l < *r)
+            rest.push_back(*l++);
+         bool copied = l != list.end() && *l == *r;
+         if(copied)
+            ++l;
+         if(copied != copying) {
+            runs.push_back(run);
+            copying = copied;
+            run = 0;
+         }
+         ++run;
+      }
+      rest.insert(rest.end(), l, list.end());
+      if(copying)
+         runs.push_back(run);
+      put(_data, runs.size());
+      for(std::size_t i = 0; i < runs.size(); ++i)
+         put(_data, i == 0 ? runs[i] : runs[i] - 1);
+   }
+   const std::vector<unsigned>& left = distance > 0 ? rest : list;
+
+   /** maximal runs of consecutive ids */
+   std::vector<std::pair<unsigned, unsigned> > intervals;
+   std::vector<unsigned> residuals;
+   for(std::size_t i = 0; i < left.size(); ) {
+      std::size_t j = i + 1;
+      while(j < left.size() && left[j] == left[j - 1] + 1)
+         ++j;
+      if(j - i >= minInterval)
+         intervals.push_back(std::make_pair(left[i], j - i));
+      else
+         residuals.insert(residuals.end(), left.begin() + i, left.begin() + j);
+      i = j;
+   }
+   put(_data, intervals.size());
+   for(std::size_t i = 0; i < intervals.size(); ++i) {
+      if(i == 0)
+         put(_data, zigzag(static_cast<long>(intervals[i].first) - v));
+      else
+         put(_data, intervals[i].first - (intervals[i - 1].first + intervals[i - 1].second) - 1);
+      put(_data, intervals[i].second - minInterval);
+   }
+   for(std::size_t i = 0; i < residuals.size(); ++i) {
+      if(i == 0)
+         put(_data, zigzag(static_cast<long>(residuals[i]) - v));
+      else
+         put(_data, residuals[i] - residuals[i - 1] - 1);
+   }
+}
+
+/**
+   Decode the list of v, its reference list first
+
+   @param  v       node id
+   @param  out     sorted neighbours of v
+   @param  scratch buffers, four per reference depth up to _maxChain
+   @param  depth   references followed to get here
+   @return void
+*/
+void CompressedGraph::_decode(unsigned v, std::vector<unsigned>& out,
+                              std::vector<std::vector<unsigned> >& scratch,
+                              unsigned depth) const {
+   out.clear();
+   const unsigned char* p = &_data[0] + _offset[v];
+   unsigned long degree = get(p);
+   if(degree == 0)
+      return;
+   std::vector<unsigned>& reference = scratch[4 * depth];
+   std::vector<unsigned>& copied = scratch[4 * depth + 1];
+   std::vector<unsigned>& intervals = scratch[4 * depth + 2];
+   std::vector<unsigned>& residuals = scratch[4 * depth + 3];
+   copied.clear();
+   intervals.clear();
+   residuals.clear();
+
+   unsigned long distance = get(p);
+   if(distance > 0) {
+      _decode(v - distance, reference, scratch, depth + 1);
+      unsigned long blocks = get(p), position = 0;
+      for(unsigned long b = 0; b < blocks; ++b) {
+         unsigned long length = b == 0 ? get(p) : get(p) + 1;
+         if(b % 2 == 0)
+            copied.insert(copied.end(), reference.begin() + position,
+                          reference.begin() + position + length);
+         position += length;
+      }
+   }
+
+   unsigned long count = get(p), end = 0;
+   for(unsigned long i = 0; i < count; ++i) {
+      unsigned long left = i == 0 ? v + unzigzag(get(p)) : end + get(p) + 1;
+      unsigned long length = get(p) + minInterval;
+      for(unsigned long x = left; x < left + length; ++x)
+         intervals.push_back(x);
+      end = left + length;
+   }
+   unsigned long remaining = degree - copied.size() - intervals.size();
+   for(unsigned long i = 0; i < remaining; ++i) {
+      if(i == 0)
+         residuals.push_back(v + unzigzag(get(p)));
+      else
+         residuals.push_back(residuals.back() + get(p) + 1);
+   }
+
+   /** three sorted runs, merged */
+   out.reserve(degree);
+   std::size_t a = 0, b = 0, c = 0;
+   while(out.size() < degree) {
+      unsigned x = a < copied.size() ? copied[a] : ~0u;
+      unsigned y = b < intervals.size() ? intervals[b] : ~0u;
+      unsigned z = c < residuals.size() ? residuals[c] : ~0u;
+      if(x <= y && x <= z && a < copied.size())
+         out.push_back(copied[a++]);
+      else if(y <= z && b < intervals.size())
+         out.push_back(intervals[b++]);
+      else
+         out.push_back(residuals[c++]);
+   }
+}
+
+/**
+   @param  v node id
+   @return number of out-neighbours of v
+*/
+unsigned CompressedGraph::degree(unsigned v) const {
+   if(v >= _nodes)
+      return 0;
+   const unsigned char* p = &_data[0] + _offset[v];
+   return get(p);
+}
+
+/**
+   @param  v   node id
+   @param  out out-neighbours of v in increasing order
+   @return void
+*/
+void CompressedGraph::neighbours(unsigned v, std::vector<unsigned>& out) const {
+   static thread_local std::vector<std::vector<unsigned> > scratch;
+   out.clear();
+   /** sized before decoding: the recursion holds references into it */
+   if(scratch.size() < 4 * (_maxChain + 1))
+      scratch.resize(4 * (_maxChain + 1));
+   if(v < _nodes)
+      _decode(v, out, scratch, 0);
+}
+
+/**
+   @return bits of the encoded lists per edge
+*/
+double CompressedGraph::bitsPerEdge() const {
+   return _edges > 0 ? 8.0 * _data.size() / _edges : 0;
+}
+
+/**
+   @return heap bytes of the lists, their offsets and the weights
+*/
+unsigned long CompressedGraph::memoryUsage() const {
+   return _data.capacity() + (_offset.capacity() + _first.capacity()) * sizeof(unsigned long)
+        + _weight.capacity() * sizeof(float);
+}
+
+/**
+   Breadth first search decoding every list once
+
+   @param  source node id to start from
+   @return hop distance of every node from source
+*/
+std::vector<unsigned> CompressedGraph::BFS(unsigned source) const {
+   GRAPH_STAT_TIMER("compressedBFS");
+   std::vector<unsigned> level(_nodes, CompactGraph::unreachable);
+   if(source >= _nodes)
+      return level;
+   std::vector<unsigned> queue(1, source), list;
+   level[source] = 0;
+   for(std::size_t i = 0; i < queue.size(); ++i) {
+      unsigned v = queue[i];
+      neighbours(v, list);
+      for(auto w = list.begin(); w != list.end(); ++w) {
+         if(level[*w] == CompactGraph::unreachable) {
+            level[*w] = level[v] + 1;
+            queue.push_back(*w);
+         }
+      }
+   }
+   return level;
+}
+
+/**
+   PageRank, same definition as CompactGraph::pageRank, pushing the rank
+   of every node along its decoded list
+
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @return rank of every node, indexed by id
+*/
+std::vector<double> CompressedGraph::pageRank(double damping, double tolerance,
+                                              unsigned maxIterations) const {
+   GRAPH_STAT_TIMER("compressedPageRank");
+   const unsigned n = _nodes;
+   std::vector<double> rank(n, n > 0 ? 1.0 / n : 0);
+   if(n == 0)
+      return rank;
+
+   std::vector<double> outWeight(n, 0);
+   for(unsigned v = 0; v < n; ++v) {
+      if(_weight.empty())
+         outWeight[v] = degree(v);
+      else {
+         for(unsigned long e = _first[v]; e < _first[v + 1]; ++e)
+            outWeight[v] += std::max<double>(_weight[e], 0);
+      }
+   }
+
+   std::vector<double> next(n);
+   std::vector<unsigned> list;
+   for(unsigned iteration = 0; iteration < maxIterations && !parallel::stopping(); ++iteration) {
+      double dangling = 0;
+      std::fill(next.begin(), next.end(), 0);
+      for(unsigned v = 0; v < n; ++v) {
+         if(outWeight[v] <= 0) {
+            dangling += rank[v];
+            continue;
+         }
+         neighbours(v, list);
+         for(std::size_t i = 0; i < list.size(); ++i) {
+            double weight = _weight.empty() ? 1 : _weight[_first[v] + i];
+            if(weight > 0)
+               next[list[i]] += rank[v] * weight / outWeight[v];
+         }
+      }
+      double change = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         next[v] = (1 - damping) / n + damping * (next[v] + dangling / n);
+         change += std::fabs(next[v] - rank[v]);
+      }
+      rank.swap(next);
+      if(change < tolerance)
+         break;
+   }
+   return rank;
+}
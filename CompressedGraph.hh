@@ -0,0 +1,74 @@
+/*
+   @file    CompressedGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef COMPRESSED_GRAPH_HH
+#define COMPRESSED_GRAPH_HH 1
+
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Read-only adjacency compressed like WebGraph: the sorted neighbour
+    list of a node may copy blocks of the list of one of the previous
+    window nodes (reference chains at most maxChain long), runs of
+    consecutive ids are stored as intervals and the rest as gaps, every
+    number as a byte aligned varint. Graphs whose ids have locality (web
+    crawl order, or after CompactGraph::reorder) need a few bits per edge.
+    Parallel edges are merged; weights are kept only if some is not 1
+*/
+class CompressedGraph {
+
+public:
+   explicit CompressedGraph(const CompactGraph& C, unsigned window = 7, unsigned maxChain = 3);
+
+   inline unsigned      nodes() const;
+   inline unsigned long edges() const;
+   inline bool          isOriented() const;
+   inline bool          isWeighted() const;
+
+   unsigned degree(unsigned v) const;
+   /** out-neighbours of v in increasing order */
+   void neighbours(unsigned v, std::vector<unsigned>& out) const;
+   /** fn(w, weight) for every out-edge v -> w, in increasing w */
+   template<typename F> void forEachNeighbour(unsigned v, F fn) const;
+
+   /** size of the encoded lists only, and of everything */
+   double        bitsPerEdge() const;
+   unsigned long memoryUsage() const;
+
+   /** hop distance of every node, CompactGraph::unreachable if not reached */
+   std::vector<unsigned> BFS(unsigned source) const;
+   std::vector<double>   pageRank(double damping = 0.85, double tolerance = 1e-9,
+                                  unsigned maxIterations = 100) const;
+
+private:
+   bool          _directed;
+   unsigned      _nodes;
+   unsigned long _edges;
+   unsigned      _maxChain;
+
+   /** list of v: _data[_offset[v]] ... _data[_offset[v + 1] - 1] */
+   std::vector<unsigned long> _offset;
+   std::vector<unsigned char> _data;
+   /** only when weighted: weights of v from _first[v], in neighbour order */
+   std::vector<unsigned long> _first;
+   std::vector<float>         _weight;
+
+   void _encode(unsigned v, const std::vector<unsigned>& list,
+                const std::vector<unsigned>& reference, unsigned distance);
+   void _decode(unsigned v, std::vector<unsigned>& out,
+                std::vector<std::vector<unsigned> >& scratch, unsigned depth) const;
+
+/** class CompressedGraph */
+};
+
+/** include inline functions */
+#include "CompressedGraph_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //COMPRESSED_GRAPH_HH
@@ -0,0 +1,54 @@
+/*
+   @file    CompressedGraph_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef COMPRESSED_GRAPH_INLINES_HH
+#define COMPRESSED_GRAPH_INLINES_HH 1
+
+/**
+   @return number of nodes
+*/
+inline unsigned
+CompressedGraph::nodes() const {
+   return _nodes;
+}
+
+/**
+   @return number of edges, parallel edges counted once
+*/
+inline unsigned long
+CompressedGraph::edges() const {
+   return _edges;
+}
+
+/**
+   @return is the graph directed?
+*/
+inline bool
+CompressedGraph::isOriented() const {
+   return _directed;
+}
+
+/**
+   @return are weights stored (some weight is not 1)?
+*/
+inline bool
+CompressedGraph::isWeighted() const {
+   return !_weight.empty();
+}
+
+/**
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double)
+   @return void
+*/
+template<typename F>
+void CompressedGraph::forEachNeighbour(unsigned v, F fn) const {
+   std::vector<unsigned> list;
+   neighbours(v, list);
+   for(std::size_t i = 0; i < list.size(); ++i)
+      fn(list[i], _weight.empty() ? 1.0 : _weight[_first[v] + i]);
+}
+
+#endif
@@ -0,0 +1,490 @@
+/*
+   @file    DeltaGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include "DeltaGraph.hh"
+#include "Parallel.hh"
+
+using namespace GraphLib;
+
+namespace {
+   /** frozen layers that trigger a compaction, whatever their size */
+   const std::size_t maxLayers = 16;
+}
+
+/**
+   Constructor, the base is G with its out-lists sorted
+
+   @param  G         initial graph
+   @param  threshold pending changes that trigger a background compaction
+*/
+DeltaGraph::DeltaGraph(const Graph& G, unsigned long threshold)
+   : _directed(G.isOriented()), _threshold(std::max(threshold, 1ul)),
+     _active(std::make_shared<Layer>()), _compacting(false) {
+   CompactGraph C(G);
+   _name = C._name;
+   _id = C._id;
+   _base = _merge(C, std::vector<std::shared_ptr<const Layer> >(), _name);
+   _edges = _base->edges();
+}
+
+/**
+   Destructor, the background compaction refers to this
+*/
+DeltaGraph::~DeltaGraph() {
+   waitCompaction();
+}
+
+/**
+   @param  node name of the node
+   @return its id, the next one if the node is new
+*/
+unsigned DeltaGraph::addNode(const std::string& node) {
+   std::lock_guard<std::mutex> lock(_mutex);
+   return _add(node);
+}
+
+/**
+   Insert or update fromNode -> toNode (both ways when undirected),
+   adding the missing nodes
+
+   @param  fromNode source node
+   @param  toNode   target node
+   @param  cost     weight of the edge
+   @return void
+*/
+void DeltaGraph::addEdge(const std::string& fromNode, const std::string& toNode, double cost) {
+   GRAPH_STAT_TIMER("deltaAddEdge");
+   std::lock_guard<std::mutex> lock(_mutex);
+   unsigned u = _add(fromNode), v = _add(toNode);
+   if(!_exists(u, v, 0))
+      ++_edges;
+   _set(u, v, cost, false);
+   if(!_directed && u != v) {
+      if(!_exists(v, u, 0))
+         ++_edges;
+      _set(v, u, cost, false);
+   }
+   _scheduleCompaction();
+}
+
+/**
+   Tombstone for fromNode -> toNode, ignored if there is no such edge
+
+   @param  fromNode source node
+   @param  toNode   target node
+   @return void
+*/
+void DeltaGraph::removeEdge(const std::string& fromNode, const std::string& toNode) {
+   GRAPH_STAT_TIMER("deltaRemoveEdge");
+   std::lock_guard<std::mutex> lock(_mutex);
+   auto from = _id.find(fromNode), to = _id.find(toNode);
+   if(from == _id.end() || to == _id.end())
+      return;
+   unsigned u = from->second, v = to->second;
+   if(!_exists(u, v, 0))
+      return;
+   --_edges;
+   _set(u, v, 0, true);
+   if(!_directed && u != v) {
+      --_edges;
+      _set(v, u, 0, true);
+   }
+   _scheduleCompaction();
+}
+
+/**
+   @return number of nodes
+*/
+unsigned DeltaGraph::nodes() const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   return _name.size();
+}
+
+/**
+   @return number of edges, counted like CompactGraph::edges()
+*/
+unsigned long DeltaGraph::edges() const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   return _edges;
+}
+
+/**
+   @param  node name of the node
+   @return its id, nodes() if the node is unknown
+*/
+unsigned DeltaGraph::id(const std::string& node) const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   auto found = _id.find(node);
+   return found != _id.end() ? found->second : _name.size();
+}
+
+/**
+   @param  v node id
+   @return its name, empty for an unknown id
+*/
+std::string DeltaGraph::name(unsigned v) const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   return v < _name.size() ? _name[v] : std::string();
+}
+
+/**
+   @param  fromNode source node
+   @param  toNode   target node
+   @return is there an edge fromNode -> toNode?
+*/
+bool DeltaGraph::hasEdge(const std::string& fromNode, const std::string& toNode) const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   auto from = _id.find(fromNode), to = _id.find(toNode);
+   return from != _id.end() && to != _id.end() && _exists(from->second, to->second, 0);
+}
+
+/**
+   @param  fromNode source node
+   @param  toNode   target node
+   @return weight of the edge, 0 if there is no such edge
+*/
+double DeltaGraph::weight(const std::string& fromNode, const std::string& toNode) const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   auto from = _id.find(fromNode), to = _id.find(toNode);
+   double weight = 0;
+   if(from != _id.end() && to != _id.end() && _exists(from->second, to->second, &weight))
+      return weight;
+   return 0;
+}
+
+/**
+   Freeze the layer taking the writes and share the layers with the
+   caller: O(layers), no edge is copied
+
+   @return the graph as of now
+*/
+DeltaGraph::Snapshot DeltaGraph::snapshot() const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   _freeze();
+   Snapshot snapshot;
+   snapshot._base = _base;
+   snapshot._layers = _frozen;
+   snapshot._nodes = _name.size();
+   snapshot._edges = _edges;
+   return snapshot;
+}
+
+/**
+   @return number of changes in the layers
+*/
+unsigned long DeltaGraph::pending() const {
+   std::lock_guard<std::mutex> lock(_mutex);
+   unsigned long size = _active->size;
+   for(auto l = _frozen.begin(); l != _frozen.end(); ++l)
+      size += (*l)->size;
+   return size;
+}
+
+/**
+   @return void
+*/
+void DeltaGraph::compact() {
+   _compact();
+}
+
+/**
+   @return void
+*/
+void DeltaGraph::waitCompaction() {
+   std::shared_future<void> background;
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      background = _background;
+   }
+   if(background.valid())
+      background.wait();
+}
+
+/**
+   Caller holds _mutex
+
+   @param  node name of the node
+   @return its id
+*/
+unsigned DeltaGraph::_add(const std::string& node) {
+   auto inserted = _id.insert(std::make_pair(node, _name.size()));
+   if(inserted.second)
+      _name.push_back(node);
+   return inserted.first->second;
+}
+
+/**
+   Record the change of u -> v in the layer taking the writes, caller
+   holds _mutex
+
+   @return void
+*/
+void DeltaGraph::_set(unsigned u, unsigned v, double weight, bool removed) {
+   std::map<unsigned, Change>& out = _active->out[u];
+   auto inserted = out.insert(std::make_pair(v, Change()));
+   if(inserted.second)
+      ++_active->size;
+   inserted.first->second.weight = weight;
+   inserted.first->second.removed = removed;
+}
+
+/**
+   @return newest change of u -> v in the layers, null if none, caller
+           holds _mutex
+*/
+const DeltaGraph::Change* DeltaGraph::_find(unsigned u, unsigned v) const {
+   auto list = _active->out.find(u);
+   if(list != _active->out.end()) {
+      auto change = list->second.find(v);
+      if(change != list->second.end())
+         return &change->second;
+   }
+   return _newest(_frozen, u, v, 0);
+}
+
+/**
+   @param  weight set to the weight of the edge if not null
+   @return is there an edge u -> v? Caller holds _mutex
+*/
+bool DeltaGraph::_exists(unsigned u, unsigned v, double* weight) const {
+   const Change* change = _find(u, v);
+   if(change) {
+      if(weight && !change->removed)
+         *weight = change->weight;
+      return !change->removed;
+   }
+   return u < _base->nodes() && _inBase(*_base, u, v, weight);
+}
+
+/**
+   Caller holds _mutex
+
+   @return void
+*/
+void DeltaGraph::_freeze() const {
+   if(_active->size == 0)
+      return;
+   _frozen.push_back(_active);
+   _active = std::make_shared<Layer>();
+}
+
+/**
+   Start a compaction on the shared pool if there are enough changes and
+   none runs already, caller holds _mutex
+
+   @return void
+*/
+void DeltaGraph::_scheduleCompaction() {
+   if(_compacting)
+      return;
+   unsigned long size = _active->size;
+   for(auto l = _frozen.begin(); l != _frozen.end(); ++l)
+      size += (*l)->size;
+   if(size < _threshold && _frozen.size() < maxLayers)
+      return;
+   _compacting = true;
+   _background = parallel::async([this]() {
+      _compact();
+      std::lock_guard<std::mutex> lock(_mutex);
+      _compacting = false;
+   }).share();
+}
+
+/**
+   Freeze the writes, merge the frozen layers into a new base without
+   holding _mutex, then swap the base in and drop the merged layers;
+   layers frozen meanwhile stay on top of the new base
+
+   @return void
+*/
+void DeltaGraph::_compact() {
+   std::lock_guard<std::mutex> serial(_compactor);
+   std::shared_ptr<const CompactGraph> base;
+   std::vector<std::shared_ptr<const Layer> > layers;
+   std::vector<std::string> names;
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _freeze();
+      if(_frozen.empty() && _name.size() == _base->nodes())
+         return;
+      base = _base;
+      layers = _frozen;
+      names = _name;
+   }
+   std::shared_ptr<const CompactGraph> merged = _merge(*base, layers, names);
+   std::lock_guard<std::mutex> lock(_mutex);
+   _base = merged;
+   _frozen.erase(_frozen.begin(), _frozen.begin() + layers.size());
+}
+
+/**
+   Binary search in the sorted out-list of u
+
+   @param  weight set to the weight of the edge if not null
+   @return is there an edge u -> v in C?
+*/
+bool DeltaGraph::_inBase(const CompactGraph& C, unsigned u, unsigned v, double* weight) {
+   unsigned long low = C.begin(u), high = C.end(u);
+   while(low < high) {
+      unsigned long middle = low + (high - low) / 2;
+      if(C.target(middle) < v)
+         low = middle + 1;
+      else
+         high = middle;
+   }
+   if(low == C.end(u) || C.target(low) != v)
+      return false;
+   if(weight)
+      *weight = C.weight(low);
+   return true;
+}
+
+/**
+   New base: the newest change of every edge merged with the sorted
+   out-lists of the old base, O(nodes + edges + changes)
+
+   @param  base   old base
+   @param  layers changes, oldest first
+   @param  names  every node, by id
+   @return base with the changes applied
+*/
+std::shared_ptr<const CompactGraph>
+DeltaGraph::_merge(const CompactGraph& base, const std::vector<std::shared_ptr<const Layer> >& layers,
+                   const std::vector<std::string>& names) {
+   GRAPH_STAT_TIMER("deltaCompaction");
+   std::unordered_map<unsigned, std::map<unsigned, Change> > changes;
+   for(auto l = layers.begin(); l != layers.end(); ++l) {
+      for(auto list = (*l)->out.begin(); list != (*l)->out.end(); ++list) {
+         std::map<unsigned, Change>& out = changes[list->first];
+         for(auto c = list->second.begin(); c != list->second.end(); ++c)
+            out[c->first] = c->second;
+      }
+   }
+
+   const unsigned n = names.size();
+   std::shared_ptr<CompactGraph> C(new CompactGraph(base.isOriented()));
+   C->_name = names;
+   for(unsigned v = 0; v < n; ++v)
+      C->_id.insert(std::make_pair(names[v], v));
+   C->_offset.assign(n + 1, 0);
+   C->_target.reserve(base.edges());
+   C->_weight.reserve(base.edges());
+
+   std::vector<std::pair<unsigned, double> > list;
+   for(unsigned v = 0; v < n; ++v) {
+      list.clear();
+      if(v < base.nodes()) {
+         for(unsigned long e = base.begin(v); e < base.end(v); ++e)
+            list.push_back(std::make_pair(base.target(e), base.weight(e)));
+      }
+      /** only the first base, built from a Graph, isn't sorted yet and
+          holds the undirected self-loops twice */
+      std::stable_sort(list.begin(), list.end(),
+                       [](const std::pair<unsigned, double>& a,
+                          const std::pair<unsigned, double>& b) { return a.first < b.first; });
+      list.erase(std::unique(list.begin(), list.end(),
+                             [](const std::pair<unsigned, double>& a,
+                                const std::pair<unsigned, double>& b) { return a.first == b.first; }),
+                 list.end());
+
+      auto found = changes.find(v);
+      auto e = list.begin();
+      if(found != changes.end()) {
+         for(auto c = found->second.begin(); c != found->second.end(); ++c) {
+            for(; e != list.end() && e->first < c->first; ++e) {
+               C->_target.push_back(e->first);
+               C->_weight.push_back(e->second);
+            }
+            if(e != list.end() && e->first == c->first)
+               ++e;
+            if(!c->second.removed) {
+               C->_target.push_back(c->first);
+               C->_weight.push_back(c->second.weight);
+            }
+         }
+      }
+      for(; e != list.end(); ++e) {
+         C->_target.push_back(e->first);
+         C->_weight.push_back(e->second);
+      }
+      C->_offset[v + 1] = C->_target.size();
+   }
+   C->_buildInEdges();
+   return C;
+}
+
+/**
+   @param  u source node id
+   @param  v target node id
+   @return is there an edge u -> v?
+*/
+bool DeltaGraph::Snapshot::hasEdge(unsigned u, unsigned v) const {
+   if(u >= _nodes || v >= _nodes)
+      return false;
+   const Change* change = _newest(_layers, u, v, 0);
+   if(change)
+      return !change->removed;
+   return u < _base->nodes() && _inBase(*_base, u, v, 0);
+}
+
+/**
+   @param  u source node id
+   @param  v target node id
+   @return weight of u -> v, 0 if there is no such edge
+*/
+double DeltaGraph::Snapshot::weight(unsigned u, unsigned v) const {
+   if(u >= _nodes || v >= _nodes)
+      return 0;
+   const Change* change = _newest(_layers, u, v, 0);
+   if(change)
+      return change->removed ? 0 : change->weight;
+   double weight = 0;
+   if(u < _base->nodes())
+      _inBase(*_base, u, v, &weight);
+   return weight;
+}
+
+/**
+   @param  source node id to start from
+   @return hop distance of every node from source
+*/
+std::vector<unsigned> DeltaGraph::Snapshot::BFS(unsigned source) const {
+   GRAPH_STAT_TIMER("deltaBFS");
+   std::vector<unsigned> level(_nodes, CompactGraph::unreachable);
+   if(source >= _nodes)
+      return level;
+   std::vector<unsigned> queue(1, source);
+   level[source] = 0;
+   for(std::size_t i = 0; i < queue.size(); ++i) {
+      unsigned v = queue[i];
+      forEachOut(v, [&](unsigned w, double) {
+         if(level[w] == CompactGraph::unreachable) {
+            level[w] = level[v] + 1;
+            queue.push_back(w);
+         }
+      });
+   }
+   return level;
+}
+
+/**
+   @param  layers changes, oldest first
+   @param  oldest first layer to look at
+   @return newest change of u -> v in the layers from oldest on, null if none
+*/
+const DeltaGraph::Change*
+DeltaGraph::_newest(const std::vector<std::shared_ptr<const Layer> >& layers, unsigned u,
+                    unsigned v, std::size_t oldest) {
+   for(std::size_t i = layers.size(); i-- > oldest; ) {
+      auto list = layers[i]->out.find(u);
+      if(list == layers[i]->out.end())
+         continue;
+      auto change = list->second.find(v);
+      if(change != list->second.end())
+         return &change->second;
+   }
+   return 0;
+}
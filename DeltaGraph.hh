@@ -0,0 +1,144 @@
+/*
+   @file    DeltaGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef DELTA_GRAPH_HH
+#define DELTA_GRAPH_HH 1
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Write-optimized graph in the style of a log-structured merge tree:
+    an immutable CompactGraph base (out-lists sorted by target) under
+    layers of changes, where an added edge is an insert and a removed edge
+    a tombstone. Writes only touch the newest layer. Reads merge the base
+    with the layers, newest change first. Once pending() changes reach the
+    threshold, a compaction on the shared pool folds the frozen layers into
+    a new base while writes and reads go on. Node ids never change, and
+    new nodes get the next id
+*/
+class DeltaGraph {
+
+   /** change of the edge u -> v since the base */
+   struct Change {
+      double weight;
+      bool   removed;
+   };
+   /** changes by source, then target */
+   struct Layer {
+      std::unordered_map<unsigned, std::map<unsigned, Change> > out;
+      unsigned long size;
+   };
+
+public:
+   /** consistent state for lock free reads, later writes are not seen */
+   class Snapshot {
+   public:
+      inline unsigned      nodes() const;
+      inline unsigned long edges() const;
+      inline bool          isOriented() const;
+      /** base the layers apply to, complete when layers() == 0 */
+      inline const CompactGraph& base() const;
+      inline unsigned            layers() const;
+
+      bool   hasEdge(unsigned u, unsigned v) const;
+      /** weight of u -> v, 0 if there is no such edge */
+      double weight(unsigned u, unsigned v) const;
+      /** fn(w, weight) for every out-edge v -> w */
+      template<typename F> void forEachOut(unsigned v, F fn) const;
+
+      std::vector<unsigned> BFS(unsigned source) const;
+
+   private:
+      friend class DeltaGraph;
+      std::shared_ptr<const CompactGraph>       _base;
+      /** oldest first */
+      std::vector<std::shared_ptr<const Layer> > _layers;
+      unsigned      _nodes;
+      unsigned long _edges;
+   };
+
+   explicit DeltaGraph(const Graph& G, unsigned long threshold = 1ul << 16);
+   /** waits for the running compaction */
+   ~DeltaGraph();
+
+   /** a DeltaGraph owns its layers, it can't be copied */
+   DeltaGraph(const DeltaGraph&) = delete;
+   DeltaGraph& operator=(const DeltaGraph&) = delete;
+
+   unsigned addNode(const std::string& node);
+   void     addEdge(const std::string& fromNode, const std::string& toNode, double cost = 1);
+   void     removeEdge(const std::string& fromNode, const std::string& toNode);
+
+   unsigned      nodes() const;
+   unsigned long edges() const;
+   inline bool   isOriented() const;
+   /** nodes() if the node is unknown */
+   unsigned      id(const std::string& node) const;
+   std::string   name(unsigned v) const;
+   bool          hasEdge(const std::string& fromNode, const std::string& toNode) const;
+   double        weight(const std::string& fromNode, const std::string& toNode) const;
+
+   Snapshot snapshot() const;
+
+   /** changes not folded into the base yet */
+   unsigned long pending() const;
+   /** fold every change made so far into the base, now */
+   void compact();
+   /** wait for the background compaction, if any */
+   void waitCompaction();
+
+private:
+   bool          _directed;
+   unsigned long _threshold;
+
+   /** guards everything below */
+   mutable std::mutex _mutex;
+   std::vector<std::string>        _name;
+   std::map<std::string, unsigned> _id;
+   unsigned long                   _edges;
+   std::shared_ptr<const CompactGraph>                _base;
+   /** layer taking the writes, frozen (oldest first) by snapshot() */
+   mutable std::shared_ptr<Layer>                     _active;
+   mutable std::vector<std::shared_ptr<const Layer> > _frozen;
+   /** background compaction, valid while one runs or wasn't waited for */
+   std::shared_future<void> _background;
+   bool                     _compacting;
+
+   /** one compaction at a time */
+   std::mutex _compactor;
+
+   unsigned _add(const std::string& node);
+   void _set(unsigned u, unsigned v, double weight, bool removed);
+   const Change* _find(unsigned u, unsigned v) const;
+   bool _exists(unsigned u, unsigned v, double* weight) const;
+   void _freeze() const;
+   void _compact();
+   void _scheduleCompaction();
+
+   static const Change* _newest(const std::vector<std::shared_ptr<const Layer> >& layers,
+                                unsigned u, unsigned v, std::size_t oldest);
+   static bool _inBase(const CompactGraph& C, unsigned u, unsigned v, double* weight);
+   static std::shared_ptr<const CompactGraph>
+   _merge(const CompactGraph& base, const std::vector<std::shared_ptr<const Layer> >& layers,
+          const std::vector<std::string>& names);
+
+/** class DeltaGraph */
+};
+
+/** include inline functions */
+#include "DeltaGraph_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //DELTA_GRAPH_HH
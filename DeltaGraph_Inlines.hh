@@ -0,0 +1,92 @@
+/*
+   @file    DeltaGraph_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef DELTA_GRAPH_INLINES_HH
+#define DELTA_GRAPH_INLINES_HH 1
+
+/**
+   @return graph oriented or not?
+*/
+inline bool
+DeltaGraph::isOriented() const {
+   return _directed;
+}
+
+/**
+   @return number of nodes when the snapshot was taken
+*/
+inline unsigned
+DeltaGraph::Snapshot::nodes() const {
+   return _nodes;
+}
+
+/**
+   @return number of edges, counted like CompactGraph::edges()
+*/
+inline unsigned long
+DeltaGraph::Snapshot::edges() const {
+   return _edges;
+}
+
+/**
+   @return graph oriented or not?
+*/
+inline bool
+DeltaGraph::Snapshot::isOriented() const {
+   return _base->isOriented();
+}
+
+/**
+   @return base the layers apply to
+*/
+inline const CompactGraph&
+DeltaGraph::Snapshot::base() const {
+   return *_base;
+}
+
+/**
+   @return number of layers over the base
+*/
+inline unsigned
+DeltaGraph::Snapshot::layers() const {
+   return _layers.size();
+}
+
+/**
+   The edges of the base that no layer changed, then the newest change
+   of every changed edge that is not a tombstone
+
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double)
+   @return void
+*/
+template<typename F>
+void DeltaGraph::Snapshot::forEachOut(unsigned v, F fn) const {
+   if(v >= _nodes)
+      return;
+   bool changed = false;
+   for(auto l = _layers.begin(); l != _layers.end() && !changed; ++l)
+      changed = (*l)->out.count(v) > 0;
+
+   if(v < _base->nodes()) {
+      for(unsigned long e = _base->begin(v); e < _base->end(v); ++e) {
+         if(!changed || !_newest(_layers, v, _base->target(e), 0))
+            fn(_base->target(e), _base->weight(e));
+      }
+   }
+   if(!changed)
+      return;
+   for(std::size_t i = _layers.size(); i-- > 0; ) {
+      auto list = _layers[i]->out.find(v);
+      if(list == _layers[i]->out.end())
+         continue;
+      for(auto c = list->second.begin(); c != list->second.end(); ++c) {
+         if(!c->second.removed && !_newest(_layers, v, c->first, i + 1))
+            fn(c->first, c->second.weight);
+      }
+   }
+}
+
+#endif
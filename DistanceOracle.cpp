@@ -0,0 +1,362 @@
+/*
+   @file    DistanceOracle.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include "DistanceOracle.hh"
+
+using namespace GraphLib;
+
+namespace {
+   const double infinity = std::numeric_limits<double>::infinity();
+
+   /** Dijkstra from source over the out-edges (in-edges if reverse) */
+   void shortestPaths(const CompactGraph& C, unsigned source, bool reverse,
+                      std::vector<double>& dist) {
+      typedef std::pair<double, unsigned> entry;
+      std::priority_queue<entry, std::vector<entry>, std::greater<entry> > heap;
+      dist.assign(C.nodes(), infinity);
+      dist[source] = 0;
+      heap.push(entry(0, source));
+      while(!heap.empty()) {
+         double d = heap.top().first;
+         unsigned v = heap.top().second;
+         heap.pop();
+         if(d > dist[v])
+            continue;
+         unsigned long first = reverse ? C.inBegin(v) : C.begin(v);
+         unsigned long last = reverse ? C.inEnd(v) : C.end(v);
+         for(unsigned long e = first; e < last; ++e) {
+            unsigned w = reverse ? C.source(e) : C.target(e);
+            double length = C.weight(reverse ? C.inEdge(e) : e);
+            if(d + length < dist[w]) {
+               dist[w] = d + length;
+               heap.push(entry(dist[w], w));
+            }
+         }
+      }
+   }
+
+   /** search state of a node on one side of the bidirectional A* */
+   struct Label {
+      double   dist;
+      double   key;
+      /** previous node towards the side's origin */
+      unsigned parent;
+      /** potential of the node on this side */
+      double   potential;
+   };
+}
+
+/**
+   Constructor
+
+   @param  G          graph to answer about, copied in compact form
+   @param  landmarks  number of landmarks (distance tables kept)
+   @param  cacheSize  answers kept in the LRU cache, 0 = no cache
+*/
+DistanceOracle::DistanceOracle(const Graph& G, unsigned landmarks, unsigned cacheSize)
+   : _graph(G), _cacheSize(cacheSize), _settled(0) {
+   _selectLandmarks(landmarks);
+}
+
+/**
+   Constructor
+
+   @param  C          graph to answer about, copied
+   @param  landmarks  number of landmarks (distance tables kept)
+   @param  cacheSize  answers kept in the LRU cache, 0 = no cache
+*/
+DistanceOracle::DistanceOracle(const CompactGraph& C, unsigned landmarks, unsigned cacheSize)
+   : _graph(C), _cacheSize(cacheSize), _settled(0) {
+   _selectLandmarks(landmarks);
+}
+
+/**
+   Farthest landmark selection: each new landmark is the node farthest
+   from the ones already chosen (in either direction), nodes they can't
+   reach at all first, so every component gets one
+
+   @param  count number of landmarks wanted
+   @return void
+*/
+void DistanceOracle::_selectLandmarks(unsigned count) {
+   GRAPH_STAT_TIMER("selectLandmarks");
+   const unsigned n = _graph.nodes();
+   count = std::min(count, n);
+   if(count == 0)
+      return;
+   std::vector<double> from, to, nearest;
+
+   /** the first landmark is the node farthest from node 0 */
+   shortestPaths(_graph, 0, false, nearest);
+   unsigned next = 0;
+   for(unsigned v = 0; v < n; ++v) {
+      if(nearest[v] > nearest[next])
+         next = v;
+   }
+
+   std::fill(nearest.begin(), nearest.end(), infinity);
+   _from.reserve(static_cast<unsigned long>(count) * n);
+   if(_graph.isOriented())
+      _to.reserve(static_cast<unsigned long>(count) * n);
+   while(_landmark.size() < count) {
+      _landmark.push_back(next);
+      shortestPaths(_graph, next, false, from);
+      _from.insert(_from.end(), from.begin(), from.end());
+      if(_graph.isOriented()) {
+         shortestPaths(_graph, next, true, to);
+         _to.insert(_to.end(), to.begin(), to.end());
+      }
+      for(unsigned v = 0; v < n; ++v) {
+         double d = _graph.isOriented() ? std::min(from[v], to[v]) : from[v];
+         nearest[v] = std::min(nearest[v], d);
+      }
+      next = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         if(nearest[v] > nearest[next])
+            next = v;
+      }
+      if(nearest[next] == 0)
+         break;
+   }
+}
+
+/**
+   Lower bound on d(v, t) from the triangle inequality on every landmark
+   L: d(L, t) - d(L, v) and d(v, L) - d(t, L). The tables are floats, so
+   every bound is lowered by their rounding error to stay admissible.
+   When L reaches v but not t (or t reaches L but v doesn't), v can't
+   reach t at all
+
+   @param  v node id
+   @param  t node id
+   @return bound, infinity if v can't reach t
+*/
+double DistanceOracle::_lowerBound(unsigned v, unsigned t) const {
+   const unsigned long n = _graph.nodes();
+   const std::vector<float>& to = _graph.isOriented() ? _to : _from;
+   const double ulp = std::ldexp(1.0, -23);
+   double bound = 0;
+   for(unsigned l = 0; l < _landmark.size(); ++l) {
+      double a = _from[l * n + t], b = _from[l * n + v];
+      if(b != infinity) {
+         if(a == infinity)
+            return infinity;
+         bound = std::max(bound, a - b - ulp * (a + b));
+      }
+      double c = to[l * n + v], d = to[l * n + t];
+      if(d != infinity) {
+         if(c == infinity)
+            return infinity;
+         bound = std::max(bound, c - d - ulp * (c + d));
+      }
+   }
+   return bound;
+}
+
+/**
+   Bidirectional A* with the average potential p(v) = (pi_t(v) - pi_s(v)) / 2
+   forward and -p(v) backward (pi_t(v) lower bound of d(v, t), pi_s(v) of
+   d(s, v)): both searches then see the same non-negative reduced costs
+   and the search stops once the two smallest keys add up to the best
+   path found
+
+   @param  u    source node id
+   @param  v    target node id
+   @param  path nodes of the shortest path found
+   @return distance, infinity if v can't be reached
+*/
+double DistanceOracle::_search(unsigned u, unsigned v, std::vector<unsigned>& path) const {
+   GRAPH_STAT_TIMER("distanceQuery");
+   path.clear();
+   if(u == v) {
+      path.push_back(u);
+      return 0;
+   }
+   if(_lowerBound(u, v) == infinity)
+      return infinity;
+
+   const unsigned none = _graph.nodes();
+   typedef std::pair<double, unsigned> entry;
+   typedef std::priority_queue<entry, std::vector<entry>, std::greater<entry> > minHeap;
+   std::unordered_map<unsigned, Label> label[2];
+   minHeap heap[2];
+   unsigned origin[2] = { u, v };
+   unsigned long settled = 0;
+
+   /** side 0 searches forward from u, side 1 backward from v; the label
+       of w on a side, created with its potential, or null if w is pruned */
+   auto visit = [&](int side, unsigned w) -> Label* {
+      auto l = label[side].find(w);
+      if(l != label[side].end())
+         return &l->second;
+      double toTarget = _lowerBound(w, v), fromSource = _lowerBound(u, w);
+      if((side == 0 && toTarget == infinity) || (side == 1 && fromSource == infinity))
+         return 0;
+      double potential = (toTarget - fromSource) / 2;
+      Label fresh = { infinity, infinity, none, side == 0 ? potential : -potential };
+      return &(label[side][w] = fresh);
+   };
+
+   for(int side = 0; side < 2; ++side) {
+      Label* start = visit(side, origin[side]);
+      start->dist = 0;
+      start->key = start->potential;
+      heap[side].push(entry(start->key, origin[side]));
+   }
+
+   double best = infinity;
+   unsigned meet = none;
+   while(true) {
+      for(int side = 0; side < 2; ++side) {
+         while(!heap[side].empty() &&
+               heap[side].top().first != label[side][heap[side].top().second].key)
+            heap[side].pop();
+      }
+      if(heap[0].empty() || heap[1].empty())
+         break;
+      if(heap[0].top().first + heap[1].top().first >= best)
+         break;
+
+      int side = heap[0].top().first <= heap[1].top().first ? 0 : 1;
+      unsigned x = heap[side].top().second;
+      heap[side].pop();
+      ++settled;
+      double dist = label[side][x].dist;
+      /** the key becomes stale so x is settled only once per improvement */
+      label[side][x].key = -infinity;
+
+      unsigned long first = side == 0 ? _graph.begin(x) : _graph.inBegin(x);
+      unsigned long last = side == 0 ? _graph.end(x) : _graph.inEnd(x);
+      for(unsigned long e = first; e < last; ++e) {
+         unsigned w = side == 0 ? _graph.target(e) : _graph.source(e);
+         double length = _graph.weight(side == 0 ? e : _graph.inEdge(e));
+         Label* l = visit(side, w);
+         if(!l || dist + length >= l->dist)
+            continue;
+         l->dist = dist + length;
+         l->key = l->dist + l->potential;
+         l->parent = x;
+         heap[side].push(entry(l->key, w));
+
+         auto other = label[1 - side].find(w);
+         if(other != label[1 - side].end() && l->dist + other->second.dist < best) {
+            best = l->dist + other->second.dist;
+            meet = w;
+         }
+      }
+   }
+
+   if(meet != none) {
+      for(unsigned x = meet; x != none; x = label[0][x].parent)
+         path.push_back(x);
+      std::reverse(path.begin(), path.end());
+      for(unsigned x = label[1][meet].parent; x != none; x = label[1][x].parent)
+         path.push_back(x);
+   }
+   std::lock_guard<std::mutex> lock(_lock);
+   _settled = settled;
+   return best;
+}
+
+/**
+   @param  u source node id
+   @param  v target node id
+   @return shortest path distance, infinity if v can't be reached
+*/
+double DistanceOracle::distance(unsigned u, unsigned v) const {
+   if(u >= _graph.nodes() || v >= _graph.nodes())
+      return infinity;
+   if(_cacheSize > 0) {
+      std::lock_guard<std::mutex> lock(_lock);
+      auto c = _cached.find(std::make_pair(u, v));
+      if(c != _cached.end()) {
+         _cache.splice(_cache.begin(), _cache, c->second);
+         return c->second->second.first;
+      }
+   }
+   std::vector<unsigned> nodes;
+   double d = _search(u, v, nodes);
+   if(_cacheSize > 0) {
+      std::lock_guard<std::mutex> lock(_lock);
+      if(_cached.find(std::make_pair(u, v)) == _cached.end()) {
+         _cache.push_front(cacheEntry(std::make_pair(u, v), std::make_pair(d, nodes)));
+         _cached[std::make_pair(u, v)] = _cache.begin();
+         if(_cache.size() > _cacheSize) {
+            _cached.erase(_cache.back().first);
+            _cache.pop_back();
+         }
+      }
+   }
+   return d;
+}
+
+/**
+   @param  u source node id
+   @param  v target node id
+   @return nodes of a shortest path from u to v, empty if there is none
+*/
+std::vector<unsigned> DistanceOracle::path(unsigned u, unsigned v) const {
+   if(u >= _graph.nodes() || v >= _graph.nodes())
+      return std::vector<unsigned>();
+   if(_cacheSize > 0) {
+      distance(u, v);
+      std::lock_guard<std::mutex> lock(_lock);
+      auto c = _cached.find(std::make_pair(u, v));
+      if(c != _cached.end())
+         return c->second->second.second;
+   }
+   std::vector<unsigned> nodes;
+   _search(u, v, nodes);
+   return nodes;
+}
+
+/**
+   @param  u source node name
+   @param  v target node name
+   @return shortest path distance, infinity if v can't be reached
+*/
+double DistanceOracle::distance(const std::string& u, const std::string& v) const {
+   return distance(_graph.id(u), _graph.id(v));
+}
+
+/**
+   @param  u source node name
+   @param  v target node name
+   @return nodes of a shortest path from u to v, empty if there is none
+*/
+std::list<std::string> DistanceOracle::path(const std::string& u, const std::string& v) const {
+   std::vector<unsigned> nodes = path(_graph.id(u), _graph.id(v));
+   std::list<std::string> result;
+   for(auto x = nodes.begin(); x != nodes.end(); ++x)
+      result.push_back(_graph.name(*x));
+   return result;
+}
+
+/**
+   @return nodes settled by the last query that missed the cache
+*/
+unsigned long DistanceOracle::settled() const {
+   std::lock_guard<std::mutex> lock(_lock);
+   return _settled;
+}
+
+/**
+   @return heap bytes of the landmark tables and of the cache
+*/
+unsigned long DistanceOracle::memoryUsage() const {
+   std::lock_guard<std::mutex> lock(_lock);
+   unsigned long bytes = (_from.capacity() + _to.capacity()) * sizeof(float)
+                       + _landmark.capacity() * sizeof(unsigned);
+   for(auto c = _cache.begin(); c != _cache.end(); ++c)
+      bytes += sizeof(*c) + c->second.second.capacity() * sizeof(unsigned)
+             + sizeof(*_cached.begin()) + 5 * sizeof(void*);
+   return bytes;
+}
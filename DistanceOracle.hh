@@ -0,0 +1,77 @@
+/*
+   @file    DistanceOracle.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef DISTANCE_ORACLE_HH
+#define DISTANCE_ORACLE_HH 1
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Point-to-point shortest path distances (ALT): a few landmarks are
+    chosen far apart and the distances from and to each of them are kept
+    as floats; by the triangle inequality they give lower bounds on
+    d(v, t) that steer a bidirectional A* towards the target, so a query
+    settles a small part of the graph. Edge weights must be non-negative.
+    Recent answers can be kept in an LRU cache; queries are thread safe
+*/
+class DistanceOracle {
+
+public:
+   explicit DistanceOracle(const Graph& G, unsigned landmarks = 16, unsigned cacheSize = 0);
+   explicit DistanceOracle(const CompactGraph& C, unsigned landmarks = 16,
+                           unsigned cacheSize = 0);
+
+   /** infinity when v can't be reached from u */
+   double distance(unsigned u, unsigned v) const;
+   double distance(const std::string& u, const std::string& v) const;
+   /** nodes of a shortest path from u to v, empty if there is none */
+   std::vector<unsigned>  path(unsigned u, unsigned v) const;
+   std::list<std::string> path(const std::string& u, const std::string& v) const;
+
+   inline const CompactGraph& graph() const;
+   inline const std::vector<unsigned>& landmarks() const;
+   /** nodes settled by the last query, to see how well the bounds prune */
+   unsigned long settled() const;
+   unsigned long memoryUsage() const;
+
+private:
+   CompactGraph _graph;
+   std::vector<unsigned> _landmark;
+   /** d(landmark l, v) at l * nodes + v, and d(v, l) for directed graphs */
+   std::vector<float> _from;
+   std::vector<float> _to;
+
+   /** (u, v) -> (distance, path), most recent first */
+   typedef std::pair<std::pair<unsigned, unsigned>,
+                     std::pair<double, std::vector<unsigned> > > cacheEntry;
+   unsigned                      _cacheSize;
+   mutable std::list<cacheEntry> _cache;
+   mutable std::map<std::pair<unsigned, unsigned>,
+                    std::list<cacheEntry>::iterator> _cached;
+   mutable unsigned long         _settled;
+   /** guards the cache and _settled */
+   mutable std::mutex            _lock;
+
+   void   _selectLandmarks(unsigned count);
+   double _lowerBound(unsigned v, unsigned t) const;
+   double _search(unsigned u, unsigned v, std::vector<unsigned>& path) const;
+
+/** class DistanceOracle */
+};
+
+/** include inline functions */
+#include "DistanceOracle_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //DISTANCE_ORACLE_HH
@@ -0,0 +1,25 @@
+/*
+   @file    DistanceOracle_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef DISTANCE_ORACLE_INLINES_HH
+#define DISTANCE_ORACLE_INLINES_HH 1
+
+/**
+   @return graph the oracle answers about (node ids and names)
+*/
+inline const CompactGraph&
+DistanceOracle::graph() const {
+   return _graph;
+}
+
+/**
+   @return node ids of the landmarks
+*/
+inline const std::vector<unsigned>&
+DistanceOracle::landmarks() const {
+   return _landmark;
+}
+
+#endif
@@ -0,0 +1,332 @@
+/*
+   @file    ExternalGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cmath>
+#include "ExternalGraph.hh"
+#include "Parallel.hh"
+
+using namespace GraphLib;
+
+/**
+   Constructor, reads the header written by Writer::close()
+
+   @param  prefix      path of the graph files without their extension
+   @param  bufferEdges edges read at once from a partition file
+*/
+ExternalGraph::ExternalGraph(const std::string& prefix, unsigned long bufferEdges)
+   : _prefix(prefix), _good(false), _directed(true), _nodes(0), _edges(0),
+     _partitions(0), _span(1), _bufferEdges(std::max(bufferEdges, 1ul)) {
+   std::FILE* header = std::fopen((prefix + ".graph").c_str(), "r");
+   if(!header)
+      return;
+   int directed;
+   _good = std::fscanf(header, "GraphLib external %d %u %lu %u %u", &directed, &_nodes,
+                       &_edges, &_partitions, &_span) == 5 && _span > 0;
+   _directed = directed != 0;
+   std::fclose(header);
+}
+
+/**
+   @param  C          graph to write
+   @param  prefix     path of the graph files without their extension
+   @param  partitions number of partition files, 0 = about 16M edges each
+   @return true if every file was written
+*/
+bool ExternalGraph::write(const CompactGraph& C, const std::string& prefix,
+                          unsigned partitions) {
+   if(partitions == 0)
+      partitions = static_cast<unsigned>(C.edges() / (1ul << 24) + 1);
+   Writer writer(prefix, C.nodes(), partitions, C.isOriented());
+   for(unsigned v = 0; v < C.nodes(); ++v) {
+      for(unsigned long e = C.begin(v); e < C.end(v); ++e) {
+         /** the CSR of an undirected graph holds both directions already */
+         if(C.isOriented() || v <= C.target(e))
+            writer.addEdge(v, C.target(e), C.weight(e));
+      }
+   }
+   return writer.close();
+}
+
+/**
+   Breadth first search, one pass over the partitions of the frontier
+   per level: the edges leaving level k set level k + 1
+
+   @param  source node id to start from
+   @return hop distance of every node from source, empty if a partition
+           could not be read
+*/
+std::vector<unsigned> ExternalGraph::BFS(unsigned source) const {
+   GRAPH_STAT_TIMER("externalBFS");
+   std::vector<unsigned> level(_nodes, CompactGraph::unreachable);
+   if(source >= _nodes)
+      return level;
+   level[source] = 0;
+   std::vector<char> active(_partitions, 0), next(_partitions);
+   active[partition(source)] = 1;
+   for(unsigned k = 0; !parallel::stopping(); ++k) {
+      bool grown = false;
+      std::fill(next.begin(), next.end(), 0);
+      for(unsigned p = 0; p < _partitions; ++p) {
+         if(!active[p])
+            continue;
+         bool read = _scan(p, [&](const Edge& e) {
+            if(level[e.source] == k && level[e.target] == CompactGraph::unreachable) {
+               level[e.target] = k + 1;
+               next[partition(e.target)] = 1;
+               grown = true;
+            }
+         });
+         if(!read)
+            return std::vector<unsigned>();
+      }
+      if(!grown)
+         break;
+      active.swap(next);
+   }
+   return level;
+}
+
+/**
+   Union-find over the node ids, built in a single pass over the edges
+
+   @param  component component of every node, indexed by id
+   @return number of components, 0 if a partition could not be read
+*/
+unsigned ExternalGraph::components(std::vector<unsigned>& component) const {
+   GRAPH_STAT_TIMER("externalComponents");
+   std::vector<unsigned> parent(_nodes);
+   for(unsigned v = 0; v < _nodes; ++v)
+      parent[v] = v;
+   auto find = [&](unsigned v) {
+      while(parent[v] != v) {
+         parent[v] = parent[parent[v]];
+         v = parent[v];
+      }
+      return v;
+   };
+   unsigned long scanned = 0;
+   for(unsigned p = 0; p < _partitions; ++p) {
+      bool read = _scan(p, [&](const Edge& e) {
+         unsigned a = find(e.source), b = find(e.target);
+         /** the smaller id becomes the root: roots are the smallest nodes */
+         if(a < b)
+            parent[b] = a;
+         else if(b < a)
+            parent[a] = b;
+         ++scanned;
+      });
+      if(!read || !_complete(p, scanned)) {
+         component.clear();
+         return 0;
+      }
+   }
+
+   component.assign(_nodes, 0);
+   unsigned count = 0;
+   for(unsigned v = 0; v < _nodes; ++v) {
+      unsigned root = find(v);
+      component[v] = root == v ? count++ : component[root];
+   }
+   return count;
+}
+
+/**
+   PageRank, same definition as CompactGraph::pageRank (weights as
+   transition weights, dangling nodes restart uniformly): one pass for
+   the out-weights, then one pass per iteration scattering the ranks
+
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @return rank of every node, indexed by id, empty if a partition could
+           not be read
+*/
+std::vector<double> ExternalGraph::pageRank(double damping, double tolerance,
+                                            unsigned maxIterations) const {
+   GRAPH_STAT_TIMER("externalPageRank");
+   const unsigned n = _nodes;
+   std::vector<double> rank(n, n > 0 ? 1.0 / n : 0);
+   if(n == 0)
+      return rank;
+
+   std::vector<double> outWeight(n, 0);
+   unsigned long scanned = 0;
+   for(unsigned p = 0; p < _partitions; ++p) {
+      bool read = _scan(p, [&](const Edge& e) {
+         outWeight[e.source] += std::max<double>(e.weight, 0);
+         ++scanned;
+      });
+      if(!read || !_complete(p, scanned))
+         return std::vector<double>();
+   }
+
+   std::vector<double> next(n);
+   for(unsigned iteration = 0; iteration < maxIterations && !parallel::stopping(); ++iteration) {
+      double dangling = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         if(outWeight[v] <= 0)
+            dangling += rank[v];
+      }
+      std::fill(next.begin(), next.end(), 0);
+      for(unsigned p = 0; p < _partitions; ++p) {
+         bool read = _scan(p, [&](const Edge& e) {
+            if(e.weight > 0)
+               next[e.target] += rank[e.source] * e.weight / outWeight[e.source];
+         });
+         if(!read)
+            return std::vector<double>();
+      }
+      double change = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         next[v] = (1 - damping) / n + damping * (next[v] + dangling / n);
+         change += std::fabs(next[v] - rank[v]);
+      }
+      rank.swap(next);
+      if(change < tolerance)
+         break;
+   }
+   return rank;
+}
+
+/**
+   A full pass must find the edges() records of the header: fewer means
+   a partition file was truncated or replaced
+
+   @param  p       partition just scanned
+   @param  scanned edges scanned in partitions 0 ... p
+   @return false, clearing good(), if the pass is over and came short
+*/
+bool ExternalGraph::_complete(unsigned p, unsigned long scanned) const {
+   if(p + 1 < _partitions || scanned == _edges)
+      return true;
+   return _good = false;
+}
+
+/**
+   Constructor, creates (truncates) the partition files
+
+   @param  prefix      path of the graph files without their extension
+   @param  nodes       number of nodes, edge ends must be below it
+   @param  partitions  number of partition files (node ranges of equal size)
+   @param  directed    false: every edge is also stored reversed
+   @param  bufferEdges edges buffered in memory over all partitions
+*/
+ExternalGraph::Writer::Writer(const std::string& prefix, unsigned nodes, unsigned partitions,
+                              bool directed, unsigned long bufferEdges)
+   : _prefix(prefix), _nodes(nodes), _directed(directed), _good(true), _closed(false),
+     _edges(0) {
+   partitions = std::max(1u, std::min(partitions, std::max(nodes, 1u)));
+   _span = std::max(1u, (nodes + partitions - 1) / partitions);
+   partitions = std::max(1u, (nodes + _span - 1) / _span);
+   _bufferEdges = std::max(bufferEdges / partitions, 1024ul);
+   _buffer.resize(partitions);
+   for(unsigned p = 0; p < partitions; ++p) {
+      std::string path = prefix + "." + std::to_string(p) + ".edges";
+      _file.push_back(std::fopen(path.c_str(), "wb"));
+      _good = _good && _file.back();
+   }
+}
+
+/**
+   Destructor, closes the writer if close() was not called
+*/
+ExternalGraph::Writer::~Writer() {
+   close();
+}
+
+/**
+   @param  u      source node id
+   @param  v      target node id
+   @param  weight weight of the edge, stored as a float
+   @return void
+*/
+void ExternalGraph::Writer::addEdge(unsigned u, unsigned v, double weight) {
+   if(_closed || u >= _nodes || v >= _nodes)
+      return;
+   _append(u, v, static_cast<float>(weight));
+   if(!_directed && u != v)
+      _append(v, u, static_cast<float>(weight));
+}
+
+/**
+   @return void
+*/
+void ExternalGraph::Writer::_append(unsigned u, unsigned v, float weight) {
+   unsigned p = u / _span;
+   ExternalGraph::Edge e = { u, v, weight };
+   _buffer[p].push_back(e);
+   ++_edges;
+   if(_buffer[p].size() >= _bufferEdges)
+      _flush(p);
+}
+
+/**
+   @return void
+*/
+void ExternalGraph::Writer::_flush(unsigned p) {
+   std::vector<ExternalGraph::Edge>& buffer = _buffer[p];
+   if(_file[p] && !buffer.empty()) {
+      _good = _good && std::fwrite(&buffer[0], sizeof(ExternalGraph::Edge), buffer.size(),
+                                   _file[p]) == buffer.size();
+   }
+   buffer.clear();
+}
+
+/**
+   Sort every partition by (source, target) and write the header
+
+   @return true if every file was written
+*/
+bool ExternalGraph::Writer::close() {
+   if(_closed)
+      return _good;
+   _closed = true;
+   GRAPH_STAT_TIMER("externalWrite");
+   std::vector<ExternalGraph::Edge> edges;
+   for(unsigned p = 0; p < _file.size(); ++p) {
+      _flush(p);
+      std::vector<ExternalGraph::Edge>().swap(_buffer[p]);
+      if(!_file[p])
+         continue;
+      std::fclose(_file[p]);
+
+      std::string path = _prefix + "." + std::to_string(p) + ".edges";
+      std::FILE* file = std::fopen(path.c_str(), "rb");
+      if(!file) {
+         _good = false;
+         continue;
+      }
+      std::fseek(file, 0, SEEK_END);
+      edges.resize(std::ftell(file) / sizeof(ExternalGraph::Edge));
+      std::fseek(file, 0, SEEK_SET);
+      if(!edges.empty())
+         _good = _good && std::fread(&edges[0], sizeof(ExternalGraph::Edge), edges.size(),
+                                     file) == edges.size();
+      std::fclose(file);
+
+      std::sort(edges.begin(), edges.end(),
+                [](const ExternalGraph::Edge& a, const ExternalGraph::Edge& b) {
+                   return a.source != b.source ? a.source < b.source : a.target < b.target;
+                });
+      file = std::fopen(path.c_str(), "wb");
+      if(!file) {
+         _good = false;
+         continue;
+      }
+      if(!edges.empty())
+         _good = _good && std::fwrite(&edges[0], sizeof(ExternalGraph::Edge), edges.size(),
+                                      file) == edges.size();
+      std::fclose(file);
+   }
+
+   std::FILE* header = std::fopen((_prefix + ".graph").c_str(), "w");
+   if(!header)
+      return _good = false;
+   std::fprintf(header, "GraphLib external %d %u %lu %u %u\n", _directed ? 1 : 0, _nodes,
+                _edges, static_cast<unsigned>(_file.size()), _span);
+   _good = std::fclose(header) == 0 && _good;
+   return _good;
+}
@@ -0,0 +1,134 @@
+/*
+   @file    ExternalGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef EXTERNAL_GRAPH_HH
+#define EXTERNAL_GRAPH_HH 1
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Semi-external graph for edge sets larger than memory: only the state
+    of the nodes (a few bytes each) is kept in RAM, the edges stay on disk
+    split by source node range in partition files, each sorted by source,
+    and every algorithm streams them sequentially (X-Stream / GraphChi
+    style); partitions without active nodes are skipped.
+    A partition file that cannot be opened or read, or a full pass that
+    does not find edges() records, stops the algorithm: it returns an
+    empty result and good() turns false.
+    Files: <prefix>.graph (header) and <prefix>.<p>.edges (raw Edge
+    records in the machine's byte order). Nodes are ids 0 ... nodes()-1
+*/
+class ExternalGraph {
+
+public:
+   /** one edge on disk, 12 bytes */
+   struct Edge {
+      unsigned source;
+      unsigned target;
+      float    weight;
+   };
+
+   /** streams the edges of a graph to disk without holding them */
+   class Writer;
+
+   /** bufferEdges: edges read at once from a partition file */
+   explicit ExternalGraph(const std::string& prefix, unsigned long bufferEdges = 1 << 20);
+
+   /** C written under prefix, partitions = 0 for about 16M edges each */
+   static bool write(const CompactGraph& C, const std::string& prefix,
+                     unsigned partitions = 0);
+
+   /** false if the header could not be read or an algorithm met a
+       missing, unreadable or truncated partition */
+   inline bool          good() const;
+   inline unsigned      nodes() const;
+   /** edges on disk, both directions of an undirected edge */
+   inline unsigned long edges() const;
+   inline unsigned      partitions() const;
+   inline bool          isOriented() const;
+   /** partition holding the out-edges of v */
+   inline unsigned      partition(unsigned v) const;
+
+   /** hop distance of every node, CompactGraph::unreachable if not
+       reached; empty if a partition could not be read */
+   std::vector<unsigned> BFS(unsigned source) const;
+   /** weakly connected components, numbered by their smallest node;
+       0 and component empty if a partition could not be read */
+   unsigned components(std::vector<unsigned>& component) const;
+   /** empty if a partition could not be read */
+   std::vector<double> pageRank(double damping = 0.85, double tolerance = 1e-9,
+                                unsigned maxIterations = 100) const;
+
+private:
+   std::string   _prefix;
+   mutable bool  _good;
+   bool          _directed;
+   unsigned      _nodes;
+   unsigned long _edges;
+   unsigned      _partitions;
+   /** nodes per partition */
+   unsigned      _span;
+   unsigned long _bufferEdges;
+
+   /** fn(edge) for every edge of partition p, in file order */
+   template<typename F> bool _scan(unsigned p, F fn) const;
+   bool _complete(unsigned p, unsigned long scanned) const;
+
+/** class ExternalGraph */
+};
+
+/** Edges are appended to the partition files through small buffers, in
+    any order; close() sorts every partition by source (one partition at
+    a time in memory) and writes the header. A partition must then fit in
+    memory: pick partitions so that 12 bytes times its edges (twice that
+    for an undirected graph) does, ExternalGraph::write() aims at 16M
+    edges per partition
+*/
+class ExternalGraph::Writer {
+
+public:
+   /** directed = false: every edge is also stored reversed */
+   Writer(const std::string& prefix, unsigned nodes, unsigned partitions,
+          bool directed = true, unsigned long bufferEdges = 1 << 20);
+   ~Writer();
+
+   Writer(const Writer&) = delete;
+   Writer& operator=(const Writer&) = delete;
+
+   /** ignored if an end is not below nodes */
+   void addEdge(unsigned u, unsigned v, double weight = 1);
+   /** false if a file could not be written */
+   bool close();
+
+private:
+   std::string   _prefix;
+   unsigned      _nodes;
+   unsigned      _span;
+   bool          _directed;
+   bool          _good;
+   bool          _closed;
+   unsigned long _edges;
+   unsigned long _bufferEdges;
+   std::vector<std::FILE*>                       _file;
+   std::vector<std::vector<ExternalGraph::Edge> > _buffer;
+
+   void _append(unsigned u, unsigned v, float weight);
+   void _flush(unsigned p);
+
+/** class Writer */
+};
+
+/** include inline functions */
+#include "ExternalGraph_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //EXTERNAL_GRAPH_HH
@@ -0,0 +1,86 @@
+/*
+   @file    ExternalGraph_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef EXTERNAL_GRAPH_INLINES_HH
+#define EXTERNAL_GRAPH_INLINES_HH 1
+
+/**
+   @return could the graph be opened, and every partition read since?
+*/
+inline bool
+ExternalGraph::good() const {
+   return _good;
+}
+
+/**
+   @return number of nodes
+*/
+inline unsigned
+ExternalGraph::nodes() const {
+   return _nodes;
+}
+
+/**
+   @return number of edge records on disk
+*/
+inline unsigned long
+ExternalGraph::edges() const {
+   return _edges;
+}
+
+/**
+   @return number of partition files
+*/
+inline unsigned
+ExternalGraph::partitions() const {
+   return _partitions;
+}
+
+/**
+   @return is the graph directed?
+*/
+inline bool
+ExternalGraph::isOriented() const {
+   return _directed;
+}
+
+/**
+   @param  v node id
+   @return partition holding the out-edges of v
+*/
+inline unsigned
+ExternalGraph::partition(unsigned v) const {
+   return v / _span;
+}
+
+/**
+   Read partition p through a buffer of _bufferEdges edges at most
+
+   @param  p  partition
+   @param  fn callable invoked as fn(const Edge&)
+   @return false if the partition file could not be opened or read
+           (clears good())
+*/
+template<typename F>
+bool ExternalGraph::_scan(unsigned p, F fn) const {
+   std::FILE* file = std::fopen((_prefix + "." + std::to_string(p) + ".edges").c_str(), "rb");
+   if(!file)
+      return _good = false;
+   std::vector<Edge> buffer(std::min(_bufferEdges, _edges + 1));
+   std::size_t read;
+   while((read = std::fread(&buffer[0], sizeof(Edge), buffer.size(), file)) > 0) {
+      GRAPH_STAT_COUNT("externalScan", edgesScanned, read);
+      for(std::size_t i = 0; i < read; ++i)
+         fn(buffer[i]);
+   }
+   /** a short read is either the end of the file or an error */
+   bool failed = std::ferror(file) != 0;
+   std::fclose(file);
+   if(failed)
+      _good = false;
+   return !failed;
+}
+
+#endif
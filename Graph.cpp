@@ -12,6 +12,9 @@
 #include <ctime>
 #include <queue>
 #include "Graph.hh"
+#include "CompactGraph.hh"
+#include "Parallel.hh"
+#include "ReachabilityIndex.hh"
 #include "Utility.hh"
 
 using namespace GraphLib;
@@ -21,31 +24,84 @@ using namespace GraphLib;
 #define INF 99999
 
 typedef std::pair<std::string, std::string> link;
-typedef std::map<std::string, bool> mapStringBool;
+
+namespace {
+   /** allocator for the scratch containers of the algorithms */
+   ResourceAllocator<char> scratch() {
+      return ResourceAllocator<char>(scratchResource());
+   }
+}
 
 int  Graph::random = 0;
 int  Graph::circular = 1;
 bool Graph::directed = true;
 bool Graph::undirected = false;
+int  Graph::kruskal = 0;
+int  Graph::boruvka = 1;
 
 /**
    Constructor
    
    @param  graphType  directed/undirect graph
+   @param  resource   memory of the graph's containers, eg. a
+                      MonotonicResource for a build-once graph
 */
-Graph::Graph(bool graphType) {
+Graph::Graph(bool graphType, MemoryResource* resource)
+   : _resource(resource),
+     _node(_allocator()), _edge(_allocator()), _edgeWeight(_allocator()),
+     _nodeDead(_allocator()), _edgeDead(_allocator()), _deadNodes(0), _deadEdges(0),
+     _vacuumThreshold(0.25), _nodeAt(_allocator()), _edgeAt(_allocator()),
+     _successors(_allocator()), _predecessors(_allocator()),
+     _parent(_allocator()), _componentSize(_allocator()), _forest(_allocator()),
+     _components(0), _componentsStale(false), _order(_allocator()),
+     _acyclic(true), _orderStale(false), _nextOrder(0),
+     _reachTraversals(0), _reachClosureLimit(0), _version(1), _topology(1) {
    direct = graphType;
 }
 
 /**
-   Copy contructor
+   Copy contructor, the copy uses the global new/delete
 
    @param  Graph graph to copy
 */
-Graph::Graph(const Graph& G) {
+Graph::Graph(const Graph& G) : Graph(G, newDeleteResource()) {
+}
+
+/**
+   Copy contructor
+
+   @param  Graph    graph to copy
+   @param  resource memory of the copy's containers
+*/
+Graph::Graph(const Graph& G, MemoryResource* resource)
+   : Graph(G.isOriented(), resource) {
+   GRAPH_STAT_TIMER("copy");
    _node = G._Node();
    _edge = G._Edge();
    _edgeWeight = G._EdgeWeight();
+   _nodeDead = G._nodeDead;
+   _edgeDead = G._edgeDead;
+   _deadNodes = G._deadNodes;
+   _deadEdges = G._deadEdges;
+   _vacuumThreshold = G._vacuumThreshold;
+   _nodeAt = G._nodeAt;
+   _edgeAt = G._edgeAt;
+   _successors = G._successors;
+   _predecessors = G._predecessors;
+   _parent = G._parent;
+   _componentSize = G._componentSize;
+   _forest = G._forest;
+   _components = G._components;
+   _componentsStale = G._componentsStale;
+   _order = G._order;
+   _acyclic = G._acyclic;
+   _orderStale = G._orderStale;
+   _nextOrder = G._nextOrder;
+   _reachTraversals = G._reachTraversals;
+   _reachClosureLimit = G._reachClosureLimit;
+   _version = G._version;
+   _topology = G._topology;
+   std::atomic_store(&_reachability, std::atomic_load(&G._reachability));
 }
 
 /**
@@ -54,23 +110,24 @@ Graph::Graph(const Graph& G) {
    @param regex     regex eg. A-Z, 1-6
    @param edgeType  random/circular edges generation
    @param graphType directed/undirect graph
+   @param resource  memory of the graph's containers
 */
-Graph::Graph(std::string regex, int edgeType, bool graphType) {
-   direct = graphType;
+Graph::Graph(std::string regex, int edgeType, bool graphType, MemoryResource* resource)
+   : Graph(graphType, resource) {
    if(utility::checkIfInterval(regex)) {
       /** 1-9,  a-z,  A-Z ... */
       if(regex.length() == 3) {  
          std::vector<char> tmp = utility::regexChar(regex);
          std::vector<char>::const_iterator it;
          for(it = tmp.begin(); it != tmp.end(); ++it)
-            _node.push_back(utility::to_string(*it));
+            addNode(utility::to_string(*it));
       }
       /** 10-17,  12-102 ... */
       else if(regex.length() > 3) { 
          std::vector<int> tmp = utility::regexInt(regex);
          std::vector<int>::const_iterator it;
          for(it = tmp.begin(); it != tmp.end(); ++it)
-            _node.push_back(utility::to_string(*it));
+            addNode(utility::to_string(*it));
       }
    }
    _generateEdge(edgeType);
@@ -98,7 +155,7 @@ void Graph::_generateEdge(int edgeType) {
       /** circular */
       case 1: { 
          std::string initialNode = _node.at(0);
-         std::vector<std::string>::const_iterator it;
+         nodeList::const_iterator it;
          for(it = _node.begin(); it != _node.end(); ++it) {
             if(it + 1 != _node.end())
                addEdge(*it, *(it + 1));
@@ -133,52 +190,116 @@ Graph Graph::generateRandomGraph(int maxNode, bool graphType) {
 
    @return Graph
 */
-Graph Graph::transpose() {
+Graph Graph::transpose() const {
+   GRAPH_STAT_TIMER("transpose");
   Graph G;
   for(auto e = _edge.begin(); e != _edge.end(); ++e) {
+    if(!_alive(e))
+      continue;
     G.addEdge(e->second, e->first, weight(e->first, e->second));
   }
   return G;
 }
 
 /**
-   Add node to the graph
+   Add node to the graph, nothing if it is already there
 
    @param  node node to add
    @return void
 */
 void Graph::addNode(std::string node) {
+   GRAPH_STAT_TIMER("addNode");
+   if(_nodeAt.insert(std::make_pair(node, _node.size())).second) {
+      ++_version;
+      ++_topology;
       _node.push_back(node);
+      _nodeDead.push_back(0);
+      /** the index may still hold a removed node of the same name */
+      std::shared_ptr<const ReachabilityIndex> index = std::atomic_load(&_reachability);
+      if(index && index->knows(node))
+         _dropReachability();
+      /** a new node is a component on its own and the last in the order */
+      if(_parent.find(node) == _parent.end()) {
+         _parent[node] = node;
+         _componentSize[node] = 1;
+         ++_components;
+         _order[node] = _nextOrder++;
+      }
+   }
 }
 
 /**
-   Remove node from the graph
+   Remove node from the graph: it and its edges become tombstones, found
+   through the adjacency lists, so the cost is the degree of the node
+   plus the degrees of its neighbours (to unlink it from their lists)
 
    @param  node node to remove
    @return void
 */
 void Graph::removeNode(std::string node) {
-   std::vector<std::string>::iterator v;
-   std::vector<link>::iterator e;
-   std::vector<link> edgeToRemove;
-   
-   v = std::find(_node.begin(), _node.end(), node);
-   if(v != _node.end()) {
+   GRAPH_STAT_TIMER("removeNode");
+   resourceMap<std::string, unsigned>::iterator at = _nodeAt.find(node);
+   if(at != _nodeAt.end()) {
+      ++_version;
+      ++_topology;
       /** remove the edge connected to the node */
-      for(e = _edge.begin(); e != _edge.end(); ++e) {
-         if(direct) {
-            if(e->first == node || e->second == node)
-               edgeToRemove.push_back(std::make_pair(e->first, e->second));
+      adjacencyMap::iterator succ = _successors.find(node);
+      adjacencyMap::iterator pred = _predecessors.find(node);
+      bool edges = false, forest = false, in = false, out = false;
+      if(succ != _successors.end()) {
+         for(auto w = succ->second.begin(); w != succ->second.end(); ++w) {
+            edges = true;
+            forest |= _buryEdge(node, *w);
+            if(*w == node)
+               continue;
+            out = true;
+            nodeList& back = direct ? _predecessors[*w] : _successors[*w];
+            back.erase(std::find(back.begin(), back.end(), node));
+            if(!direct) {
+               nodeList& pred2 = _predecessors[*w];
+               pred2.erase(std::find(pred2.begin(), pred2.end(), node));
+            }
          }
-         else {
-            if(e->first == node)
-               edgeToRemove.push_back(std::make_pair(e->first, e->second));
+      }
+      if(direct && pred != _predecessors.end()) {
+         for(auto u = pred->second.begin(); u != pred->second.end(); ++u) {
+            edges = true;
+            if(*u == node)
+               continue;
+            in = true;
+            forest |= _buryEdge(*u, node);
+            nodeList& out = _successors[*u];
+            out.erase(std::find(out.begin(), out.end(), node));
          }
       }
-      /** removing edges */
-      for(e = edgeToRemove.begin(); e != edgeToRemove.end(); ++e)
-         removeEdge(e->first, e->second);
-      _node.erase(v);
+      if(succ != _successors.end())
+         _successors.erase(succ);
+      if(pred != _predecessors.end())
+         _predecessors.erase(pred);
+      /** removing edges keeps a topological order valid, but they may
+          hold the last cycle of the graph */
+      if(edges && direct && !_acyclic)
+         _orderStale = true;
+
+      _nodeDead[at->second] = 1;
+      ++_deadNodes;
+      _nodeAt.erase(at);
+      _order.erase(node);
+      /** no path goes through a source or a sink: the other nodes keep
+          their reachability, addNode() drops the index if the name comes
+          back */
+      if(in && out)
+         _dropReachability();
+      /** other nodes may hang from it in the union-find: rebuilt later */
+      if(forest)
+         _componentsStale = true;
+      /** unless one of its forest edges went away (and the components
+          are stale anyway) the node was a component on its own */
+      _parent.erase(node);
+      _componentSize.erase(node);
+      if(!_componentsStale)
+         --_components;
+      _vacuumIfNeeded();
    }
 }
 
@@ -191,6 +312,7 @@ void Graph::removeNode(std::string node) {
    @return void
 */
 void Graph::addEdge(std::string fromNode, std::string toNode, double cost) {
+   GRAPH_STAT_TIMER("addEdge");
    /** if the nodes do not exist, create them */
    if(!exist(fromNode))
       addNode(fromNode);
@@ -199,46 +321,260 @@ void Graph::addEdge(std::string fromNode, std::string toNode, double cost) {
       addNode(toNode);
 
    if(!hasEdge(fromNode, toNode)) {
+      ++_version;
+      ++_topology;
+      /** the index stays valid if fromNode already reaches toNode */
+      std::shared_ptr<const ReachabilityIndex> index = std::atomic_load(&_reachability);
+      if(index && !index->reachable(fromNode, toNode))
+         _dropReachability();
+      /** keep the connectivity and the topological order up to date */
+      if(_componentsStale)
+         _rebuildComponents();
+      if(direct && _orderStale)
+         _rebuildOrder();
+      _unionComponents(fromNode, toNode);
+      if(direct && _acyclic)
+         _acyclic = _reorder(fromNode, toNode);
+
+      GRAPH_STAT_COUNT("addEdge", allocations, direct ? 1 : 2);
+      _edgeAt.insert(std::make_pair(std::make_pair(fromNode, toNode), _edge.size()));
       if(direct) {
          _edge.push_back(std::make_pair(fromNode, toNode));
+         _edgeDead.push_back(0);
          _edgeWeight[std::make_pair(fromNode, toNode)] = cost;
+         _successors[fromNode].push_back(toNode);
+         _predecessors[toNode].push_back(fromNode);
       }
       /** undirected graph */
       else { 
+         _edgeAt.insert(std::make_pair(std::make_pair(toNode, fromNode), _edge.size() + 1));
          _edge.push_back(std::make_pair(fromNode, toNode));
          _edge.push_back(std::make_pair(toNode, fromNode));
+         _edgeDead.resize(_edge.size(), 0);
          _edgeWeight[std::make_pair(fromNode, toNode)] = cost;
          _edgeWeight[std::make_pair(toNode, fromNode)] = cost;
+         _successors[fromNode].push_back(toNode);
+         _predecessors[toNode].push_back(fromNode);
+         _successors[toNode].push_back(fromNode);
+         _predecessors[fromNode].push_back(toNode);
       }
    }
 }
 
 /**
-   Remove edge from the graph
+   Remove edge from the graph, its slot in _edge becomes a tombstone
 
    @param  fromNode edge from node
    @param  toNode   edge to node
    @return void
 */
 void Graph::removeEdge(std::string fromNode, std::string toNode) {
+   GRAPH_STAT_TIMER("removeEdge");
    if(hasEdge(fromNode, toNode)) {
-      if(direct) {
-         _edge.erase(std::find(_edge.begin(), _edge.end(), 
-                               std::make_pair(fromNode, toNode)));
-         _edgeWeight.erase(std::make_pair(fromNode, toNode));
+      ++_version;
+      ++_topology;
+      bool forest = _buryEdge(fromNode, toNode);
+
+      nodeList& succ = _successors[fromNode];
+      nodeList& pred = _predecessors[toNode];
+      succ.erase(std::find(succ.begin(), succ.end(), toNode));
+      pred.erase(std::find(pred.begin(), pred.end(), fromNode));
+      if(!direct) {
+         nodeList& succ2 = _successors[toNode];
+         nodeList& pred2 = _predecessors[fromNode];
+         succ2.erase(std::find(succ2.begin(), succ2.end(), fromNode));
+         pred2.erase(std::find(pred2.begin(), pred2.end(), toNode));
       }
-      /** undirected graph */
-      else {
-         _edge.erase(std::find(_edge.begin(), _edge.end(), 
-                               std::make_pair(fromNode, toNode)));
-         _edge.erase(std::find(_edge.begin(), _edge.end(), 
-                               std::make_pair(toNode, fromNode)));
-         _edgeWeight.erase(std::make_pair(fromNode, toNode));
-         _edgeWeight.erase(std::make_pair(toNode, fromNode));
+
+      /** only losing a spanning forest edge can split a component, and
+          only if no other edge joins the two halves of its tree; when
+          none does, the rebuild is deferred to the next insertion */
+      if(forest && !_componentsStale && !_replaceForestEdge(fromNode, toNode))
+         _componentsStale = true;
+
+      /** removing an edge keeps a topological order valid, but it may
+          break the last cycle of the graph */
+      if(direct && !_acyclic)
+         _orderStale = true;
+      /** a path through the edge can go around it iff fromNode still
+          reaches toNode: then the index is still exact */
+      std::shared_ptr<const ReachabilityIndex> index = std::atomic_load(&_reachability);
+      if(index && !_reachesWithout(fromNode, toNode, *index))
+         _dropReachability();
+      _vacuumIfNeeded();
+   }
+}
+
+/**
+   Flag the slots of fromNode -> toNode (and toNode -> fromNode when
+   undirected) as dead and drop their weights and forest entry; the
+   adjacency lists and the components are left to the caller
+
+   @return true if the edge was in the spanning forest
+*/
+bool Graph::_buryEdge(const std::string& fromNode, const std::string& toNode) {
+   resourceMap<link, unsigned long>::iterator at = _edgeAt.find(std::make_pair(fromNode, toNode));
+   if(at == _edgeAt.end())
+      return false;
+   _edgeDead[at->second] = 1;
+   ++_deadEdges;
+   /** an undirected self-loop is stored twice, side by side */
+   if(!direct && fromNode == toNode) {
+      _edgeDead[at->second + 1] = 1;
+      ++_deadEdges;
+   }
+   _edgeAt.erase(at);
+   _edgeWeight.erase(std::make_pair(fromNode, toNode));
+   if(!direct && fromNode != toNode) {
+      at = _edgeAt.find(std::make_pair(toNode, fromNode));
+      _edgeDead[at->second] = 1;
+      ++_deadEdges;
+      _edgeAt.erase(at);
+      _edgeWeight.erase(std::make_pair(toNode, fromNode));
+   }
+
+   return _forest.erase(std::make_pair(fromNode, toNode)) +
+          _forest.erase(std::make_pair(toNode, fromNode)) > 0;
+}
+
+/**
+   The forest edge fromNode - toNode is gone and its tree is in two
+   halves: walk both in lockstep until one is exhausted, so only the
+   smaller half is walked (twice over at most), then look for an edge
+   leaving that half; an edge between the parts walked so far ends the
+   walk early. It joins the halves again and takes the place of the lost
+   edge; the union-find is unchanged
+
+   @return false if no edge joins the halves: the component is split
+*/
+bool Graph::_replaceForestEdge(const std::string& fromNode, const std::string& toNode) {
+   auto inForest = [this](const std::string& x, const std::string& y) {
+      return _forest.count(std::make_pair(x, y)) + _forest.count(std::make_pair(y, x)) > 0;
+   };
+   nodeSet seen[2] = { nodeSet(scratch()), nodeSet(scratch()) };
+   nodeList stack[2] = { nodeList(1, fromNode, scratch()), nodeList(1, toNode, scratch()) };
+   seen[0].insert(fromNode);
+   seen[1].insert(toNode);
+   int small = -1;
+   while(small < 0) {
+      for(int side = 0; side < 2 && small < 0; ++side) {
+         if(stack[side].empty()) {
+            small = side;
+            break;
+         }
+         std::string x = stack[side].back();
+         stack[side].pop_back();
+         const nodeList* around[2] = { &_adjacent(x), 0 };
+         auto pred = _predecessors.find(x);
+         if(pred != _predecessors.end())
+            around[1] = &pred->second;
+         for(int k = 0; k < 2; ++k) {
+            if(!around[k])
+               continue;
+            for(auto y = around[k]->begin(); y != around[k]->end(); ++y) {
+               /** an edge into the other half found on the way */
+               if(seen[1 - side].count(*y)) {
+                  _forest.insert(k == 0 ? std::make_pair(x, *y) : std::make_pair(*y, x));
+                  return true;
+               }
+               if(inForest(x, *y) && seen[side].insert(*y).second)
+                  stack[side].push_back(*y);
+            }
+         }
+      }
+   }
+
+   const nodeSet& half = seen[small];
+   GRAPH_STAT_COUNT("removeEdge", nodesVisited, half.size());
+   for(auto x = half.begin(); x != half.end(); ++x) {
+      const nodeList& succ = _adjacent(*x);
+      for(auto y = succ.begin(); y != succ.end(); ++y) {
+         if(half.find(*y) == half.end()) {
+            _forest.insert(std::make_pair(*x, *y));
+            return true;
+         }
+      }
+      auto pred = _predecessors.find(*x);
+      if(pred == _predecessors.end())
+         continue;
+      for(auto y = pred->second.begin(); y != pred->second.end(); ++y) {
+         if(half.find(*y) == half.end()) {
+            _forest.insert(std::make_pair(*y, *x));
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+/**
+   Drop the tombstones: one pass over _node and _edge moving the live
+   entries down, in order, and updating their positions
+
+   @return void
+*/
+void Graph::vacuum() {
+   GRAPH_STAT_TIMER("vacuum");
+   if(_deadNodes > 0) {
+      unsigned live = 0;
+      for(unsigned v = 0; v < _node.size(); ++v) {
+         if(_nodeDead[v])
+            continue;
+         if(live != v) {
+            _nodeAt.find(_node[v])->second = live;
+            _node[live] = std::move(_node[v]);
+         }
+         ++live;
+      }
+      _node.erase(_node.begin() + live, _node.end());
+      _nodeDead.assign(live, 0);
+      _deadNodes = 0;
+   }
+   if(_deadEdges > 0) {
+      unsigned long live = 0;
+      for(unsigned long e = 0; e < _edge.size(); ++e) {
+         if(_edgeDead[e])
+            continue;
+         if(live != e) {
+            /** the second copy of an undirected self-loop has no entry */
+            resourceMap<link, unsigned long>::iterator at = _edgeAt.find(_edge[e]);
+            if(at->second == e)
+               at->second = live;
+            _edge[live] = std::move(_edge[e]);
+         }
+         ++live;
       }
+      _edge.erase(_edge.begin() + live, _edge.end());
+      _edgeDead.assign(live, 0);
+      _deadEdges = 0;
    }
 }
 
+/**
+   @param  deadFraction vacuum() when more than this fraction of the nodes
+                        (or of the edges) are tombstones, 1 or more = only
+                        on demand
+   @return void
+*/
+void Graph::setVacuumThreshold(double deadFraction) {
+   _vacuumThreshold = deadFraction;
+   _vacuumIfNeeded();
+}
+
+/**
+   Amortized: at least a threshold fraction of the entries were removed
+   since the last pass
+
+   @return void
+*/
+void Graph::_vacuumIfNeeded() {
+   if(_vacuumThreshold >= 1)
+      return;
+   if(_deadNodes > _vacuumThreshold * _node.size() ||
+      _deadEdges > _vacuumThreshold * _edge.size())
+      vacuum();
+}
+
 /** 
    Set weight to edge(fromNode, toNode)
 
@@ -247,7 +583,10 @@ void Graph::removeEdge(std::string fromNode, std::string toNode) {
    @return void
 */
 void Graph::setWeight(std::string fromNode, std::string toNode, double cost) {
+   GRAPH_STAT_TIMER("setWeight");
    if(exist(fromNode) && exist(toNode)) {
+      /** the weights changed, not the nodes or edges */
+      ++_version;
       if(direct) {
          _edgeWeight[std::make_pair(fromNode, toNode)] = cost;
       }
@@ -265,22 +604,27 @@ void Graph::setWeight(std::string fromNode, std::string toNode, double cost) {
    @return void
 */
 void Graph::print(std::ostream& os) const {
-   std::vector<std::string>::const_iterator V;
-   std::vector<link>::const_iterator E;
+   nodeList::const_iterator V;
+   linkList::const_iterator E;
+   const char* separator = "";
    os << "Node : { ";
    for(V = _node.begin(); V != _node.end(); ++V) {
-      os << *V;
-      if(V + 1 != _node.end())
-         os << " , ";
+      if(!_alive(V))
+         continue;
+      os << separator << *V;
+      separator = " , ";
    }
 
    os << " }" << std::endl << "Edge : { " << std::endl;
 
-   for(E = _edge.begin();  E != _edge.end(); ++E)
+   for(E = _edge.begin();  E != _edge.end(); ++E) {
+      if(!_alive(E))
+         continue;
       os << "\t( "
                 << E->first  << " , " << E->second
                 << " ) "
                 << " weight: " << _edgeWeight.at(*E) << std::endl;
+   }
 
    os << std::endl << "}" << std::endl;
 }
@@ -290,13 +634,21 @@ void Graph::print(std::ostream& os) const {
 
 */
 std::list<std::string> Graph::adjacent(std::string v) const {
-   std::list<std::string> adj;
-   std::vector<link>::const_iterator E;
-   for(E = _edge.begin(); E != _edge.end(); ++E) {
-      if(E->first == v)
-         adj.push_back(E->second);
-   }
-   return adj;
+   GRAPH_STAT_TIMER("adjacent");
+   const nodeList& adj = _adjacent(v);
+   GRAPH_STAT_COUNT("adjacent", allocations, adj.size());
+   return std::list<std::string>(adj.begin(), adj.end());
+}
+
+/**
+   Successors of v without copying them, for the algorithms
+
+   @return nodeList
+*/
+const Graph::nodeList& Graph::_adjacent(const std::string& v) const {
+   static const nodeList none;
+   adjacencyMap::const_iterator s = _successors.find(v);
+   return s != _successors.end() ? s->second : none;
 }
 
 /**
@@ -305,16 +657,8 @@ std::list<std::string> Graph::adjacent(std::string v) const {
    @return unsigned
 */
 unsigned Graph::minRank() const {
-   unsigned min;
-   std::vector<std::string>::const_iterator v = _node.begin();
-   min = rank(*v);
-
-   for(v = _node.begin() + 1; v != _node.end(); ++v) {
-      if(v != _node.end())
-         if(rank(*v) < min)
-            min = rank(*v);
-   }
-   return min;
+   GRAPH_STAT_TIMER("minRank");
+   return _memoize(_rankCache, _topology, [this]() { return _rankRange(); }).first;
 }
 
 /**
@@ -323,25 +667,125 @@ unsigned Graph::minRank() const {
    @return unsigned
 */
 unsigned Graph::maxRank() const {
-   unsigned max;
-   std::vector<std::string>::const_iterator v = _node.begin();
-   max = rank(*v);
+   GRAPH_STAT_TIMER("maxRank");
+   return _memoize(_rankCache, _topology, [this]() { return _rankRange(); }).second;
+}
+
+/**
+   Min and max rank in one pass, 0 and 0 for an empty graph
 
-   for(v = _node.begin() + 1; v != _node.end(); ++v) {
-      if(v != _node.end())
-         if(rank(*v) > max)
-            max = rank(*v);
+   @return std::pair<unsigned, unsigned>
+*/
+std::pair<unsigned, unsigned> Graph::_rankRange() const {
+   std::pair<unsigned, unsigned> range(0, 0);
+   bool first = true;
+   for(auto v = _node.begin(); v != _node.end(); ++v) {
+      if(!_alive(v))
+         continue;
+      unsigned r = rank(*v);
+      if(first || r < range.first)
+         range.first = r;
+      if(first || r > range.second)
+         range.second = r;
+      first = false;
    }
-   return max;
+   return range;
+}
+
+namespace {
+   /** bookkeeping of a std::map node (colour, parent, left, right) */
+   const unsigned long treeNodeBytes = 4 * sizeof(void*);
+
+   /** plain values own no heap memory */
+   unsigned long heapBytes(double) { return 0; }
+   unsigned long heapBytes(unsigned) { return 0; }
+   unsigned long heapBytes(int) { return 0; }
+   unsigned long heapBytes(unsigned long) { return 0; }
+   unsigned long heapBytes(char) { return 0; }
+
+   /** heap bytes of a string, 0 when stored inline (small string) */
+   unsigned long heapBytes(const std::string& s) {
+      return s.capacity() > 15 ? s.capacity() + 1 : 0;
+   }
+
+   unsigned long heapBytes(const std::pair<std::string, std::string>& e) {
+      return heapBytes(e.first) + heapBytes(e.second);
+   }
+
+   /** heap bytes of a vector of strings (or pairs of strings) */
+   template<typename T, typename A>
+   unsigned long heapBytes(const std::vector<T, A>& v) {
+      unsigned long bytes = v.capacity() * sizeof(T);
+      for(auto i = v.begin(); i != v.end(); ++i)
+         bytes += heapBytes(*i);
+      return bytes;
+   }
+
+   /** heap bytes of a map whose keys and values are strings, pairs of
+       strings, vectors of strings or plain values */
+   template<typename K, typename V, typename C, typename A>
+   unsigned long heapBytes(const std::map<K, V, C, A>& m) {
+      unsigned long bytes = 0;
+      for(auto i = m.begin(); i != m.end(); ++i)
+         bytes += treeNodeBytes + sizeof(*i) + heapBytes(i->first) + heapBytes(i->second);
+      return bytes;
+   }
+
 }
 
 /**
-   Control if graph has negative weight
+   Estimate of the heap memory held by the graph, container by container
+
+   @return MemoryUsage
+*/
+Graph::MemoryUsage Graph::memoryUsage() const {
+   MemoryUsage usage;
+   usage.nodes = heapBytes(_node) + heapBytes(_nodeDead) + heapBytes(_nodeAt);
+   usage.edges = heapBytes(_edge) + heapBytes(_edgeDead) + heapBytes(_edgeAt);
+   usage.weights = heapBytes(_edgeWeight);
+   usage.adjacency = heapBytes(_successors) + heapBytes(_predecessors);
+   usage.components = heapBytes(_parent) + heapBytes(_componentSize);
+   for(auto e = _forest.begin(); e != _forest.end(); ++e)
+      usage.components += treeNodeBytes + sizeof(*e) + heapBytes(*e);
+   usage.order = heapBytes(_order);
+   return usage;
+}
+
+/**
+   @return bytes used by all the containers
+*/
+unsigned long Graph::MemoryUsage::total() const {
+   return nodes + edges + weights + adjacency + components + order;
+}
+
+/**
+   Print the memory usage as JSON
+
+   @param  os ostream object
+   @return void
+*/
+void Graph::MemoryUsage::print(std::ostream& os) const {
+   os << "{\"nodes\": " << nodes << ", \"edges\": " << edges
+      << ", \"weights\": " << weights << ", \"adjacency\": " << adjacency
+      << ", \"components\": " << components << ", \"order\": " << order
+      << ", \"total\": " << total() << "}" << std::endl;
+}
+
+/**
+   Control if graph has negative weight, cached until the next change
+   of a weight
 
    @return bool
 */
 bool Graph::hasNegativeWeigth() const {
-   std::map<link, double>::const_iterator w;
+   return _memoize(_negativeCache, _version, [this]() { return _hasNegativeWeight(); });
+}
+
+/**
+   @return bool
+*/
+bool Graph::_hasNegativeWeight() const {
+   resourceMap<link, double>::const_iterator w;
    for(w = _edgeWeight.begin(); w != _edgeWeight.end(); ++w) {
       if(w->second < 0)
          return true;
@@ -408,14 +852,18 @@ void Graph::_generateJavascriptPage() const {
         << "return set; }" << std::endl;
 
    /** generate the nodes */
-   std::vector<std::string>::const_iterator v;
+   nodeList::const_iterator v;
    for(v = _node.begin(); v != _node.end(); ++v) {
+      if(!_alive(v))
+         continue;
       f_js << "g.addNode(\"" << *v << "\", {render:render});" << std::endl;
    }
 
    /** generate the edges */
-   std::vector<link>::const_iterator e;
+   linkList::const_iterator e;
    for(e = _edge.begin(); e != _edge.end(); ++e) {
+      if(!_alive(e))
+         continue;
       /** insert the weight into the javascript code */
       double w = weight(e->first, e->second);
 
@@ -451,17 +899,35 @@ void Graph::draw() const {
 }
 
 /** 
-   Time Complexity of this method is same as time complexity of DFS traversal which is O(V+E)
+   Time Complexity of this method is same as time complexity of DFS traversal which is O(V+E),
+   the answer is cached until the next change of the nodes or edges
 
    @return bool
 */
 bool Graph::isCyclic() const {
+   GRAPH_STAT_TIMER("isCyclic");
+   return _memoize(_cyclicCache, _topology, [this]() { return _isCyclic(); });
+}
+
+/**
+   @return bool
+*/
+bool Graph::_isCyclic() const {
+   /** directed graphs keep a topological order while they are acyclic */
+   if(direct) {
+      if(_orderStale)
+         return !_staleOrder()->acyclic;
+      return !_acyclic;
+   }
+
    /** Mark all the vertices as not visited and not part of recursion
        stack */
-   mapStringBool visited;
-   mapStringBool recStack;
-   std::vector<std::string>::const_iterator i;
+   mapStringBool visited(scratch());
+   mapStringBool recStack(scratch());
+   nodeList::const_iterator i;
    for(i = _node.begin(); i != _node.end(); ++i) {
+      if(!_alive(i))
+         continue;
       visited[*i] = false;
       recStack[*i] = false;
    }
@@ -469,7 +935,7 @@ bool Graph::isCyclic() const {
    /** Call the recursive helper function to detect cycle in different
        DFS trees */
    for(i = _node.begin(); i != _node.end(); ++i) {
-      if(_isCyclicUtil(*i, visited, recStack))
+      if(_alive(i) && _isCyclicUtil(*i, visited, recStack))
          return true;
    }
    return false;
@@ -487,7 +953,8 @@ bool Graph::_isCyclicUtil(std::string v, mapStringBool visited, mapStringBool re
       recStack[v]= true;
  
       /** Recur for all the vertices adjacent to this vertex */
-      for(auto i = adjacent(v).begin(); i != adjacent(v).end(); ++i) {
+      const nodeList& adj = _adjacent(v);
+      for(auto i = adj.begin(); i != adj.end(); ++i) {
          if(!visited[*i] && _isCyclicUtil(*i, visited, recStack))
             return true;
          else if(recStack[*i])
@@ -499,37 +966,509 @@ bool Graph::_isCyclicUtil(std::string v, mapStringBool visited, mapStringBool re
    return false;
 }
 
+/**
+   Would the edge (fromNode, toNode) close a cycle? In a directed graph
+   that is the case when fromNode is reachable from toNode; the search
+   only visits nodes placed before fromNode in the topological order, and
+   none at all when toNode already follows fromNode. In an undirected
+   graph an edge closes a cycle when its ends are already connected
+
+   @param  fromNode edge from node
+   @param  toNode   edge to node
+   @return bool
+*/
+bool Graph::wouldCreateCycle(std::string fromNode, std::string toNode) const {
+   GRAPH_STAT_TIMER("wouldCreateCycle");
+   if(fromNode == toNode)
+      return true;
+   if(!exist(fromNode) || !exist(toNode))
+      return false;
+   if(!direct)
+      return connected(fromNode, toNode);
+   /** a stale order is recomputed once per version and shared */
+   std::shared_ptr<const OrderLabels> labels;
+   if(_orderStale)
+      labels = _staleOrder();
+   const resourceMap<std::string, int>& order = labels ? labels->order : _order;
+   if(!(labels ? labels->acyclic : _acyclic))
+      return _reaches(toNode, fromNode, order, INT_MAX);
+   if(order.at(toNode) > order.at(fromNode))
+      return false;
+   return _reaches(toNode, fromNode, order, order.at(fromNode));
+}
+
+/**
+   @param  u first node
+   @param  v second node
+   @return u and v in the same (weakly) connected component?
+*/
+bool Graph::connected(std::string u, std::string v) const {
+   GRAPH_STAT_TIMER("connected");
+   if(!exist(u) || !exist(v))
+      return false;
+   if(_componentsStale) {
+      std::shared_ptr<const ComponentLabels> labels = _staleComponents();
+      return labels->root.at(u) == labels->root.at(v);
+   }
+   return _findComponent(u) == _findComponent(v);
+}
+
+/**
+   @return number of weakly connected components
+*/
+unsigned Graph::components() const {
+   GRAPH_STAT_TIMER("components");
+   if(_componentsStale)
+      return _staleComponents()->count;
+   return _components;
+}
+
+/**
+   Is there a path from fromNode to toNode? (every node reaches itself)
+   Undirected graphs ask the union-find. Directed graphs use the
+   reachability index when indexReachability() was called, rebuilding it
+   first if a change dropped it; otherwise a DFS, bounded by the
+   topological order when the graph is acyclic
+
+   @param  fromNode start of the path
+   @param  toNode   end of the path
+   @return bool
+*/
+bool Graph::reachable(std::string fromNode, std::string toNode) const {
+   GRAPH_STAT_TIMER("reachable");
+   if(!exist(fromNode) || !exist(toNode))
+      return false;
+   if(fromNode == toNode)
+      return true;
+   if(!direct)
+      return connected(fromNode, toNode);
+   bool ordered = _acyclic && !_orderStale;
+   if(ordered && _order.at(toNode) < _order.at(fromNode))
+      return false;
+   if(_reachTraversals == 0) {
+      if(_orderStale) {
+         std::shared_ptr<const OrderLabels> labels = _staleOrder();
+         if(labels->acyclic && labels->order.at(toNode) < labels->order.at(fromNode))
+            return false;
+         return _reaches(fromNode, toNode, labels->order,
+                         labels->acyclic ? labels->order.at(toNode) : INT_MAX);
+      }
+      return _reaches(fromNode, toNode, _order, ordered ? _order.at(toNode) : INT_MAX);
+   }
+
+   std::shared_ptr<const ReachabilityIndex> index = std::atomic_load(&_reachability);
+   if(!index) {
+      std::lock_guard<std::mutex> lock(_reachabilityLock);
+      index = std::atomic_load(&_reachability);
+      if(!index) {
+         index = std::make_shared<const ReachabilityIndex>(*this, _reachTraversals,
+                                                           _reachClosureLimit);
+         std::atomic_store(&_reachability, index);
+      }
+   }
+   return index->reachable(fromNode, toNode);
+}
+
+/**
+   Build a reachability index answering reachable() from now on. It is
+   kept across the insertions that add no new path, the edge removals a
+   path goes around and the removals of sources and sinks, and rebuilt by
+   the first query after any other change
+
+   @param  traversals   interval labels per component (more memory, fewer
+                        DFS fallbacks); 0 drops the index
+   @param  closureLimit condensations up to this many components get
+                        transitive closure bitsets (closureLimit^2 / 8 bytes)
+   @return void
+*/
+void Graph::indexReachability(unsigned traversals, unsigned closureLimit) {
+   _reachTraversals = traversals;
+   _reachClosureLimit = closureLimit;
+   _dropReachability();
+   if(traversals > 0 && direct) {
+      std::atomic_store(&_reachability, std::shared_ptr<const ReachabilityIndex>(
+                           std::make_shared<const ReachabilityIndex>(*this, traversals,
+                                                                     closureLimit)));
+   }
+}
+
+/**
+   Forget the reachability index, the next reachable() rebuilds it
+
+   @return void
+*/
+void Graph::_dropReachability() {
+   std::atomic_store(&_reachability, std::shared_ptr<const ReachabilityIndex>());
+}
+
+/**
+   Depth first search from fromNode looking for toNode, skipping the nodes
+   whose topological order is greater than bound
+
+   @return bool
+*/
+bool Graph::_reaches(std::string fromNode, std::string toNode,
+                     const resourceMap<std::string, int>& order, int bound) const {
+   nodeSet visited(scratch());
+   nodeList stack(1, fromNode, scratch());
+   visited.insert(fromNode);
+   while(!stack.empty()) {
+      std::string v = stack.back();
+      stack.pop_back();
+      if(v == toNode)
+         return true;
+      auto s = _successors.find(v);
+      if(s == _successors.end())
+         continue;
+      for(auto w = s->second.begin(); w != s->second.end(); ++w) {
+         if(order.at(*w) <= bound && visited.insert(*w).second)
+            stack.push_back(*w);
+      }
+   }
+   return false;
+}
+
+/**
+   Does fromNode still reach toNode after an edge removal? A breadth first
+   search from both ends, expanding the smaller frontier, that only enters
+   the nodes the index (built before the removal) puts on a path between
+   them: inside a large strongly connected component the two searches
+   meet long before either covers it
+
+   @param  index reachability before the removal, no path is added since
+   @return bool
+*/
+bool Graph::_reachesWithout(const std::string& fromNode, const std::string& toNode,
+                            const ReachabilityIndex& index) const {
+   if(fromNode == toNode)
+      return true;
+   nodeSet seen[2] = { nodeSet(scratch()), nodeSet(scratch()) };
+   nodeList frontier[2] = { nodeList(1, fromNode, scratch()), nodeList(1, toNode, scratch()) };
+   nodeList next(scratch());
+   seen[0].insert(fromNode);
+   seen[1].insert(toNode);
+   while(!frontier[0].empty() && !frontier[1].empty()) {
+      /** forward along the successors, backward along the predecessors */
+      int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+      const adjacencyMap& adjacency = side == 0 ? _successors : _predecessors;
+      next.clear();
+      for(auto v = frontier[side].begin(); v != frontier[side].end(); ++v) {
+         auto a = adjacency.find(*v);
+         if(a == adjacency.end())
+            continue;
+         for(auto w = a->second.begin(); w != a->second.end(); ++w) {
+            if(seen[1 - side].count(*w))
+               return true;
+            bool between = side == 0 ? index.reachable(*w, toNode) : index.reachable(fromNode, *w);
+            if(between && seen[side].insert(*w).second)
+               next.push_back(*w);
+         }
+      }
+      frontier[side].swap(next);
+   }
+   return false;
+}
+
+/**
+   Root of the component of v. Union by size keeps the trees shallow,
+   so no path compression is needed (and const readers never write)
+
+   @return std::string
+*/
+std::string Graph::_findComponent(std::string v) const {
+   resourceMap<std::string, std::string>::const_iterator p = _parent.find(v);
+   while(p->second != p->first)
+      p = _parent.find(p->second);
+   return p->first;
+}
+
+/**
+   Merge the components of fromNode and toNode, recording the edge in the
+   spanning forest when it joins two components
+
+   @return void
+*/
+void Graph::_unionComponents(std::string fromNode, std::string toNode) {
+   std::string a = _findComponent(fromNode);
+   std::string b = _findComponent(toNode);
+   if(a == b)
+      return;
+   if(_componentSize[a] < _componentSize[b])
+      std::swap(a, b);
+   _parent[b] = a;
+   _componentSize[a] += _componentSize[b];
+   _forest.insert(std::make_pair(fromNode, toNode));
+   --_components;
+}
+
+/**
+   Recompute the components from scratch, deferred until needed after
+   an edge of the spanning forest is removed
+
+   @return void
+*/
+void Graph::_rebuildComponents() {
+   resourceMap<std::string, std::string> root(scratch());
+   _components = _spanningForest(root, _forest);
+   for(auto v = root.begin(); v != root.end(); ++v) {
+      _parent[v->first] = v->second;
+      _componentSize[v->first] = 0;
+   }
+   for(auto v = root.begin(); v != root.end(); ++v)
+      ++_componentSize[v->second];
+   _componentsStale = false;
+}
+
+/**
+   Components while the union-find is stale, shared by the const readers
+   until the next change of the nodes or edges
+
+   @return ComponentLabels
+*/
+std::shared_ptr<const Graph::ComponentLabels> Graph::_staleComponents() const {
+   return _memoize(_componentLabels, _topology, [this]() {
+      std::shared_ptr<ComponentLabels> labels = std::make_shared<ComponentLabels>();
+      linkSet forest(scratch());
+      labels->count = _spanningForest(labels->root, forest);
+      return std::shared_ptr<const ComponentLabels>(labels);
+   });
+}
+
+/**
+   Topological order while _order is stale, shared by the const readers
+   until the next change of the nodes or edges
+
+   @return OrderLabels
+*/
+std::shared_ptr<const Graph::OrderLabels> Graph::_staleOrder() const {
+   return _memoize(_orderLabels, _topology, [this]() {
+      std::shared_ptr<OrderLabels> labels = std::make_shared<OrderLabels>();
+      labels->acyclic = _topologicalOrder(labels->order);
+      return std::shared_ptr<const OrderLabels>(labels);
+   });
+}
+
+/**
+   Constructor, the labels outlive any scratch pool
+*/
+Graph::ComponentLabels::ComponentLabels()
+   : root(ResourceAllocator<char>(newDeleteResource())), count(0) {
+}
+
+/**
+   Constructor, the labels outlive any scratch pool
+*/
+Graph::OrderLabels::OrderLabels()
+   : order(ResourceAllocator<char>(newDeleteResource())), acyclic(true) {
+}
+
+/**
+   Label every node with a representative of its (weakly) connected
+   component, collecting the traversal tree edges as spanning forest
+
+   @param  root   node -> representative of its component
+   @param  forest edges of the spanning forest
+   @return number of components
+*/
+unsigned Graph::_spanningForest(resourceMap<std::string, std::string>& root,
+                                linkSet& forest) const {
+   root.clear();
+   forest.clear();
+   unsigned count = 0;
+   for(auto v = _parent.begin(); v != _parent.end(); ++v) {
+      if(root.find(v->first) != root.end())
+         continue;
+      ++count;
+      root[v->first] = v->first;
+      nodeList stack(1, v->first, scratch());
+      while(!stack.empty()) {
+         std::string x = stack.back();
+         stack.pop_back();
+         auto succ = _successors.find(x);
+         if(succ != _successors.end()) {
+            for(auto w = succ->second.begin(); w != succ->second.end(); ++w) {
+               if(root.insert(std::make_pair(*w, v->first)).second) {
+                  forest.insert(std::make_pair(x, *w));
+                  stack.push_back(*w);
+               }
+            }
+         }
+         auto pred = _predecessors.find(x);
+         if(pred != _predecessors.end()) {
+            for(auto w = pred->second.begin(); w != pred->second.end(); ++w) {
+               if(root.insert(std::make_pair(*w, v->first)).second) {
+                  forest.insert(std::make_pair(*w, x));
+                  stack.push_back(*w);
+               }
+            }
+         }
+      }
+   }
+   return count;
+}
+
+/**
+   Pearce-Kelly: restore the topological order after adding the edge
+   (fromNode, toNode). Only the nodes whose order lies between the two
+   ends are visited and shuffled
+
+   @return false if the edge closes a cycle
+*/
+bool Graph::_reorder(std::string fromNode, std::string toNode) {
+   int lower = _order[toNode];
+   int upper = _order[fromNode];
+   if(fromNode == toNode)
+      return false;
+   if(lower > upper)
+      return true;
+
+   /** nodes reachable from toNode that must move after fromNode */
+   nodeList forward(scratch());
+   nodeSet visited(scratch());
+   nodeList stack(1, toNode, scratch());
+   visited.insert(toNode);
+   while(!stack.empty()) {
+      std::string v = stack.back();
+      stack.pop_back();
+      forward.push_back(v);
+      const nodeList& succ = _adjacent(v);
+      for(auto w = succ.begin(); w != succ.end(); ++w) {
+         if(*w == fromNode)
+            return false;
+         if(_order[*w] < upper && visited.insert(*w).second)
+            stack.push_back(*w);
+      }
+   }
+
+   /** nodes reaching fromNode that must move before toNode */
+   nodeList backward(scratch());
+   stack.assign(1, fromNode);
+   visited.insert(fromNode);
+   while(!stack.empty()) {
+      std::string v = stack.back();
+      stack.pop_back();
+      backward.push_back(v);
+      nodeList& pred = _predecessors[v];
+      for(auto w = pred.begin(); w != pred.end(); ++w) {
+         if(_order[*w] > lower && visited.insert(*w).second)
+            stack.push_back(*w);
+      }
+   }
+
+   /** reuse the same order slots: backward nodes first, then forward */
+   auto byOrder = [this](const std::string& a, const std::string& b) {
+      return _order[a] < _order[b];
+   };
+   std::sort(forward.begin(), forward.end(), byOrder);
+   std::sort(backward.begin(), backward.end(), byOrder);
+   std::vector<int, ResourceAllocator<int> > slots(scratch());
+   for(auto v = backward.begin(); v != backward.end(); ++v)
+      slots.push_back(_order[*v]);
+   for(auto v = forward.begin(); v != forward.end(); ++v)
+      slots.push_back(_order[*v]);
+   std::sort(slots.begin(), slots.end());
+
+   auto slot = slots.begin();
+   for(auto v = backward.begin(); v != backward.end(); ++v)
+      _order[*v] = *slot++;
+   for(auto v = forward.begin(); v != forward.end(); ++v)
+      _order[*v] = *slot++;
+   return true;
+}
+
+/**
+   Recompute the topological order from scratch, deferred until needed
+   after an edge is removed from a cyclic graph
+
+   @return void
+*/
+void Graph::_rebuildOrder() {
+   _acyclic = _topologicalOrder(_order);
+   _nextOrder = _order.size();
+   _orderStale = false;
+}
+
+/**
+   Topological sort (Kahn's algorithm). Nodes left on a cycle are placed
+   after the sorted ones so that every node has a slot
+
+   @param  order node -> position
+   @return false if the graph is cyclic
+*/
+bool Graph::_topologicalOrder(resourceMap<std::string, int>& order) const {
+   resourceMap<std::string, unsigned> inDegree(scratch());
+   nodeList ready(scratch());
+   for(auto v = _parent.begin(); v != _parent.end(); ++v) {
+      auto pred = _predecessors.find(v->first);
+      inDegree[v->first] = pred != _predecessors.end() ? pred->second.size() : 0;
+      if(inDegree[v->first] == 0)
+         ready.push_back(v->first);
+   }
+
+   int next = 0;
+   order.clear();
+   while(!ready.empty()) {
+      std::string v = ready.back();
+      ready.pop_back();
+      order[v] = next++;
+      auto succ = _successors.find(v);
+      if(succ == _successors.end())
+         continue;
+      for(auto w = succ->second.begin(); w != succ->second.end(); ++w) {
+         if(--inDegree[*w] == 0)
+            ready.push_back(*w);
+      }
+   }
+
+   bool acyclic = order.size() == _parent.size();
+   for(auto v = inDegree.begin(); v != inDegree.end(); ++v) {
+      if(v->second > 0)
+         order[v->first] = next++;
+   }
+   return acyclic;
+}
+
 /** 
    Graph Coloring (Greedy Algorithm) :- FIXED By Wyvilo
    Assigns colors (starting from 0) to all vertices and prints
-   the assignment of colors
+   the assignment of colors. The graph is read as undirected (an edge
+   in either direction makes two vertices adjacent) without modifying it,
+   so coloring is safe on a shared, read-only Graph
 
    @return void
 */
-void Graph::coloring() {
-   Graph Gt = this->transpose();
-
-   /** remove common edges */
-   for(auto e = this->_edge.begin(); e != this->_edge.end(); ++e)
-      Gt.removeEdge(e->first, e->second);
-
-   /** temporaly turn graph into undirected (if not) */
-   for(auto e = this->_edge.begin(); e != this->_edge.end(); ++e)
-      this->addEdge(e->first, e->second, 1);
+void Graph::coloring() const {
+   GRAPH_STAT_TIMER("coloring");
+   /** undirected view of the graph: successors and predecessors */
+   resourceMap<std::string, nodeList> neighbours(scratch());
+   for(auto e = _edge.begin(); e != _edge.end(); ++e) {
+      if(!_alive(e))
+         continue;
+      neighbours[e->first].push_back(e->second);
+      neighbours[e->second].push_back(e->first);
+   }
 
-   std::map<std::string, int> result;
+   resourceMap<std::string, int> result(scratch());
+   auto first = _node.begin();
+   while(first != _node.end() && !_alive(first))
+      ++first;
+   if(first == _node.end())
+      return;
    /** Assign the first color to first vertex */
-   result[*(_node.begin())] = 0;
+   result[*first] = 0;
 
    /** Initialize remaining V-1 vertices as unassigned */
-   for(auto u = _node.begin() + 1; u != _node.end(); ++u)
-      result[*u] = -1;  // no color is assigned to u
+   for(auto u = first + 1; u != _node.end(); ++u)
+      if(_alive(u))
+         result[*u] = -1;  // no color is assigned to u
  
    /** Assign colors to remaining V-1 vertices */
-   for(auto u = _node.begin() + 1; u != _node.end(); ++u) {   
+   for(auto u = first + 1; u != _node.end(); ++u) {   
+      if(!_alive(u))
+         continue;
       /** Process all adjacent vertices and flag their colors
           as unavailable */
-      std::list<std::string> adj = adjacent(*u); 
+      const nodeList& adj = neighbours[*u]; 
       
       signed color = -1;
       bool found = false;
@@ -549,10 +1488,8 @@ void Graph::coloring() {
  
    /** print the result */
    for(auto u = _node.begin(); u != _node.end(); ++u) 
-      std::cout << "Vertex " << *u << " --->  Color " << result[*u] << std::endl;
-
-   for(auto e = Gt._edge.begin(); e != Gt._edge.end(); ++e)
-      this->removeEdge(e->first, e->second);   
+      if(_alive(u))
+         std::cout << "Vertex " << *u << " --->  Color " << result[*u] << std::endl;
 }
 
 /**
@@ -564,8 +1501,10 @@ void Graph::_DFSUtil(std::string v, mapStringBool& visited) const {
    /** Mark the current node as visited and print it */
    visited[v] = true;
    /** Recur for all the vertices adjacent to this vertex */
-   std::list<std::string>::iterator i;
-   std::list<std::string> adj = adjacent(v);
+   nodeList::const_iterator i;
+   const nodeList& adj = _adjacent(v);
+   GRAPH_STAT_COUNT("isConnected", nodesVisited, 1);
+   GRAPH_STAT_COUNT("isConnected", edgesScanned, adj.size());
    for(i = adj.begin(); i != adj.end(); ++i)
       if(!visited[*i]) 
          _DFSUtil(*i, visited);
@@ -577,8 +1516,10 @@ void Graph::_DFSUtil2(std::string v, mapStringBool& visited) const {
    std::cout << v << " ";
  
    /** Recur for all the vertices adjacent to this vertex */
-   std::list<std::string>::iterator i;
-   std::list<std::string> adj = adjacent(v);
+   nodeList::const_iterator i;
+   const nodeList& adj = _adjacent(v);
+   GRAPH_STAT_COUNT("DFS", nodesVisited, 1);
+   GRAPH_STAT_COUNT("DFS", edgesScanned, adj.size());
    for(i = adj.begin(); i != adj.end(); ++i)
       if(!visited[*i]) 
          _DFSUtil2(*i, visited);
@@ -587,11 +1528,13 @@ void Graph::_DFSUtil2(std::string v, mapStringBool& visited) const {
 /** 
    DFS traversal of the vertices reachable from v. It uses recursive _DFSUtil()
 */
-void Graph::DFS(std::string sourceNode) {
+void Graph::DFS(std::string sourceNode) const {
+   GRAPH_STAT_TIMER("DFS");
    /** Mark all the vertices as not visited */
-   mapStringBool visited;
+   mapStringBool visited(scratch());
    for(auto u = _node.begin(); u != _node.end(); ++u) 
-      visited[*u] = false;
+      if(_alive(u))
+         visited[*u] = false;
  
    // Call the recursive helper function to print DFS traversal
    _DFSUtil2(sourceNode, visited);
@@ -600,22 +1543,21 @@ void Graph::DFS(std::string sourceNode) {
 /**
    Breadth First Traversal for a Graph
 */
-void Graph::BFS(std::string sourceNode) {
+void Graph::BFS(std::string sourceNode) const {
+   GRAPH_STAT_TIMER("BFS");
    /** Mark all the vertices as not visited */
-   mapStringBool visited;
+   mapStringBool visited(scratch());
    for(auto u = _node.begin(); u != _node.end(); ++u) 
-      visited[*u] = false;
+      if(_alive(u))
+         visited[*u] = false;
  
    /** Create a queue for BFS */
-   std::list<std::string> queue;
+   nodeQueue queue(scratch());
  
    /** Mark the current node as visited and enqueue it */
    visited[sourceNode] = true;
    queue.push_back(sourceNode);
  
-   /** 'i' will be used to get all adjacent vertices of a vertex */
-   std::list<std::string>::iterator i;
- 
    while(!queue.empty()) {
       /** Dequeue a vertex from queue and print it */
       sourceNode = queue.front();
@@ -625,8 +1567,10 @@ void Graph::BFS(std::string sourceNode) {
       /** Get all adjacent vertices of the dequeued vertex s
           If a adjacent has not been visited, then mark it visited
           and enqueue it */
-      std::list<std::string>::iterator i;
-      std::list<std::string> adj = adjacent(sourceNode);
+      nodeList::const_iterator i;
+      const nodeList& adj = _adjacent(sourceNode);
+      GRAPH_STAT_COUNT("BFS", nodesVisited, 1);
+      GRAPH_STAT_COUNT("BFS", edgesScanned, adj.size());
       for(i = adj.begin(); i != adj.end(); ++i) {
          if(!visited[*i]) {
             visited[*i] = true;
@@ -638,21 +1582,53 @@ void Graph::BFS(std::string sourceNode) {
 
 /** 
    Method to check if all non-zero degree vertices are connected.
-   It mainly does DFS traversal starting from
+   It mainly does DFS traversal starting from, the answer is cached until
+   the next change of the nodes or edges
 
    @return bool
 */
 bool Graph::isConnected() const {
+   GRAPH_STAT_TIMER("isConnected");
+   return _memoize(_connectedCache, _topology, [this]() { return _isConnected(); });
+}
+
+/**
+   @return bool
+*/
+bool Graph::_isConnected() const {
+   /** undirected graphs: every node with edges in the same component */
+   if(!direct) {
+      std::shared_ptr<const ComponentLabels> labels;
+      if(_componentsStale)
+         labels = _staleComponents();
+
+      std::string root;
+      for(auto v = _node.begin(); v != _node.end(); ++v) {
+         if(!_alive(v) || rank(*v) == 0)
+            continue;
+         std::string r = labels ? labels->root.at(*v) : _findComponent(*v);
+         if(root.empty())
+            root = r;
+         else if(r != root)
+            return false;
+      }
+      return true;
+   }
+
    /** Mark all the vertices as not visited */
-   std::map<std::string, bool> visited;
-   std::vector<std::string>::const_iterator u;
+   mapStringBool visited(scratch());
+   nodeList::const_iterator u;
    for(u = _node.begin(); u != _node.end(); ++u) 
-      visited[*u] = false;
+      if(_alive(u))
+         visited[*u] = false;
  
    /** Find a vertex with non-zero degree */
    for(u = _node.begin(); u != _node.end(); ++u)
-      if(adjacent(*u).size() != 0)
+      if(_alive(u) && rank(*u) != 0)
          break;
+   /** no edge at all */
+   if(u == _node.end())
+      return true;
    std::string strU = *u;
    unsigned lastNode = atoi(strU.c_str());
    /** If there are no edges in the graph, return true */
@@ -664,7 +1640,7 @@ bool Graph::isConnected() const {
  
    /** Check if all non-zero degree vertices are visited */
    for(auto v = _node.begin(); v != _node.end(); ++v)
-      if(visited[*v] == false && adjacent(*v).size() > 0) 
+      if(_alive(v) && visited[*v] == false && rank(*v) > 0) 
          return false;
    return true;
 }
@@ -678,6 +1654,7 @@ bool Graph::isConnected() const {
    @return integer
 */
 int Graph::isEulerian() const {
+   GRAPH_STAT_TIMER("isEulerian");
    /** Check if all non-zero degree vertices are connected */
    if(isConnected() == false) {
       std::cout << "not connected" <<std::endl;
@@ -685,10 +1662,13 @@ int Graph::isEulerian() const {
     }
  
    /** Count vertices with odd degree */
-   int odd = 0;
-   for(auto v = _node.begin(); v != _node.end(); ++v)
-      if(adjacent(*v).size() & 1)
-         odd++;
+   unsigned odd = _memoize(_oddCache, _topology, [this]() {
+      unsigned count = 0;
+      for(auto v = _node.begin(); v != _node.end(); ++v)
+         if(_alive(v) && (rank(*v) & 1))
+            count++;
+      return count;
+   });
  
    /** If count is more than 2, then graph is not Eulerian */
    if(odd > 2)
@@ -703,7 +1683,7 @@ int Graph::isEulerian() const {
 /** 
    Convert adjacent list into a matrix
 */
-int** Graph::fromListADJToMatrixADJ() {
+int** Graph::fromListADJToMatrixADJ() const {
    /** matrix allocation */
    int** ADJMatrix = new int*[nodes()];
    for(unsigned i = 0; i < nodes(); ++i)
@@ -712,11 +1692,14 @@ int** Graph::fromListADJToMatrixADJ() {
    /** initialize matrix */
    for(auto i = _node.begin(); i != _node.end(); ++i)
       for(auto j = _node.begin(); j != _node.end(); ++j) 
-         ADJMatrix[atoi((*j).c_str())][atoi((*i).c_str())] = 0;
+         if(_alive(i) && _alive(j))
+            ADJMatrix[atoi((*j).c_str())][atoi((*i).c_str())] = 0;
 
    for(auto j = _node.begin(); j != _node.end(); ++j) {
-      std::list<std::string>::iterator k;
-      std::list<std::string> adj = adjacent(*j);
+      if(!_alive(j))
+         continue;
+      nodeList::const_iterator k;
+      const nodeList& adj = _adjacent(*j);
       for(k = adj.begin(); k != adj.end(); ++k) {
          if(direct)  
             ADJMatrix[atoi((*k).c_str())][atoi((*j).c_str())] = 1;
@@ -734,7 +1717,7 @@ int** Graph::fromListADJToMatrixADJ() {
   @return matrix of edge's weight
 */
 
-double** Graph::weightMatrix() {
+double** Graph::weightMatrix() const {
    /** matrix allocation */
    int i, j, k;
    double** wMatrix = new double*[nodes()];
@@ -743,8 +1726,12 @@ double** Graph::weightMatrix() {
 
     /** initialize matrix */
    for(auto ii = _node.begin(); ii != _node.end(); ++ii) {
+      if(!_alive(ii))
+         continue;
       i = atoi((*ii).c_str());
       for(auto jj = _node.begin(); jj != _node.end(); ++jj) {
+         if(!_alive(jj))
+            continue;
          j = atoi((*jj).c_str());
          if(*ii == *jj)
             wMatrix[j][i] = 0;
@@ -754,9 +1741,11 @@ double** Graph::weightMatrix() {
    }
 
    for(auto jj = _node.begin(); jj != _node.end(); ++jj) {
+      if(!_alive(jj))
+         continue;
       j = atoi((*jj).c_str());
-      std::list<std::string>::iterator kk;
-      std::list<std::string> adj = adjacent(*jj);
+      nodeList::const_iterator kk;
+      const nodeList& adj = _adjacent(*jj);
 
       for(kk = adj.begin(); kk != adj.end(); ++kk) {
          k = atoi((*kk).c_str());
@@ -773,25 +1762,32 @@ double** Graph::weightMatrix() {
 }
 
 /** 
-   Solves the all-pairs shortest path problem using Floyd Warshall algorithm
+   Solves the all-pairs shortest path problem using Floyd Warshall algorithm.
+   The rows are independent within a phase k: they are split over the
+   threads of the pool, row k being read from a copy
+
+   @param  graph   weight matrix, indexed by the node names as numbers
+   @param  threads worker threads, 0 = all of the pool
 */
-void Graph::floydWarshell(double** graph) {
+void Graph::floydWarshell(double** graph, unsigned threads) const {
+   GRAPH_STAT_TIMER("floydWarshell");
    /** dist[][] will be the output matrix that will finally have the shortest
        distances between every pair of vertices */
-   int i, j, k;
    int** dist = new int*[nodes()];
    for(unsigned i = 0; i < nodes(); ++i)
       dist[i] = new int[nodes()];
+   /** the node names as matrix indices, parsed once */
+   std::vector<int> index;
+   for(auto u = _node.begin(); u != _node.end(); ++u)
+      if(_alive(u))
+         index.push_back(atoi((*u).c_str()));
  
    /** Initialize the solution matrix same as input graph matrix. Or
        we can say the initial values of shortest distances are based
        on shortest paths considering no intermediate vertex. */
-   for(auto ii = _node.begin(); ii != _node.end(); ++ii) {
-      i = atoi((*ii).c_str());
-      for(auto jj = _node.begin(); jj != _node.end(); ++jj) {
-         j = atoi((*jj).c_str());
-         dist[i][j] = graph[i][j];
-      }
+   for(auto i = index.begin(); i != index.end(); ++i) {
+      for(auto j = index.begin(); j != index.end(); ++j)
+         dist[*i][*j] = graph[*i][*j];
    }
  
    /** Add all vertices one by one to the set of intermediate vertices.
@@ -800,37 +1796,50 @@ void Graph::floydWarshell(double** graph) {
        vertices in set {0, 1, 2, .. k-1} as intermediate vertices.
        ----> After the end of a iteration, vertex no. k is added to the set of
        intermediate vertices and the set becomes {0, 1, 2, .. k} */
-   for(auto kk = _node.begin(); kk != _node.end(); ++kk) {
-      /** Pick all vertices as source one by one */
-      k = atoi((*kk).c_str());
-      for(auto ii = _node.begin(); ii != _node.end(); ++ii) {
-         /** Pick all vertices as destination for the
-             above picked source */
-         i = atoi((*ii).c_str());
-         for(auto jj = _node.begin(); jj != _node.end(); ++jj) {
+   std::vector<int> row(nodes());
+   bool stopped = false;
+   for(auto kk = index.begin(); kk != index.end(); ++kk) {
+      if(parallel::stopping()) {
+         stopped = true;
+         break;
+      }
+      int k = *kk;
+      for(auto j = index.begin(); j != index.end(); ++j)
+         row[*j] = dist[k][*j];
+      /** Pick all vertices as source, each thread a range of them */
+      parallel::forRange(0, index.size(), threads, 64,
+                         [&](std::size_t from, std::size_t to, unsigned) {
+         for(std::size_t ii = from; ii < to; ++ii) {
+            int i = index[ii];
             /** If vertex k is on the shortest path from
                 i to j, then update the value of dist[i][j] */
-            j = atoi((*jj).c_str());
-            if(dist[i][k] + dist[k][j] < dist[i][j])
-               dist[i][j] = dist[i][k] + dist[k][j];
+            for(auto j = index.begin(); j != index.end(); ++j) {
+               if(dist[i][k] + row[*j] < dist[i][*j])
+                  dist[i][*j] = dist[i][k] + row[*j];
+            }
          }
-      }
+      });
    }
  
-   // Print the shortest distance matrix
-   _printSolutionFloydWarshell(dist);
+   // Print the shortest distance matrix, unless the scope stopped us
+   if(!stopped)
+      _printSolutionFloydWarshell(dist);
 }
 
 /** 
    A utility function to print solution 
 */
-void Graph::_printSolutionFloydWarshell(int** dist) {
+void Graph::_printSolutionFloydWarshell(int** dist) const {
    std::cout << "Following matrix shows the shortest distances" 
              << std::endl << " between every pair of vertices \n";
    int i, j;
    for(auto ii = _node.begin(); ii != _node.end(); ++ii) {
+      if(!_alive(ii))
+         continue;
       i = atoi((*ii).c_str());
       for(auto jj = _node.begin(); jj != _node.end(); ++jj) {
+         if(!_alive(jj))
+            continue;
          j = atoi((*jj).c_str());
          if(dist[i][j] == INF)
             std::cout <<  "INF\t";
@@ -839,4 +1848,303 @@ void Graph::_printSolutionFloydWarshell(int** dist) {
       }
       std::cout << std::endl;
    }
-}
\ No newline at end of file
+}
+
+/**
+   @return compressed sparse row copy of the graph
+*/
+CompactGraph Graph::compact() const {
+   return CompactGraph(*this);
+}
+
+/**
+   PageRank of every node, using the edge weights as transition weights;
+   see CompactGraph::personalizedPageRank
+
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node
+*/
+std::map<std::string, double> Graph::pageRank(double damping, double tolerance,
+                                              unsigned maxIterations, unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<double> rank = C.pageRank(damping, tolerance, maxIterations, threads);
+   std::map<std::string, double> result;
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      result[C.name(v)] = rank[v];
+   return result;
+}
+
+/**
+   PageRank restarting from the seeds (in proportion to their value)
+
+   @param  seeds         eg. {a = 1, b = 2}
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node
+*/
+std::map<std::string, double> Graph::personalizedPageRank(const std::map<std::string, double>& seeds,
+                                                          double damping, double tolerance,
+                                                          unsigned maxIterations,
+                                                          unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<double> teleport(C.nodes(), 0);
+   for(auto s = seeds.begin(); s != seeds.end(); ++s) {
+      if(C.id(s->first) < C.nodes())
+         teleport[C.id(s->first)] = s->second;
+   }
+   std::vector<double> rank = C.personalizedPageRank(teleport, damping, tolerance,
+                                                     maxIterations, threads);
+   std::map<std::string, double> result;
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      result[C.name(v)] = rank[v];
+   return result;
+}
+
+/**
+   Approximate personalized PageRank of source by local pushes; only the
+   nodes that received some rank are returned
+
+   @param  source  seed node
+   @param  alpha   restart probability (1 - damping)
+   @param  epsilon residual tolerance
+   @return approximate rank of the nodes around source
+*/
+std::map<std::string, double> Graph::approximatePageRank(std::string source, double alpha,
+                                                         double epsilon) const {
+   CompactGraph C(*this);
+   std::map<unsigned, double> rank = C.approximatePageRank(C.id(source), alpha, epsilon);
+   std::map<std::string, double> result;
+   for(auto r = rank.begin(); r != rank.end(); ++r)
+      result[C.name(r->first)] = r->second;
+   return result;
+}
+
+/**
+   Number of triangles, edge directions ignored; see CompactGraph::triangles
+
+   @param  threads worker threads, 0 = all cores
+   @return unsigned long
+*/
+unsigned long Graph::triangles(unsigned threads) const {
+   return CompactGraph(*this).triangles(threads);
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return number of triangles through every node
+*/
+std::map<std::string, unsigned long> Graph::triangleCount(unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<unsigned long> count = C.triangleCount(threads);
+   std::map<std::string, unsigned long> result;
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      result[C.name(v)] = count[v];
+   return result;
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return local clustering coefficient of every node
+*/
+std::map<std::string, double> Graph::clusteringCoefficient(unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<double> coefficient = C.clusteringCoefficient(threads);
+   std::map<std::string, double> result;
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      result[C.name(v)] = coefficient[v];
+   return result;
+}
+
+/**
+   @param  k truss order: every edge kept lies on at least k - 2 triangles
+   @return edges of the k-truss, eg. {<a, b>, <b, c>, ...}
+*/
+std::list<std::pair<std::string, std::string> > Graph::kTruss(unsigned k) const {
+   CompactGraph C(*this);
+   std::vector<std::pair<unsigned, unsigned> > truss = C.kTruss(k);
+   std::list<std::pair<std::string, std::string> > result;
+   for(auto e = truss.begin(); e != truss.end(); ++e)
+      result.push_back(std::make_pair(C.name(e->first), C.name(e->second)));
+   return result;
+}
+
+/**
+   Minimum spanning forest, edge directions ignored; see
+   CompactGraph::minimumSpanningForest
+
+   @param  method  Graph::kruskal or Graph::boruvka
+   @param  threads worker threads, 0 = all cores
+   @return SpanningForest
+*/
+Graph::SpanningForest Graph::minimumSpanningForest(int method, unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<std::pair<unsigned, unsigned> > forest;
+   SpanningForest result;
+   result.weight = C.minimumSpanningForest(forest, method, threads);
+   for(auto e = forest.begin(); e != forest.end(); ++e)
+      result.edges.push_back(std::make_pair(C.name(e->first), C.name(e->second)));
+   return result;
+}
+
+/**
+   Maximum flow from source to sink, edge weights as capacities; see
+   CompactGraph::maxFlow
+
+   @param  source node the flow leaves from
+   @param  sink   node the flow arrives to
+   @return value of the flow, 0 if a node doesn't exist
+*/
+double Graph::maxFlow(std::string source, std::string sink) const {
+   CompactGraph C(*this);
+   return C.maxFlow(C.id(source), C.id(sink));
+}
+
+/**
+   Minimum cut between source and sink: its capacity equals maxFlow()
+
+   @param  source node the flow leaves from
+   @param  sink   node the flow arrives to
+   @return Cut
+*/
+Graph::Cut Graph::minCut(std::string source, std::string sink) const {
+   CompactGraph C(*this);
+   std::vector<char> side;
+   Cut cut;
+   cut.capacity = C.minCut(C.id(source), C.id(sink), side);
+   for(unsigned v = 0; v < C.nodes(); ++v) {
+      if(!side[v])
+         continue;
+      cut.sourceSide.push_back(C.name(v));
+      for(unsigned long e = C.begin(v); e < C.end(v); ++e) {
+         if(!side[C.target(e)] && C.weight(e) > 0)
+            cut.edges.push_back(std::make_pair(C.name(v), C.name(C.target(e))));
+      }
+   }
+   return cut;
+}
+
+/**
+   Betweenness centrality of every node; see CompactGraph::betweenness
+
+   @param  weighted shortest paths by edge weight instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @return betweenness of every node
+*/
+std::map<std::string, double> Graph::betweenness(bool weighted, unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<double> centrality = C.betweenness(weighted, threads);
+   std::map<std::string, double> result;
+   /** empty when stopped by the scope */
+   for(unsigned v = 0; v < centrality.size(); ++v)
+      result[C.name(v)] = centrality[v];
+   return result;
+}
+
+/**
+   Betweenness estimated from a sample of sources; see
+   CompactGraph::approximateBetweenness
+
+   @param  epsilon  error bound on the normalized betweenness
+   @param  delta    probability that some node exceeds the bound
+   @param  weighted shortest paths by edge weight instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @return estimated betweenness of every node
+*/
+std::map<std::string, double> Graph::approximateBetweenness(double epsilon, double delta,
+                                                            bool weighted,
+                                                            unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<double> centrality = C.approximateBetweenness(epsilon, delta, weighted, threads);
+   std::map<std::string, double> result;
+   /** empty when stopped by the scope */
+   for(unsigned v = 0; v < centrality.size(); ++v)
+      result[C.name(v)] = centrality[v];
+   return result;
+}
+
+/**
+   Core number of every node, edge directions ignored; see
+   CompactGraph::coreNumbers
+
+   @param  threads 1 = bucket algorithm, otherwise parallel peeling
+                   (0 = all cores)
+   @return core number of every node
+*/
+std::map<std::string, unsigned> Graph::coreNumbers(unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<unsigned> order;
+   std::vector<unsigned> core = C.coreNumbers(order, threads);
+   std::map<std::string, unsigned> result;
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      result[C.name(v)] = core[v];
+   return result;
+}
+
+/**
+   Degeneracy ordering: every node has at most degeneracy neighbours
+   after it
+
+   @param  threads 1 = bucket algorithm, otherwise parallel peeling
+                   (0 = all cores)
+   @return nodes in the order they are peeled
+*/
+std::list<std::string> Graph::degeneracyOrder(unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<unsigned> order;
+   C.coreNumbers(order, threads);
+   std::list<std::string> result;
+   for(auto v = order.begin(); v != order.end(); ++v)
+      result.push_back(C.name(*v));
+   return result;
+}
+
+/**
+   Hop distances from many sources at once; see CompactGraph::distances
+
+   @param  sources eg. {a, b, ...}
+   @param  threads worker threads, 0 = all cores
+   @return distance from every source to every node it reaches
+*/
+std::map<std::string, std::map<std::string, unsigned> >
+Graph::distances(const std::list<std::string>& sources, unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<unsigned> ids;
+   for(auto s = sources.begin(); s != sources.end(); ++s) {
+      if(C.id(*s) < C.nodes())
+         ids.push_back(C.id(*s));
+   }
+   std::vector<std::vector<unsigned> > distance = C.distances(ids, threads);
+   std::map<std::string, std::map<std::string, unsigned> > result;
+   /** empty when stopped by the scope */
+   for(unsigned i = 0; i < distance.size(); ++i) {
+      std::map<std::string, unsigned>& row = result[C.name(ids[i])];
+      for(unsigned v = 0; v < C.nodes(); ++v) {
+         if(distance[i][v] != CompactGraph::unreachable)
+            row[C.name(v)] = distance[i][v];
+      }
+   }
+   return result;
+}
+
+/**
+   Answer a batch of "can u reach v?" queries; see CompactGraph::reachable
+
+   @param  queries eg. {<a, b>, <c, d>, ...}
+   @param  threads worker threads, 0 = all cores
+   @return answer of every query, in order; false if a node doesn't exist.
+           Empty if the scope stopped it before every query was answered
+*/
+std::list<bool> Graph::reachable(const std::list<std::pair<std::string, std::string> >& queries,
+                                 unsigned threads) const {
+   CompactGraph C(*this);
+   std::vector<std::pair<unsigned, unsigned> > ids;
+   for(auto q = queries.begin(); q != queries.end(); ++q)
+      ids.push_back(std::make_pair(C.id(q->first), C.id(q->second)));
+   std::vector<char> answer = C.reachable(ids, threads);
+   return std::list<bool>(answer.begin(), answer.end());
+}
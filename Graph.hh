@@ -12,14 +12,29 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <scoped_allocator>
+#include "Memory.hh"
+#include "Stats.hh"
  
 namespace GraphLib {
 
+class CompactGraph;
+class ReachabilityIndex;
+
 /** C++ implementation of a directed/undirected graph using the STL 
-    and the dracula javasript library to draw the graph
+    and the dracula javasript library to draw the graph.
+    Every internal container draws from the MemoryResource given to the
+    constructor (global new/delete by default); algorithms take their
+    scratch containers from a per thread pool (scratchResource())
 */
 class Graph {
 
+   /** builds its arrays straight from the internal containers */
+   friend class CompactGraph;
+
 public:
    /** generate a random edge to connect the Node */
    static int random;       
@@ -29,44 +44,133 @@ public:
    static bool directed;  
    /** generate undirected Graph */
    static bool undirected;  
+   /** spanning forest by sorting the edges */
+   static int kruskal;
+   /** spanning forest by merging components along their cheapest edge */
+   static int boruvka;
    /** generate random Graph with (max) n Node */
    static Graph  generateRandomGraph(int, bool graphType = directed); 
 
    /** operator= is not implemented */
    Graph& operator=(const Graph&) = delete; 
 
-   explicit Graph(bool graphType = directed);
+   explicit Graph(bool graphType = directed,
+                  MemoryResource* resource = newDeleteResource());
    
-   Graph(std::string regex, int edgeMode, bool graphType = directed);  
+   Graph(std::string regex, int edgeMode, bool graphType = directed,
+         MemoryResource* resource = newDeleteResource());  
    Graph(const Graph&); 
+   Graph(const Graph&, MemoryResource* resource); 
    /** default Distructor*/
    ~Graph() = default;  
 
-   Graph transpose();  
-   void  DFS(std::string sourceNode); 
-   void  BFS(std::string sourceNode);
-   void  floydWarshell(double** graph);
-   void  coloring();    
+   Graph transpose() const;  
+   void  DFS(std::string sourceNode) const; 
+   void  BFS(std::string sourceNode) const;
+   /** prints nothing if a parallel::Scope stops it */
+   void  floydWarshell(double** graph, unsigned threads = 0) const;
+   void  coloring() const;    
    void  draw() const;  
    void  print(std::ostream&) const;   
    void  addNode(std::string node);    
    void  removeNode(std::string node); 
    void  addEdge(std::string fromNode, std::string toNode, double cost = 1);
    void  removeEdge(std::string from, std::string toNode);
+   void  vacuum();
+   void  setVacuumThreshold(double deadFraction);
    void  setWeight(std::string fromNode, std::string toNode, double cost);
    bool  hasNegativeWeigth() const;
    bool  isCyclic() const;
    bool  isConnected() const;
+   bool  connected(std::string u, std::string v) const;
+   unsigned components() const;
+   bool  wouldCreateCycle(std::string fromNode, std::string toNode) const;
+   bool  reachable(std::string fromNode, std::string toNode) const;
+   void  indexReachability(unsigned traversals = 2, unsigned closureLimit = 4096);
    int   isEulerian() const; 
-   int** fromListADJToMatrixADJ(); 
+   int** fromListADJToMatrixADJ() const; 
 
-   double** weightMatrix();
+   double** weightMatrix() const;
 
    unsigned minRank() const;
    unsigned maxRank() const;
 
    std::list<std::string> adjacent(std::string v) const; 
 
+   CompactGraph compact() const;
+   std::map<std::string, double> pageRank(double damping = 0.85,
+                                          double tolerance = 1e-9,
+                                          unsigned maxIterations = 100,
+                                          unsigned threads = 0) const;
+   std::map<std::string, double> personalizedPageRank(const std::map<std::string, double>& seeds,
+                                                      double damping = 0.85,
+                                                      double tolerance = 1e-9,
+                                                      unsigned maxIterations = 100,
+                                                      unsigned threads = 0) const;
+   std::map<std::string, double> approximatePageRank(std::string source,
+                                                     double alpha = 0.15,
+                                                     double epsilon = 1e-6) const;
+
+   unsigned long triangles(unsigned threads = 0) const;
+   std::map<std::string, unsigned long> triangleCount(unsigned threads = 0) const;
+   std::map<std::string, double> clusteringCoefficient(unsigned threads = 0) const;
+   std::list<std::pair<std::string, std::string> > kTruss(unsigned k) const;
+
+   /** edges of a minimum spanning forest and their total weight */
+   struct SpanningForest {
+      /** eg. {<a, b>, <b, c>, ...} */
+      std::list<std::pair<std::string, std::string> > edges;
+      double weight;
+   };
+   SpanningForest minimumSpanningForest(int method = kruskal, unsigned threads = 0) const;
+
+   /** minimum cut between two nodes, see minCut() */
+   struct Cut {
+      /** nodes on the side of the source */
+      std::list<std::string> sourceSide;
+      /** saturated edges from the source side to the sink side */
+      std::list<std::pair<std::string, std::string> > edges;
+      double capacity;
+   };
+   double maxFlow(std::string source, std::string sink) const;
+   Cut    minCut(std::string source, std::string sink) const;
+
+   /** these four return an empty result if a parallel::Scope stopped them */
+   std::map<std::string, double> betweenness(bool weighted = false, unsigned threads = 0) const;
+   std::map<std::string, double> approximateBetweenness(double epsilon = 0.01, double delta = 0.1,
+                                                        bool weighted = false,
+                                                        unsigned threads = 0) const;
+
+   std::map<std::string, std::map<std::string, unsigned> >
+         distances(const std::list<std::string>& sources, unsigned threads = 0) const;
+   std::list<bool> reachable(const std::list<std::pair<std::string, std::string> >& queries,
+                             unsigned threads = 0) const;
+
+   std::map<std::string, unsigned> coreNumbers(unsigned threads = 1) const;
+   std::list<std::string> degeneracyOrder(unsigned threads = 1) const;
+
+   /** heap bytes held by each part of the graph, see memoryUsage() */
+   struct MemoryUsage {
+      /** _node, with its tombstones and positions */
+      unsigned long nodes;
+      /** _edge, with its tombstones and positions */
+      unsigned long edges;
+      /** _edgeWeight */
+      unsigned long weights;
+      /** successor and predecessor lists */
+      unsigned long adjacency;
+      /** union-find and spanning forest */
+      unsigned long components;
+      /** topological order */
+      unsigned long order;
+
+      unsigned long total() const;
+      void print(std::ostream&) const;
+   };
+   MemoryUsage memoryUsage() const;
+
+   inline MemoryResource* resource() const;
+
    inline bool hasEdge(std::string fromNode, std::string toNode) const;
    inline bool isOriented() const;
    inline bool isRegular() const;        
@@ -74,27 +178,135 @@ public:
 
    inline unsigned nodes() const;
    inline unsigned edges() const; 
+   inline unsigned long tombstones() const;
+   inline unsigned long version() const;
    inline unsigned rank(std::string v) const; 
    inline double   weight(std::string fromNode, std::string toNode) const;  
 
 private: 
    /** direct graph or undirect */
    bool direct;  
+   /** where the containers below get their memory */
+   MemoryResource* _resource;
    
    /** eg. <v. u> */
    typedef std::pair<std::string, std::string> link;  
-   typedef std::map<std::string, bool> mapStringBool;
+
+   /** containers allocating from a MemoryResource; maps pass the
+       resource on to the containers they hold */
+   template<typename K, typename V>
+   using resourceMap = std::map<K, V, std::less<K>,
+      std::scoped_allocator_adaptor<ResourceAllocator<std::pair<const K, V> > > >;
+   typedef std::vector<std::string, ResourceAllocator<std::string> > nodeList;
+   typedef std::vector<link, ResourceAllocator<link> >               linkList;
+   typedef std::set<link, std::less<link>, ResourceAllocator<link> > linkSet;
+   typedef std::set<std::string, std::less<std::string>,
+                    ResourceAllocator<std::string> >                 nodeSet;
+   typedef std::list<std::string, ResourceAllocator<std::string> >   nodeQueue;
+   typedef resourceMap<std::string, nodeList>                        adjacencyMap;
+   typedef resourceMap<std::string, bool>                            mapStringBool;
+   typedef std::vector<char, ResourceAllocator<char> >               flagList;
 
    /** eg. {v1, v2, v3, ...} */
-   std::vector<std::string> _node;     
+   nodeList                    _node;     
    /** eg. {<v1, u1>, <v2, u2>, ...}  */  
-   std::vector<link>        _edge;   
+   linkList                    _edge;   
    /** eg. {<v1,u1> = 1, <v2,u2> = 1 ,...}  */    
-   std::map<link, double>   _edgeWeight;  
+   resourceMap<link, double>   _edgeWeight;  
+
+   /** removed nodes and edges stay in _node and _edge as tombstones,
+       flagged here, until vacuum() drops them all in one pass */
+   flagList                            _nodeDead;
+   flagList                            _edgeDead;
+   unsigned                            _deadNodes;
+   unsigned long                       _deadEdges;
+   /** vacuum() once this fraction of _node or _edge is dead */
+   double                              _vacuumThreshold;
+   /** position of every live node in _node, of every live edge in _edge
+       (the first of the two of an undirected self-loop) */
+   resourceMap<std::string, unsigned>  _nodeAt;
+   resourceMap<link, unsigned long>    _edgeAt;
+
+   /** eg. {v1 = [u1, u2], ...} out-neighbours in insertion order */
+   adjacencyMap _successors;
+   /** eg. {u1 = [v1], ...} in-neighbours in insertion order */
+   adjacencyMap _predecessors;
+
+   /** union-find over the weakly connected components */
+   resourceMap<std::string, std::string> _parent;
+   resourceMap<std::string, unsigned>    _componentSize;
+   /** edges of the spanning forest that _parent was built from */
+   linkSet                               _forest;
+   unsigned                              _components;
+   /** a forest edge was removed without a replacement (or with its
+       node), _parent must be rebuilt before use */
+   bool                                  _componentsStale;
+
+   /** topological order of the nodes, valid while _acyclic (directed only) */
+   resourceMap<std::string, int> _order;
+   bool                          _acyclic;
+   /** an edge was removed from a cyclic graph, it may be acyclic now */
+   bool                          _orderStale;
+   int                           _nextOrder;
+
+   /** reachability index knobs, 0 traversals = no index */
+   unsigned _reachTraversals;
+   unsigned _reachClosureLimit;
+   /** immutable index shared with the copies, read and replaced with
+       std::atomic_load/store; null when a change may have changed the
+       reachability relation, mutable since the first reachable() after
+       that rebuilds it */
+   mutable std::shared_ptr<const ReachabilityIndex> _reachability;
+   /** serializes the rebuilds of the index by const readers */
+   mutable std::mutex                       _reachabilityLock;
 
-   inline std::vector<std::string> _Node() const;        
-   inline std::vector<link>        _Edge() const;        
-   inline std::map<link, double>   _EdgeWeight() const;  
+   /** bumped by every change (_version) and only by the changes of the
+       nodes and edges (_topology), not by setWeight() */
+   unsigned long _version;
+   unsigned long _topology;
+
+   /** result of a const query and the version it was computed at */
+   template<typename T>
+   struct Memo {
+      unsigned long version;
+      T             value;
+      Memo() : version(0), value() {}
+   };
+   /** cached results, each valid while the version it depends on stays */
+   mutable Memo<bool>                          _connectedCache;
+   mutable Memo<bool>                          _cyclicCache;
+   mutable Memo<unsigned>                      _oddCache;
+   mutable Memo<std::pair<unsigned, unsigned> > _rankCache;
+   mutable Memo<bool>                          _negativeCache;
+
+   /** what const readers use instead of a stale union-find or order,
+       built once per version and shared */
+   struct ComponentLabels {
+      /** node -> representative of its component */
+      resourceMap<std::string, std::string> root;
+      unsigned                              count;
+      ComponentLabels();
+   };
+   struct OrderLabels {
+      /** node -> position, cycles after the sorted nodes */
+      resourceMap<std::string, int> order;
+      bool                          acyclic;
+      OrderLabels();
+   };
+   mutable Memo<std::shared_ptr<const ComponentLabels> > _componentLabels;
+   mutable Memo<std::shared_ptr<const OrderLabels> >     _orderLabels;
+   /** guards the caches, filled by concurrent const readers */
+   mutable std::mutex                          _cacheLock;
+
+   inline const nodeList&                  _Node() const;        
+   inline const linkList&                  _Edge() const;        
+   inline const resourceMap<link, double>& _EdgeWeight() const;  
+   inline ResourceAllocator<char>          _allocator() const;
+   inline bool _alive(nodeList::const_iterator v) const;
+   inline bool _alive(linkList::const_iterator e) const;
+   bool _buryEdge(const std::string& fromNode, const std::string& toNode);
+   void _vacuumIfNeeded();
+   const nodeList& _adjacent(const std::string& v) const;
    
    void _DFSUtil(std::string v, mapStringBool& visited) const;
    void _DFSUtil2(std::string v, mapStringBool& visited) const;
@@ -102,7 +314,31 @@ private:
    void _generateJavascriptPage() const;
    void _generateEdge(int);          
    bool _isCyclicUtil(std::string v, mapStringBool visited, mapStringBool recStack) const; 
-   void _printSolutionFloydWarshell(int** dist);
+   void _printSolutionFloydWarshell(int** dist) const;
+
+   std::string _findComponent(std::string v) const;
+   void _unionComponents(std::string fromNode, std::string toNode);
+   void _rebuildComponents();
+   bool _reorder(std::string fromNode, std::string toNode);
+   void _rebuildOrder();
+   unsigned _spanningForest(resourceMap<std::string, std::string>& root,
+                            linkSet& forest) const;
+   bool _topologicalOrder(resourceMap<std::string, int>& order) const;
+   bool _reaches(std::string fromNode, std::string toNode,
+                 const resourceMap<std::string, int>& order, int bound) const;
+   bool _reachesWithout(const std::string& fromNode, const std::string& toNode,
+                        const ReachabilityIndex& index) const;
+   bool _replaceForestEdge(const std::string& fromNode, const std::string& toNode);
+   std::shared_ptr<const ComponentLabels> _staleComponents() const;
+   std::shared_ptr<const OrderLabels>     _staleOrder() const;
+   void _dropReachability();
+
+   template<typename T, typename F>
+   T _memoize(Memo<T>& memo, unsigned long version, F compute) const;
+   bool _isConnected() const;
+   bool _isCyclic() const;
+   bool _hasNegativeWeight() const;
+   std::pair<unsigned, unsigned> _rankRange() const;
 
 /** class Graph */
 };  
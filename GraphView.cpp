@@ -0,0 +1,310 @@
+/*
+   @file    GraphView.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include "GraphView.hh"
+#include "Kernels.hh"
+
+using namespace GraphLib;
+
+/**
+   View of the whole graph
+
+   @param  C graph to look at, must outlive the view
+*/
+GraphView::GraphView(const CompactGraph& C)
+   : _graph(&C), _reversed(false), _undirected(false) {
+}
+
+/**
+   @param  mask per node flag, indexed by id; missing entries count as 0
+   @return view restricted to the nodes of this view with mask[v] != 0
+*/
+GraphView GraphView::induced(const std::vector<char>& mask) const {
+   std::vector<char> keep(_graph->nodes(), 0);
+   for(unsigned v = 0; v < keep.size() && v < mask.size(); ++v)
+      keep[v] = mask[v] && contains(v);
+   GraphView view(*this);
+   view._mask = std::make_shared<const std::vector<char> >(keep);
+   return view;
+}
+
+/**
+   @param  keep callable invoked as keep(id)
+   @return view restricted to the nodes of this view with keep(v)
+*/
+GraphView GraphView::induced(std::function<bool(unsigned)> keep) const {
+   std::vector<char> mask(_graph->nodes(), 0);
+   for(unsigned v = 0; v < mask.size(); ++v)
+      mask[v] = contains(v) && keep(v);
+   GraphView view(*this);
+   view._mask = std::make_shared<const std::vector<char> >(mask);
+   return view;
+}
+
+/**
+   @param  keep callable invoked as keep(weight)
+   @return view with the edges of this view whose weight satisfies keep
+*/
+GraphView GraphView::filterEdges(std::function<bool(double)> keep) const {
+   GraphView view(*this);
+   if(_keep) {
+      std::function<bool(double)> previous = _keep;
+      view._keep = [previous, keep](double weight) { return previous(weight) && keep(weight); };
+   }
+   else
+      view._keep = keep;
+   return view;
+}
+
+/**
+   @return view with every edge turned around
+*/
+GraphView GraphView::reversed() const {
+   GraphView view(*this);
+   view._reversed = !_reversed;
+   return view;
+}
+
+/**
+   @return view where every edge can be followed both ways
+*/
+GraphView GraphView::undirected() const {
+   GraphView view(*this);
+   view._undirected = true;
+   return view;
+}
+
+/**
+   @return number of nodes of the view
+*/
+unsigned GraphView::nodes() const {
+   if(!_mask)
+      return _graph->nodes();
+   return std::count(_mask->begin(), _mask->end(), 1);
+}
+
+/**
+   Breadth first search
+
+   @param  source node id to start from
+   @return nodes reached, in the order they were visited
+*/
+std::vector<unsigned> GraphView::BFS(unsigned source) const {
+   GRAPH_STAT_TIMER("viewBFS");
+   std::vector<unsigned> order;
+   if(!contains(source))
+      return order;
+   std::vector<char> visited(_graph->nodes(), 0);
+   visited[source] = 1;
+   order.push_back(source);
+   for(std::size_t i = 0; i < order.size(); ++i) {
+      forEachOut(order[i], [&](unsigned w, double) {
+         if(!visited[w]) {
+            visited[w] = 1;
+            order.push_back(w);
+         }
+      });
+   }
+   return order;
+}
+
+/**
+   Depth first search, neighbours in edge order (the same preorder as
+   the recursive version)
+
+   @param  source node id to start from
+   @return nodes reached, in the order they were visited
+*/
+std::vector<unsigned> GraphView::DFS(unsigned source) const {
+   GRAPH_STAT_TIMER("viewDFS");
+   std::vector<unsigned> order;
+   if(!contains(source))
+      return order;
+   std::vector<char> visited(_graph->nodes(), 0);
+   std::vector<unsigned> stack(1, source), neighbours;
+   while(!stack.empty()) {
+      unsigned v = stack.back();
+      stack.pop_back();
+      if(visited[v])
+         continue;
+      visited[v] = 1;
+      order.push_back(v);
+      /** pushed in reverse so the first neighbour is visited first */
+      neighbours.clear();
+      forEachOut(v, [&](unsigned w, double) {
+         if(!visited[w])
+            neighbours.push_back(w);
+      });
+      stack.insert(stack.end(), neighbours.rbegin(), neighbours.rend());
+   }
+   return order;
+}
+
+/**
+   Connected components, edge directions ignored (weakly connected
+   components of a directed view)
+
+   @param  component component of every node, indexed by id; nodes()
+                     of the CompactGraph for the nodes outside the view
+   @return number of components
+*/
+unsigned GraphView::components(std::vector<unsigned>& component) const {
+   GRAPH_STAT_TIMER("viewComponents");
+   const unsigned n = _graph->nodes();
+   GraphView both = undirected();
+   component.assign(n, n);
+   unsigned count = 0;
+   std::vector<unsigned> queue;
+   for(unsigned root = 0; root < n; ++root) {
+      if(!contains(root) || component[root] != n)
+         continue;
+      component[root] = count;
+      queue.assign(1, root);
+      for(std::size_t i = 0; i < queue.size(); ++i) {
+         both.forEachOut(queue[i], [&](unsigned w, double) {
+            if(component[w] == n) {
+               component[w] = count;
+               queue.push_back(w);
+            }
+         });
+      }
+      ++count;
+   }
+   return count;
+}
+
+/**
+   PageRank of the view: uniform teleport over its nodes, dangling nodes
+   restart (see CompactGraph::personalizedPageRank)
+
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node, indexed by id, 0 outside the view
+*/
+std::vector<double> GraphView::pageRank(double damping, double tolerance,
+                                        unsigned maxIterations, unsigned threads) const {
+   return kernels::pageRank(*this, std::vector<double>(), damping, tolerance,
+                            maxIterations, threads);
+}
+
+/**
+   @param  teleport restart weight of every node, indexed by id; entries
+                    outside the view are ignored
+   @return rank of every node, indexed by id, 0 outside the view
+*/
+std::vector<double> GraphView::personalizedPageRank(const std::vector<double>& teleport,
+                                                    double damping, double tolerance,
+                                                    unsigned maxIterations,
+                                                    unsigned threads) const {
+   return kernels::pageRank(*this, teleport, damping, tolerance, maxIterations, threads);
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return number of triangles of the view
+*/
+unsigned long GraphView::triangles(unsigned threads) const {
+   std::vector<unsigned long> count = triangleCount(threads);
+   unsigned long total = 0;
+   for(auto c = count.begin(); c != count.end(); ++c)
+      total += *c;
+   return total / 3;
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return triangles through every node, indexed by id
+*/
+std::vector<unsigned long> GraphView::triangleCount(unsigned threads) const {
+   return kernels::triangleCount(*this, threads);
+}
+
+/**
+   @param  threads worker threads, 0 = all cores
+   @return local clustering coefficient per node, indexed by id
+*/
+std::vector<double> GraphView::clusteringCoefficient(unsigned threads) const {
+   return kernels::clusteringCoefficient(*this, threads);
+}
+
+/**
+   @param  k truss order, k <= 2 keeps every edge
+   @return undirected edges (u < v) of the k-truss of the view
+*/
+std::vector<std::pair<unsigned, unsigned> > GraphView::kTruss(unsigned k) const {
+   return kernels::kTruss(*this, k);
+}
+
+/**
+   @param  forest  edges selected, as (u, v) with u < v
+   @param  method  Graph::kruskal or Graph::boruvka
+   @param  threads worker threads, 0 = all cores
+   @return total weight of the minimum spanning forest of the view
+*/
+double GraphView::minimumSpanningForest(std::vector<std::pair<unsigned, unsigned> >& forest,
+                                        int method, unsigned threads) const {
+   return kernels::minimumSpanningForest(*this, forest, method, threads);
+}
+
+/**
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @return betweenness of every node, indexed by id, shortest paths
+           inside the view; an undirected() view of a directed graph
+           keeps u -> v and v -> u as two parallel edges, each counting
+           as a path of its own
+*/
+std::vector<double> GraphView::betweenness(bool weighted, unsigned threads) const {
+   return kernels::betweenness(*this, weighted, threads);
+}
+
+/**
+   @param  epsilon  error bound on the normalized betweenness
+   @param  delta    probability that some node exceeds the bound
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @param  seed     seed of the sampling
+   @return estimated betweenness of every node, indexed by id
+*/
+std::vector<double> GraphView::approximateBetweenness(double epsilon, double delta,
+                                                      bool weighted, unsigned threads,
+                                                      unsigned seed) const {
+   return kernels::approximateBetweenness(*this, epsilon, delta, weighted, threads, seed);
+}
+
+/**
+   @param  sources node ids, those outside the view reach nothing
+   @param  threads worker threads, 0 = all cores
+   @return distance[i][v] from sources[i] to v inside the view,
+           CompactGraph::unreachable if not reached
+*/
+std::vector<std::vector<unsigned> > GraphView::distances(const std::vector<unsigned>& sources,
+                                                         unsigned threads) const {
+   return kernels::distances(*this, sources, threads);
+}
+
+/**
+   @param  queries (u, v) node id pairs
+   @param  threads worker threads, 0 = all cores
+   @return 1 if u reaches v inside the view, for every query in order
+*/
+std::vector<char> GraphView::reachable(const std::vector<std::pair<unsigned, unsigned> >& queries,
+                                       unsigned threads) const {
+   return kernels::reachable(*this, queries, threads);
+}
+
+/**
+   @param  order   nodes of the view in the order they were peeled
+   @param  threads 1 = bucket algorithm, otherwise parallel peeling
+                   (0 = all cores)
+   @return core number of every node, indexed by id, 0 outside the view
+*/
+std::vector<unsigned> GraphView::coreNumbers(std::vector<unsigned>& order,
+                                             unsigned threads) const {
+   return kernels::coreNumbers(*this, order, threads);
+}
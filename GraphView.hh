@@ -0,0 +1,102 @@
+/*
+   @file    GraphView.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef GRAPH_VIEW_HH
+#define GRAPH_VIEW_HH 1
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Filtered look at a CompactGraph that copies no edges: a view is the
+    graph plus a node mask, an edge predicate and two orientation flags,
+    and every filter returns a new view so they can be chained, eg.
+    GraphView(C).induced(mask).filterEdges(heavy).undirected().
+    Node ids are the ids of the CompactGraph, which must outlive its views
+*/
+class GraphView {
+
+public:
+   explicit GraphView(const CompactGraph& C);
+
+   /** subgraph induced by the nodes with mask[v] != 0 (or keep(v)) */
+   GraphView induced(const std::vector<char>& mask) const;
+   GraphView induced(std::function<bool(unsigned)> keep) const;
+   /** only the edges whose weight satisfies keep */
+   GraphView filterEdges(std::function<bool(double)> keep) const;
+   /** every edge turned around */
+   GraphView reversed() const;
+   /** every edge usable both ways */
+   GraphView undirected() const;
+
+   inline const CompactGraph& graph() const;
+   inline unsigned idBound() const;
+   inline bool contains(unsigned v) const;
+   inline bool isOriented() const;
+   unsigned nodes() const;
+
+   /** fn(w, weight) for every edge v -> w / w -> v of the view */
+   template<typename F> void forEachOut(unsigned v, F fn) const;
+   template<typename F> void forEachIn(unsigned v, F fn) const;
+
+   std::vector<unsigned> BFS(unsigned source) const;
+   std::vector<unsigned> DFS(unsigned source) const;
+   unsigned components(std::vector<unsigned>& component) const;
+
+   /** the analytics of CompactGraph on the view (see Kernels.hh), results
+       indexed by the ids of the CompactGraph */
+   std::vector<double> pageRank(double damping = 0.85, double tolerance = 1e-9,
+                                unsigned maxIterations = 100, unsigned threads = 0) const;
+   std::vector<double> personalizedPageRank(const std::vector<double>& teleport,
+                                            double damping = 0.85, double tolerance = 1e-9,
+                                            unsigned maxIterations = 100,
+                                            unsigned threads = 0) const;
+
+   unsigned long                     triangles(unsigned threads = 0) const;
+   std::vector<unsigned long>        triangleCount(unsigned threads = 0) const;
+   std::vector<double>               clusteringCoefficient(unsigned threads = 0) const;
+   std::vector<std::pair<unsigned, unsigned> > kTruss(unsigned k) const;
+
+   double minimumSpanningForest(std::vector<std::pair<unsigned, unsigned> >& forest,
+                                int method = Graph::kruskal, unsigned threads = 0) const;
+
+   /** empty if a parallel::Scope stopped them, like CompactGraph */
+   std::vector<double> betweenness(bool weighted = false, unsigned threads = 0) const;
+   std::vector<double> approximateBetweenness(double epsilon = 0.01, double delta = 0.1,
+                                              bool weighted = false, unsigned threads = 0,
+                                              unsigned seed = 1) const;
+
+   std::vector<std::vector<unsigned> > distances(const std::vector<unsigned>& sources,
+                                                 unsigned threads = 0) const;
+   std::vector<char> reachable(const std::vector<std::pair<unsigned, unsigned> >& queries,
+                               unsigned threads = 0) const;
+
+   std::vector<unsigned> coreNumbers(std::vector<unsigned>& order, unsigned threads = 1) const;
+
+private:
+   const CompactGraph* _graph;
+   /** shared between the views derived from each other, null = every node */
+   std::shared_ptr<const std::vector<char> > _mask;
+   /** null = every edge */
+   std::function<bool(double)> _keep;
+   bool _reversed;
+   bool _undirected;
+
+   template<typename F> void _out(unsigned v, F fn) const;
+   template<typename F> void _in(unsigned v, F fn) const;
+
+/** class GraphView */
+};
+
+/** include inline functions */
+#include "GraphView_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //GRAPH_VIEW_HH
@@ -0,0 +1,115 @@
+/*
+   @file    GraphView_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef GRAPH_VIEW_INLINES_HH
+#define GRAPH_VIEW_INLINES_HH 1
+
+/**
+   @return graph the view looks at
+*/
+inline const CompactGraph&
+GraphView::graph() const {
+   return *_graph;
+}
+
+/**
+   @return ids are 0 ... idBound() - 1, those of the CompactGraph
+*/
+inline unsigned
+GraphView::idBound() const {
+   return _graph->nodes();
+}
+
+/**
+   @param  v node id
+   @return is v part of the view?
+*/
+inline bool
+GraphView::contains(unsigned v) const {
+   return v < _graph->nodes() && (!_mask || (*_mask)[v]);
+}
+
+/**
+   @return are the edges of the view oriented?
+*/
+inline bool
+GraphView::isOriented() const {
+   return _graph->isOriented() && !_undirected;
+}
+
+/**
+   Edges leaving v in the orientation of the CompactGraph, filtered
+
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double)
+   @return void
+*/
+template<typename F> void
+GraphView::_out(unsigned v, F fn) const {
+   for(unsigned long e = _graph->begin(v); e < _graph->end(v); ++e) {
+      unsigned w = _graph->target(e);
+      double weight = _graph->weight(e);
+      if(contains(w) && (!_keep || _keep(weight)))
+         fn(w, weight);
+   }
+}
+
+/**
+   Edges entering v in the orientation of the CompactGraph, filtered
+
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double)
+   @return void
+*/
+template<typename F> void
+GraphView::_in(unsigned v, F fn) const {
+   for(unsigned long e = _graph->inBegin(v); e < _graph->inEnd(v); ++e) {
+      unsigned w = _graph->source(e);
+      double weight = _graph->weight(_graph->inEdge(e));
+      if(contains(w) && (!_keep || _keep(weight)))
+         fn(w, weight);
+   }
+}
+
+/**
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double) on the edges v -> w
+   @return void
+*/
+template<typename F> void
+GraphView::forEachOut(unsigned v, F fn) const {
+   if(!contains(v))
+      return;
+   /** an undirected CompactGraph already holds both directions */
+   if(_undirected && _graph->isOriented()) {
+      _out(v, fn);
+      _in(v, fn);
+   }
+   else if(_reversed && _graph->isOriented())
+      _in(v, fn);
+   else
+      _out(v, fn);
+}
+
+/**
+   @param  v  node id
+   @param  fn callable invoked as fn(unsigned, double) on the edges w -> v
+   @return void
+*/
+template<typename F> void
+GraphView::forEachIn(unsigned v, F fn) const {
+   if(!contains(v))
+      return;
+   if(_undirected && _graph->isOriented()) {
+      _in(v, fn);
+      _out(v, fn);
+   }
+   else if(_reversed && _graph->isOriented())
+      _out(v, fn);
+   else
+      _in(v, fn);
+}
+
+#endif
@@ -14,13 +14,13 @@ typedef std::pair<std::string, std::string> link;
 */
 inline unsigned
 Graph::nodes() const {
-   return _node.size();
+   return _node.size() - _deadNodes;
 }
 
 /**
    @return vector of nodes
 */
-inline std::vector<std::string>
+inline const Graph::nodeList&
 Graph::_Node() const {
    return _node;
 }
@@ -28,7 +28,7 @@ Graph::_Node() const {
 /**
    @return vector of edge
 */
-inline std::vector<link>
+inline const Graph::linkList&
 Graph::_Edge() const {
    return _edge;
 }
@@ -36,17 +36,90 @@ Graph::_Edge() const {
 /**
    @return weight of edges
 */
-inline std::map<link, double>
+inline const Graph::resourceMap<link, double>&
 Graph::_EdgeWeight() const {
    return _edgeWeight;
 }
 
+/**
+   @return allocator drawing from the graph's memory resource
+*/
+inline ResourceAllocator<char>
+Graph::_allocator() const {
+   return ResourceAllocator<char>(_resource);
+}
+
+/**
+   @return number of changes made to the graph so far
+*/
+inline unsigned long
+Graph::version() const {
+   return _version;
+}
+
+/**
+   The cached value if it was computed at version, computed (outside the
+   lock, concurrent readers may both compute it) and cached otherwise
+
+   @param  memo    cache of the query
+   @param  version _version or _topology, whichever the query depends on
+   @param  compute callable returning the value
+   @return T
+*/
+template<typename T, typename F>
+T Graph::_memoize(Memo<T>& memo, unsigned long version, F compute) const {
+   {
+      std::lock_guard<std::mutex> lock(_cacheLock);
+      if(memo.version == version)
+         return memo.value;
+   }
+   T value = compute();
+   std::lock_guard<std::mutex> lock(_cacheLock);
+   memo.version = version;
+   memo.value = value;
+   return value;
+}
+
+/**
+   @param  v position in _node
+   @return v is not a removed node?
+*/
+inline bool
+Graph::_alive(nodeList::const_iterator v) const {
+   return _deadNodes == 0 || !_nodeDead[v - _node.begin()];
+}
+
+/**
+   @param  e position in _edge
+   @return e is not a removed edge?
+*/
+inline bool
+Graph::_alive(linkList::const_iterator e) const {
+   return _deadEdges == 0 || !_edgeDead[e - _edge.begin()];
+}
+
+/**
+   @return memory resource of the graph's containers
+*/
+inline MemoryResource*
+Graph::resource() const {
+   return _resource;
+}
+
 /**
    @return number of edges
 */
 inline unsigned
 Graph::edges() const {
-   return _edge.size();
+   return _edge.size() - _deadEdges;
+}
+
+/**
+   @return removed nodes and edges not dropped by vacuum() yet
+*/
+inline unsigned long
+Graph::tombstones() const {
+   return _deadNodes + _deadEdges;
 }
 
 /**
@@ -55,7 +128,9 @@ Graph::edges() const {
 */
 inline unsigned
 Graph::rank(std::string v) const {
-   return adjacent(v).size();
+   adjacencyMap::const_iterator s;
+   s = _successors.find(v);
+   return s != _successors.end() ? s->second.size() : 0;
 }
 
 /**
@@ -80,7 +155,8 @@ Graph::isOriented() const {
 */
 inline bool
 Graph::exist(std::string node) const {
-   return std::find(_node.begin(), _node.end(), node) != _node.end();
+   GRAPH_STAT_COUNT("exist", lookups, 1);
+   return _parent.find(node) != _parent.end();
 }
 
 /**
@@ -90,8 +166,11 @@ Graph::exist(std::string node) const {
 */
 inline bool
 Graph::hasEdge(std::string fromNode, std::string toNode) const {
-   return std::find(_edge.begin(), _edge.end(),
-                    std::make_pair(fromNode, toNode)) != _edge.end();
+   GRAPH_STAT_COUNT("hasEdge", lookups, 1);
+   adjacencyMap::const_iterator s;
+   s = _successors.find(fromNode);
+   return s != _successors.end() &&
+          std::find(s->second.begin(), s->second.end(), toNode) != s->second.end();
 }
 
 /**
@@ -101,6 +180,7 @@ Graph::hasEdge(std::string fromNode, std::string toNode) const {
 */
 inline double 
 Graph::weight(std::string fromNode, std::string toNode) const {
+   GRAPH_STAT_COUNT("weight", lookups, 1);
    if(_edgeWeight.find(std::make_pair(fromNode, toNode)) != _edgeWeight.end())
       return _edgeWeight.at(std::make_pair(fromNode, toNode));
    return 0;
@@ -0,0 +1,129 @@
+/*
+   @file    Kernels.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef KERNELS_HH
+#define KERNELS_HH 1
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "CompactGraph.hh"
+#include "Parallel.hh"
+
+namespace GraphLib {
+
+/** Analytics written once for every graph that can enumerate the
+    neighbours of a node. CompactGraph and GraphView both provide
+       unsigned idBound() const        ids are 0 ... idBound() - 1
+       bool contains(unsigned v) const is v a node of the graph?
+       bool isOriented() const
+       forEachOut(v, fn), forEachIn(v, fn)
+                                       fn(w, weight) for every edge
+                                       v -> w, w -> v
+    and only report edges between nodes they contain. Results are
+    indexed by id; ids the graph does not contain get 0 and are left out
+    of the lists
+*/
+namespace kernels {
+
+   /** Undirected simple graph (no self loops, no parallel edges) with
+       sorted neighbour lists, plus the "forward" lists holding only the
+       neighbours of higher rank, rank being (degree, id): every triangle
+       is then found exactly once, from its lowest ranked corner, and
+       hubs keep short forward lists */
+   struct SortedAdjacency {
+      std::vector<unsigned long> offset;
+      std::vector<unsigned>      adjacent;
+      std::vector<unsigned long> forwardOffset;
+      std::vector<unsigned>      forward;
+
+      template<typename G> explicit SortedAdjacency(const G& g);
+
+      inline unsigned long degree(unsigned v) const;
+      inline bool          before(unsigned u, unsigned v) const;
+      /** position of v in the neighbour list of u, or offset[u + 1] */
+      inline unsigned long find(unsigned u, unsigned v) const;
+   };
+
+   /** ids contained by g, increasing */
+   template<typename G>
+   std::vector<unsigned> members(const G& g);
+
+   /** random walk restarting from teleport (uniform over the nodes if it
+       sums to 0), see CompactGraph::personalizedPageRank */
+   template<typename G>
+   std::vector<double> pageRank(const G& g, const std::vector<double>& teleport,
+                                double damping, double tolerance,
+                                unsigned maxIterations, unsigned threads);
+
+   /** local structure of the undirected simple graph underneath */
+   template<typename G>
+   std::vector<unsigned long> triangleCount(const G& g, unsigned threads);
+   template<typename G>
+   std::vector<double> clusteringCoefficient(const G& g, unsigned threads);
+   template<typename G>
+   std::vector<std::pair<unsigned, unsigned> > kTruss(const G& g, unsigned k);
+
+   /** Graph::kruskal or Graph::boruvka, edge directions ignored */
+   template<typename G>
+   double minimumSpanningForest(const G& g, std::vector<std::pair<unsigned, unsigned> >& forest,
+                                int method, unsigned threads);
+
+   /** Brandes dependencies accumulated over the given sources */
+   template<typename G>
+   std::vector<double> dependencies(const G& g, const std::vector<unsigned>& sources,
+                                    bool weighted, unsigned threads);
+   template<typename G>
+   std::vector<double> betweenness(const G& g, bool weighted, unsigned threads);
+   template<typename G>
+   std::vector<double> approximateBetweenness(const G& g, double epsilon, double delta,
+                                              bool weighted, unsigned threads, unsigned seed);
+
+   /** k-cores of the undirected simple graph underneath */
+   template<typename G>
+   std::vector<unsigned> coreNumbers(const G& g, std::vector<unsigned>& order,
+                                     unsigned threads);
+
+   /** one bit per source of a multi-source BFS pass */
+   struct Lanes {
+      static const unsigned width = 256;
+      std::uint64_t word[width / 64];
+
+      inline bool any() const;
+      inline bool test(unsigned lane) const;
+      inline void set(unsigned lane);
+      /** fn(lane) for every bit set */
+      template<typename F> void forEach(F fn) const;
+   };
+
+   /** batched traversals, Lanes::width sources per pass */
+   template<typename G, typename Found, typename Done>
+   void multiSourceBFS(const G& g, const unsigned* sources, unsigned count,
+                       Found found, Done done);
+   template<typename G>
+   std::vector<std::vector<unsigned> > distances(const G& g, const std::vector<unsigned>& sources,
+                                                 unsigned threads);
+   template<typename G>
+   std::vector<char> reachable(const G& g,
+                               const std::vector<std::pair<unsigned, unsigned> >& queries,
+                               unsigned threads);
+
+/** namespace kernels */
+}
+
+/** include inline functions */
+#include "Kernels_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //KERNELS_HH
@@ -0,0 +1,1041 @@
+/*
+   @file    Kernels_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef KERNELS_INLINES_HH
+#define KERNELS_INLINES_HH 1
+
+namespace kernels {
+
+   /** first position in [first, last) not less than value, probing
+       1, 2, 4, ... elements ahead before the binary search */
+   inline const unsigned* gallop(const unsigned* first, const unsigned* last, unsigned value) {
+      std::size_t step = 1;
+      while(first + step < last && first[step] < value) {
+         first += step;
+         step *= 2;
+      }
+      return std::lower_bound(first, std::min(first + step + 1, last), value);
+   }
+
+   /**
+      Call found(x) for every x in both sorted ranges. Lists of similar
+      length are merged, a much shorter list gallops through the longer
+   */
+   template<typename F>
+   void intersect(const unsigned* a, const unsigned* aEnd,
+                  const unsigned* b, const unsigned* bEnd, F found) {
+      if(aEnd - a > bEnd - b) {
+         std::swap(a, b);
+         std::swap(aEnd, bEnd);
+      }
+      if((aEnd - a) * 32 < bEnd - b) {
+         for(; a < aEnd && b < bEnd; ++a) {
+            b = gallop(b, bEnd, *a);
+            if(b < bEnd && *b == *a)
+               found(*a);
+         }
+         return;
+      }
+      while(a < aEnd && b < bEnd) {
+         if(*a < *b)
+            ++a;
+         else if(*b < *a)
+            ++b;
+         else {
+            found(*a);
+            ++a;
+            ++b;
+         }
+      }
+   }
+
+   /** triangles through every node: each thread intersects the forward
+       lists of a range of nodes and counts in its own array */
+   inline std::vector<unsigned long> countTriangles(const SortedAdjacency& A, unsigned threads) {
+      const std::size_t n = A.offset.size() - 1;
+      std::vector<std::vector<unsigned long> > partial(parallel::threads(threads));
+
+      parallel::forRange(0, n, threads, [&](std::size_t from, std::size_t to, unsigned w) {
+         std::vector<unsigned long>& count = partial[w];
+         count.assign(n, 0);
+         const unsigned* forward = A.forward.empty() ? 0 : &A.forward[0];
+         for(std::size_t u = from; u < to; ++u) {
+            for(unsigned long i = A.forwardOffset[u]; i < A.forwardOffset[u + 1]; ++i) {
+               unsigned v = forward[i];
+               intersect(forward + A.forwardOffset[u], forward + A.forwardOffset[u + 1],
+                         forward + A.forwardOffset[v], forward + A.forwardOffset[v + 1],
+                         [&](unsigned x) {
+                            ++count[u];
+                            ++count[v];
+                            ++count[x];
+                         });
+            }
+         }
+      });
+
+      std::vector<unsigned long> count(n, 0);
+      for(auto p = partial.begin(); p != partial.end(); ++p) {
+         for(std::size_t v = 0; v < p->size(); ++v)
+            count[v] += (*p)[v];
+      }
+      return count;
+   }
+
+   /** undirected edge; edges are ordered by (weight, u, v), a total order
+       that makes the minimum spanning forest unique, so both methods pick
+       the same edges */
+   struct Link {
+      double   weight;
+      unsigned u;
+      unsigned v;
+
+      bool operator<(const Link& other) const {
+         if(weight != other.weight)
+            return weight < other.weight;
+         return u != other.u ? u < other.u : v < other.v;
+      }
+   };
+
+   /** union-find over node ids, union by size */
+   class DisjointSets {
+
+   public:
+      explicit DisjointSets(unsigned n) : _parent(n), _size(n, 1) {
+         for(unsigned v = 0; v < n; ++v)
+            _parent[v] = v;
+      }
+
+      unsigned find(unsigned v) {
+         while(_parent[v] != v) {
+            _parent[v] = _parent[_parent[v]];
+            v = _parent[v];
+         }
+         return v;
+      }
+
+      bool unite(unsigned u, unsigned v) {
+         u = find(u);
+         v = find(v);
+         if(u == v)
+            return false;
+         if(_size[u] < _size[v])
+            std::swap(u, v);
+         _parent[v] = u;
+         _size[u] += _size[v];
+         return true;
+      }
+
+   private:
+      std::vector<unsigned> _parent;
+      std::vector<unsigned> _size;
+   };
+
+   /** sort one range per thread, then merge neighbouring runs pairwise */
+   inline void parallelSort(std::vector<Link>& links, unsigned threads) {
+      std::vector<std::pair<std::size_t, std::size_t> > runs(parallel::threads(threads));
+      unsigned used = parallel::forRange(0, links.size(), threads,
+                                         [&](std::size_t from, std::size_t to, unsigned w) {
+         std::sort(links.begin() + from, links.begin() + to);
+         runs[w] = std::make_pair(from, to);
+      });
+      runs.resize(used);
+      while(runs.size() > 1) {
+         std::vector<std::pair<std::size_t, std::size_t> > merged;
+         for(std::size_t r = 0; r + 1 < runs.size(); r += 2) {
+            std::inplace_merge(links.begin() + runs[r].first, links.begin() + runs[r].second,
+                               links.begin() + runs[r + 1].second);
+            merged.push_back(std::make_pair(runs[r].first, runs[r + 1].second));
+         }
+         if(runs.size() % 2)
+            merged.push_back(runs.back());
+         runs.swap(merged);
+      }
+   }
+
+/** namespace kernels */
+}
+
+/**
+   Build the lists from the edges of g, both directions of every edge
+
+   @param  g graph with the neighbour iteration of Kernels.hh
+*/
+template<typename G>
+kernels::SortedAdjacency::SortedAdjacency(const G& g) {
+   const unsigned n = g.idBound();
+   std::vector<std::vector<unsigned> > lists(n);
+   for(unsigned v = 0; v < n; ++v) {
+      g.forEachOut(v, [&](unsigned w, double) {
+         if(w == v)
+            return;
+         lists[v].push_back(w);
+         lists[w].push_back(v);
+      });
+   }
+   offset.assign(n + 1, 0);
+   for(unsigned v = 0; v < n; ++v) {
+      std::sort(lists[v].begin(), lists[v].end());
+      lists[v].erase(std::unique(lists[v].begin(), lists[v].end()), lists[v].end());
+      adjacent.insert(adjacent.end(), lists[v].begin(), lists[v].end());
+      offset[v + 1] = adjacent.size();
+   }
+
+   forwardOffset.assign(n + 1, 0);
+   for(unsigned v = 0; v < n; ++v) {
+      for(unsigned long i = offset[v]; i < offset[v + 1]; ++i) {
+         if(before(v, adjacent[i]))
+            forward.push_back(adjacent[i]);
+      }
+      forwardOffset[v + 1] = forward.size();
+   }
+}
+
+/**
+   @param  v node id
+   @return number of neighbours of v
+*/
+inline unsigned long
+kernels::SortedAdjacency::degree(unsigned v) const {
+   return offset[v + 1] - offset[v];
+}
+
+/**
+   @return does u rank below v, by (degree, id)?
+*/
+inline bool
+kernels::SortedAdjacency::before(unsigned u, unsigned v) const {
+   return degree(u) < degree(v) || (degree(u) == degree(v) && u < v);
+}
+
+/**
+   @return position of v in the neighbour list of u, or offset[u + 1]
+*/
+inline unsigned long
+kernels::SortedAdjacency::find(unsigned u, unsigned v) const {
+   const unsigned* first = &adjacent[0] + offset[u];
+   const unsigned* last = &adjacent[0] + offset[u + 1];
+   const unsigned* p = std::lower_bound(first, last, v);
+   return p != last && *p == v ? p - &adjacent[0] : offset[u + 1];
+}
+
+/**
+   @param  g graph with the neighbour iteration of Kernels.hh
+   @return ids of the nodes of g, increasing
+*/
+template<typename G> std::vector<unsigned>
+kernels::members(const G& g) {
+   std::vector<unsigned> nodes;
+   for(unsigned v = 0; v < g.idBound(); ++v) {
+      if(g.contains(v))
+         nodes.push_back(v);
+   }
+   return nodes;
+}
+
+/**
+   Personalized PageRank, pull-based power iteration over the in-edges.
+   An out-edge is followed with probability weight / (total weight of the
+   out-edges), negative weights counting as 0. The walk restarts from the
+   teleport distribution with probability 1 - damping, and always
+   restarts from a dangling node (no positive out-weight)
+
+   @param  g             graph with the neighbour iteration of Kernels.hh
+   @param  teleport      restart weight of every node (normalized here),
+                         uniform over the nodes of g if it sums to 0
+   @param  damping       probability of following an edge
+   @param  tolerance     stop when the L1 change of an iteration is below it
+   @param  maxIterations upper bound on the iterations
+   @param  threads       worker threads, 0 = all cores
+   @return rank of every node, indexed by id, summing to 1; the last
+           iterate if the scope of the caller stopped it
+*/
+template<typename G> std::vector<double>
+kernels::pageRank(const G& g, const std::vector<double>& teleport, double damping,
+                  double tolerance, unsigned maxIterations, unsigned threads) {
+   GRAPH_STAT_TIMER("pageRank");
+   const unsigned n = g.idBound();
+   std::vector<unsigned> nodes = members(g);
+   if(nodes.empty())
+      return std::vector<double>(n, 0);
+
+   std::vector<double> restart(n, 0);
+   double total = 0;
+   for(auto v = nodes.begin(); v != nodes.end(); ++v)
+      total += *v < teleport.size() ? std::max(teleport[*v], 0.0) : 0;
+   for(auto v = nodes.begin(); v != nodes.end(); ++v)
+      restart[*v] = total > 0 ? (*v < teleport.size() ? std::max(teleport[*v], 0.0) / total : 0)
+                              : 1.0 / nodes.size();
+
+   std::vector<double> outWeight(n, 0);
+   std::vector<char> dangling(n, 0);
+   for(auto v = nodes.begin(); v != nodes.end(); ++v) {
+      g.forEachOut(*v, [&](unsigned, double weight) { outWeight[*v] += std::max(weight, 0.0); });
+      dangling[*v] = outWeight[*v] <= 0;
+   }
+
+   /** the in-edges with their transition probability, laid out so the
+       inner loop reads inSource and inProbability sequentially */
+   std::vector<unsigned long> inOffset(n + 1, 0);
+   std::vector<unsigned> inSource;
+   std::vector<double> inProbability;
+   for(unsigned v = 0; v < n; ++v) {
+      g.forEachIn(v, [&](unsigned u, double weight) {
+         inSource.push_back(u);
+         inProbability.push_back(outWeight[u] > 0 ? std::max(weight, 0.0) / outWeight[u] : 0);
+      });
+      inOffset[v + 1] = inSource.size();
+   }
+
+   std::vector<double> rank(restart), next(n, 0);
+   std::vector<double> partial(parallel::threads(threads));
+
+   for(unsigned iteration = 0; iteration < maxIterations && !parallel::stopping(); ++iteration) {
+      /** rank held by dangling nodes, spread like the teleport */
+      std::fill(partial.begin(), partial.end(), 0);
+      parallel::forRange(0, n, threads, [&](std::size_t from, std::size_t to, unsigned w) {
+         double sum = 0;
+         for(std::size_t v = from; v < to; ++v)
+            sum += dangling[v] ? rank[v] : 0;
+         partial[w] = sum;
+      });
+      double danglingRank = 0;
+      for(auto p = partial.begin(); p != partial.end(); ++p)
+         danglingRank += *p;
+
+      /** nodes outside g have no in-edge and no restart: they stay at 0 */
+      std::fill(partial.begin(), partial.end(), 0);
+      parallel::forRange(0, n, threads, [&](std::size_t from, std::size_t to, unsigned w) {
+         double change = 0;
+         for(std::size_t v = from; v < to; ++v) {
+            double sum = 0;
+            for(unsigned long e = inOffset[v]; e < inOffset[v + 1]; ++e)
+               sum += rank[inSource[e]] * inProbability[e];
+            next[v] = (1 - damping) * restart[v] + damping * (sum + danglingRank * restart[v]);
+            change += std::fabs(next[v] - rank[v]);
+         }
+         partial[w] = change;
+      });
+      rank.swap(next);
+
+      double change = 0;
+      for(auto p = partial.begin(); p != partial.end(); ++p)
+         change += *p;
+      if(change < tolerance)
+         break;
+   }
+   return rank;
+}
+
+/**
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  threads worker threads, 0 = all cores
+   @return triangles through every node, indexed by id
+*/
+template<typename G> std::vector<unsigned long>
+kernels::triangleCount(const G& g, unsigned threads) {
+   GRAPH_STAT_TIMER("triangleCount");
+   return countTriangles(SortedAdjacency(g), threads);
+}
+
+/**
+   Local clustering coefficient: fraction of the pairs of neighbours of a
+   node that are themselves adjacent, 0 for nodes with less than two
+   neighbours
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  threads worker threads, 0 = all cores
+   @return coefficient per node, indexed by id
+*/
+template<typename G> std::vector<double>
+kernels::clusteringCoefficient(const G& g, unsigned threads) {
+   GRAPH_STAT_TIMER("clusteringCoefficient");
+   SortedAdjacency A(g);
+   std::vector<unsigned long> count = countTriangles(A, threads);
+   std::vector<double> coefficient(g.idBound(), 0);
+   for(unsigned v = 0; v < g.idBound(); ++v) {
+      double d = A.degree(v);
+      if(d > 1)
+         coefficient[v] = 2.0 * count[v] / (d * (d - 1));
+   }
+   return coefficient;
+}
+
+/**
+   k-truss: largest subgraph where every edge belongs to at least k - 2
+   triangles. Edges are peeled in order of support; removing an edge
+   lowers the support of the two other edges of each of its triangles
+
+   @param  g graph with the neighbour iteration of Kernels.hh
+   @param  k truss order, k <= 2 keeps every edge
+   @return undirected edges (u < v) of the k-truss
+*/
+template<typename G> std::vector<std::pair<unsigned, unsigned> >
+kernels::kTruss(const G& g, unsigned k) {
+   GRAPH_STAT_TIMER("kTruss");
+   SortedAdjacency A(g);
+   const unsigned n = g.idBound();
+
+   /** undirected edge id of every position of the neighbour lists */
+   std::vector<std::pair<unsigned, unsigned> > edge;
+   std::vector<unsigned long> edgeOf(A.adjacent.size());
+   for(unsigned u = 0; u < n; ++u) {
+      for(unsigned long i = A.offset[u]; i < A.offset[u + 1]; ++i) {
+         unsigned v = A.adjacent[i];
+         if(u < v) {
+            edgeOf[i] = edge.size();
+            edge.push_back(std::make_pair(u, v));
+         }
+         else
+            edgeOf[i] = edgeOf[A.find(v, u)];
+      }
+   }
+
+   const unsigned* adj = A.adjacent.empty() ? 0 : &A.adjacent[0];
+   std::vector<unsigned long> support(edge.size(), 0);
+   for(unsigned long e = 0; e < edge.size(); ++e) {
+      unsigned u = edge[e].first, v = edge[e].second;
+      intersect(adj + A.offset[u], adj + A.offset[u + 1],
+                adj + A.offset[v], adj + A.offset[v + 1],
+                [&](unsigned) { ++support[e]; });
+   }
+
+   unsigned long needed = k > 2 ? k - 2 : 0;
+   /** queued: support fell below k - 2; peeled: popped, its triangles gone */
+   std::vector<char> queued(edge.size(), 0), peeled(edge.size(), 0);
+   std::vector<unsigned long> peel;
+   for(unsigned long e = 0; e < edge.size(); ++e) {
+      if(support[e] < needed) {
+         queued[e] = 1;
+         peel.push_back(e);
+      }
+   }
+   while(!peel.empty()) {
+      unsigned long e = peel.back();
+      peel.pop_back();
+      peeled[e] = 1;
+      unsigned u = edge[e].first, v = edge[e].second;
+      intersect(adj + A.offset[u], adj + A.offset[u + 1],
+                adj + A.offset[v], adj + A.offset[v + 1],
+                [&](unsigned w) {
+                   unsigned long uw = edgeOf[A.find(u, w)];
+                   unsigned long vw = edgeOf[A.find(v, w)];
+                   /** the triangle was already taken off when its first edge was peeled */
+                   if(peeled[uw] || peeled[vw])
+                      return;
+                   if(--support[uw] < needed && !queued[uw]) {
+                      queued[uw] = 1;
+                      peel.push_back(uw);
+                   }
+                   if(--support[vw] < needed && !queued[vw]) {
+                      queued[vw] = 1;
+                      peel.push_back(vw);
+                   }
+                });
+   }
+
+   std::vector<std::pair<unsigned, unsigned> > truss;
+   for(unsigned long e = 0; e < edge.size(); ++e) {
+      if(!queued[e])
+         truss.push_back(edge[e]);
+   }
+   return truss;
+}
+
+/**
+   Minimum spanning forest of the undirected graph underneath (self loops
+   ignored, the cheapest of parallel edges used).
+   Graph::kruskal sorts the edge list (one range per thread, then merged)
+   and keeps every edge joining two components of a union-find.
+   Graph::boruvka works in rounds: every node looks for its cheapest edge
+   leaving its component (in parallel over the nodes), every component
+   takes the cheapest of those, and the components are merged; the number
+   of components at least halves each round
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  forest  edges selected, as (u, v) with u < v
+   @param  method  Graph::kruskal or Graph::boruvka
+   @param  threads worker threads, 0 = all cores
+   @return total weight of the forest
+*/
+template<typename G> double
+kernels::minimumSpanningForest(const G& g, std::vector<std::pair<unsigned, unsigned> >& forest,
+                               int method, unsigned threads) {
+   GRAPH_STAT_TIMER("minimumSpanningForest");
+   const unsigned n = g.idBound();
+   const bool directed = g.isOriented();
+   forest.clear();
+   DisjointSets sets(n);
+   double total = 0;
+
+   if(method != Graph::boruvka) {
+      std::vector<Link> links;
+      for(unsigned v = 0; v < n; ++v) {
+         g.forEachOut(v, [&](unsigned w, double weight) {
+            /** undirected graphs hold both directions of every edge */
+            if(v == w || (!directed && w < v))
+               return;
+            Link link = { weight, std::min(v, w), std::max(v, w) };
+            links.push_back(link);
+         });
+      }
+      parallelSort(links, threads);
+      const std::size_t size = members(g).size();
+      for(auto l = links.begin(); l != links.end() && forest.size() + 1 < size; ++l) {
+         if(sets.unite(l->u, l->v)) {
+            forest.push_back(std::make_pair(l->u, l->v));
+            total += l->weight;
+         }
+      }
+      return total;
+   }
+
+   /** cheapest edge leaving the component of every node / component */
+   const Link none = { 0, n, n };
+   std::vector<unsigned> component(n);
+   std::vector<Link> cheapest(n), best(n);
+   for(unsigned v = 0; v < n; ++v)
+      component[v] = v;
+
+   bool merged = true;
+   while(merged) {
+      merged = false;
+      parallel::forRange(0, n, threads, [&](std::size_t from, std::size_t to, unsigned) {
+         for(std::size_t v = from; v < to; ++v) {
+            Link min = none;
+            auto consider = [&](unsigned w, double weight) {
+               Link link = { weight, std::min<unsigned>(v, w), std::max<unsigned>(v, w) };
+               if(component[w] != component[v] && (min.u == n || link < min))
+                  min = link;
+            };
+            g.forEachOut(v, consider);
+            /** in a directed graph the in-edges lead out of the component too */
+            if(directed)
+               g.forEachIn(v, consider);
+            cheapest[v] = min;
+         }
+      });
+
+      std::fill(best.begin(), best.end(), none);
+      for(unsigned v = 0; v < n; ++v) {
+         Link& b = best[component[v]];
+         if(cheapest[v].u != n && (b.u == n || cheapest[v] < b))
+            b = cheapest[v];
+      }
+      for(unsigned c = 0; c < n; ++c) {
+         if(best[c].u != n && sets.unite(best[c].u, best[c].v)) {
+            forest.push_back(std::make_pair(best[c].u, best[c].v));
+            total += best[c].weight;
+            merged = true;
+         }
+      }
+      for(unsigned v = 0; v < n; ++v)
+         component[v] = sets.find(v);
+   }
+   return total;
+}
+
+/**
+   Sum over the sources of the Brandes dependencies of every node. Each
+   thread takes a range of sources and keeps its own scratch arrays and
+   accumulator; predecessors are not stored, the backward pass finds them
+   again by testing dist[w] == dist[v] + length(v, w)
+
+   @param  g        graph with the neighbour iteration of Kernels.hh
+   @param  sources  node ids to run a single-source pass from
+   @param  weighted edge weights as lengths (Dijkstra) instead of BFS
+   @param  threads  worker threads, 0 = all cores
+   @return accumulated dependency of every node, indexed by id; empty if
+           the scope of the caller stopped it
+*/
+template<typename G> std::vector<double>
+kernels::dependencies(const G& g, const std::vector<unsigned>& sources, bool weighted,
+                      unsigned threads) {
+   const unsigned n = g.idBound();
+   std::vector<std::vector<double> > partial(parallel::threads(threads));
+   std::atomic<bool> stopped(false);
+
+   parallel::forRange(0, sources.size(), threads, 1, [&](std::size_t from, std::size_t to,
+                                                         unsigned w) {
+      std::vector<double>& centrality = partial[w];
+      centrality.assign(n, 0);
+      std::vector<double> dist(n), sigma(n), dependency(n);
+      std::vector<unsigned> order;
+      order.reserve(n);
+      typedef std::pair<double, unsigned> entry;
+      std::priority_queue<entry, std::vector<entry>, std::greater<entry> > heap;
+
+      for(std::size_t i = from; i < to; ++i) {
+         if(parallel::stopping()) {
+            stopped = true;
+            break;
+         }
+         unsigned s = sources[i];
+         std::fill(dist.begin(), dist.end(), -1);
+         std::fill(sigma.begin(), sigma.end(), 0);
+         order.clear();
+         dist[s] = 0;
+         sigma[s] = 1;
+
+         /** nodes in order of distance, with the number of shortest paths */
+         if(weighted) {
+            std::vector<char> settled(n, 0);
+            heap.push(entry(0, s));
+            while(!heap.empty()) {
+               unsigned v = heap.top().second;
+               heap.pop();
+               if(settled[v])
+                  continue;
+               settled[v] = 1;
+               order.push_back(v);
+               g.forEachOut(v, [&](unsigned t, double weight) {
+                  double d = dist[v] + weight;
+                  if(dist[t] < 0 || d < dist[t]) {
+                     dist[t] = d;
+                     sigma[t] = sigma[v];
+                     heap.push(entry(d, t));
+                  }
+                  else if(d == dist[t])
+                     sigma[t] += sigma[v];
+               });
+            }
+         }
+         else {
+            order.push_back(s);
+            for(std::size_t q = 0; q < order.size(); ++q) {
+               unsigned v = order[q];
+               const double next = dist[v] + 1, paths = sigma[v];
+               g.forEachOut(v, [&](unsigned t, double) {
+                  if(dist[t] < 0) {
+                     dist[t] = next;
+                     order.push_back(t);
+                  }
+                  if(dist[t] == next)
+                     sigma[t] += paths;
+               });
+            }
+         }
+
+         /** dependencies, farthest nodes first */
+         for(auto v = order.rbegin(); v != order.rend(); ++v) {
+            const double from = dist[*v], paths = sigma[*v];
+            double sum = 0;
+            g.forEachOut(*v, [&](unsigned t, double weight) {
+               double length = weighted ? weight : 1;
+               if(dist[t] >= 0 && dist[t] == from + length && sigma[t] > 0)
+                  sum += paths / sigma[t] * (1 + dependency[t]);
+            });
+            dependency[*v] = sum;
+            if(*v != s)
+               centrality[*v] += sum;
+         }
+      }
+   });
+   if(stopped)
+      return std::vector<double>();
+
+   std::vector<double> centrality(n, 0);
+   for(auto p = partial.begin(); p != partial.end(); ++p) {
+      for(unsigned v = 0; v < p->size(); ++v)
+         centrality[v] += (*p)[v];
+   }
+   return centrality;
+}
+
+/**
+   Exact betweenness centrality (Brandes): for every node, the number of
+   shortest paths between other pairs that go through it, each pair
+   weighted by 1 / (number of its shortest paths). In an undirected graph
+   every pair is counted once. Weighted paths need positive weights
+
+   @param  g        graph with the neighbour iteration of Kernels.hh
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @return betweenness of every node, indexed by id; empty if the scope of
+           the caller stopped it
+*/
+template<typename G> std::vector<double>
+kernels::betweenness(const G& g, bool weighted, unsigned threads) {
+   GRAPH_STAT_TIMER("betweenness");
+   std::vector<double> centrality = dependencies(g, members(g), weighted, threads);
+   if(!g.isOriented()) {
+      for(auto c = centrality.begin(); c != centrality.end(); ++c)
+         *c /= 2;
+   }
+   return centrality;
+}
+
+/**
+   Betweenness estimated from sources drawn uniformly at random among
+   the nodes (with replacement), scaled by nodes / samples. Falls back to
+   the exact computation when the bound of
+   CompactGraph::betweennessSamples asks for as many samples as nodes
+
+   @param  g        graph with the neighbour iteration of Kernels.hh
+   @param  epsilon  error bound on the normalized betweenness
+   @param  delta    probability that some node exceeds the bound
+   @param  weighted edge weights as lengths instead of edge count
+   @param  threads  worker threads, 0 = all cores
+   @param  seed     seed of the sampling
+   @return estimated betweenness of every node, indexed by id; empty if
+           the scope of the caller stopped it
+*/
+template<typename G> std::vector<double>
+kernels::approximateBetweenness(const G& g, double epsilon, double delta, bool weighted,
+                                unsigned threads, unsigned seed) {
+   std::vector<unsigned> nodes = members(g);
+   unsigned long samples = CompactGraph::betweennessSamples(nodes.size(), epsilon, delta);
+   if(samples >= nodes.size())
+      return betweenness(g, weighted, threads);
+
+   GRAPH_STAT_TIMER("approximateBetweenness");
+   std::mt19937 random(seed);
+   std::uniform_int_distribution<unsigned> pick(0, nodes.size() - 1);
+   std::vector<unsigned> sources(samples);
+   for(auto s = sources.begin(); s != sources.end(); ++s)
+      *s = nodes[pick(random)];
+
+   std::vector<double> centrality = dependencies(g, sources, weighted, threads);
+   double scale = double(nodes.size()) / samples / (g.isOriented() ? 1 : 2);
+   for(auto c = centrality.begin(); c != centrality.end(); ++c)
+      *c *= scale;
+   return centrality;
+}
+
+/**
+   Core number of every node: the largest k such that the node belongs to
+   a subgraph where every node has degree at least k. Nodes are peeled by
+   increasing remaining degree.
+   With one thread: Batagelj-Zaversnik, nodes kept sorted by degree in
+   bucket arrays and moved down one bucket per peeled neighbour, O(V + E).
+   With more: level by level, every node of degree <= k is peeled at once
+   (in parallel), and neighbours whose degree drops to k form the next
+   wave of the same level
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  order   nodes in the order they were peeled (degeneracy order)
+   @param  threads 1 = bucket algorithm, otherwise parallel peeling
+                   (0 = all cores)
+   @return core number of every node, indexed by id
+*/
+template<typename G> std::vector<unsigned>
+kernels::coreNumbers(const G& g, std::vector<unsigned>& order, unsigned threads) {
+   GRAPH_STAT_TIMER("coreNumbers");
+   SortedAdjacency A(g);
+   const unsigned n = g.idBound();
+   std::vector<unsigned> core(n, 0);
+   order.clear();
+   if(n == 0)
+      return core;
+
+   if(parallel::threads(threads) == 1) {
+      /** vert: nodes sorted by degree, pos: index of every node in vert,
+          bin[d]: first index of degree d */
+      unsigned maxDegree = 0;
+      for(unsigned v = 0; v < n; ++v) {
+         core[v] = A.degree(v);
+         maxDegree = std::max(maxDegree, core[v]);
+      }
+      std::vector<unsigned> bin(maxDegree + 1, 0), vert(n), pos(n);
+      for(unsigned v = 0; v < n; ++v)
+         ++bin[core[v]];
+      for(unsigned d = 0, start = 0; d <= maxDegree; ++d) {
+         unsigned count = bin[d];
+         bin[d] = start;
+         start += count;
+      }
+      for(unsigned v = 0; v < n; ++v) {
+         pos[v] = bin[core[v]]++;
+         vert[pos[v]] = v;
+      }
+      for(unsigned d = maxDegree; d > 0; --d)
+         bin[d] = bin[d - 1];
+      bin[0] = 0;
+
+      for(unsigned i = 0; i < n; ++i) {
+         unsigned v = vert[i];
+         for(unsigned long e = A.offset[v]; e < A.offset[v + 1]; ++e) {
+            unsigned u = A.adjacent[e];
+            if(core[u] <= core[v])
+               continue;
+            /** swap u with the first node of its bucket and shrink it */
+            unsigned first = vert[bin[core[u]]];
+            if(first != u) {
+               std::swap(vert[pos[u]], vert[bin[core[u]]]);
+               pos[first] = pos[u];
+               pos[u] = bin[core[u]];
+            }
+            ++bin[core[u]];
+            --core[u];
+         }
+      }
+      order.assign(vert.begin(), vert.end());
+   }
+   else {
+      std::vector<std::atomic<unsigned> > degree(n);
+      std::vector<char> peeled(n, 0);
+      for(unsigned v = 0; v < n; ++v)
+         degree[v].store(A.degree(v));
+      std::vector<std::vector<unsigned> > next(parallel::threads(threads));
+
+      for(unsigned k = 0; order.size() < n; ++k) {
+         std::vector<unsigned> wave;
+         for(unsigned v = 0; v < n; ++v) {
+            if(!peeled[v] && degree[v].load() <= k)
+               wave.push_back(v);
+         }
+         while(!wave.empty()) {
+            for(auto v = wave.begin(); v != wave.end(); ++v) {
+               peeled[*v] = 1;
+               core[*v] = k;
+            }
+            order.insert(order.end(), wave.begin(), wave.end());
+
+            parallel::forRange(0, wave.size(), threads, 64, [&](std::size_t from, std::size_t to,
+                                                               unsigned w) {
+               next[w].clear();
+               for(std::size_t i = from; i < to; ++i) {
+                  unsigned v = wave[i];
+                  for(unsigned long e = A.offset[v]; e < A.offset[v + 1]; ++e) {
+                     unsigned u = A.adjacent[e];
+                     /** only the thread taking u from k + 1 to k queues it */
+                     if(!peeled[u] && degree[u].fetch_sub(1) == k + 1)
+                        next[w].push_back(u);
+                  }
+               }
+            });
+            wave.clear();
+            for(auto w = next.begin(); w != next.end(); ++w) {
+               wave.insert(wave.end(), w->begin(), w->end());
+               w->clear();
+            }
+         }
+      }
+   }
+   /** ids outside g have no neighbour and were peeled first */
+   order.erase(std::remove_if(order.begin(), order.end(),
+                              [&](unsigned v) { return !g.contains(v); }), order.end());
+   return core;
+}
+
+/**
+   @return is any lane set?
+*/
+inline bool
+kernels::Lanes::any() const {
+   std::uint64_t bits = 0;
+   for(unsigned i = 0; i < width / 64; ++i)
+      bits |= word[i];
+   return bits != 0;
+}
+
+/**
+   @return is lane set?
+*/
+inline bool
+kernels::Lanes::test(unsigned lane) const {
+   return (word[lane / 64] >> (lane % 64)) & 1;
+}
+
+/**
+   @return void
+*/
+inline void
+kernels::Lanes::set(unsigned lane) {
+   word[lane / 64] |= std::uint64_t(1) << (lane % 64);
+}
+
+/**
+   @param  fn callable invoked as fn(unsigned) for every lane set
+   @return void
+*/
+template<typename F> void
+kernels::Lanes::forEach(F fn) const {
+   for(unsigned i = 0; i < width / 64; ++i) {
+      for(std::uint64_t bits = word[i]; bits; bits &= bits - 1) {
+         unsigned lane = 0;
+         while(!((bits >> lane) & 1))
+            ++lane;
+         fn(i * 64 + lane);
+      }
+   }
+}
+
+/**
+   Multi-source BFS (Then et al.): up to Lanes::width sources advance
+   together, every node keeps one bit per source in seen / visit, so
+   a node reached by several sources at the same depth is expanded
+   once for all of them.
+   found(depth, v, lanes) is called with the sources reaching v at
+   depth for the first time; the pass stops early when done() is true
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  sources node ids, at most Lanes::width
+   @return void
+*/
+template<typename G, typename Found, typename Done> void
+kernels::multiSourceBFS(const G& g, const unsigned* sources, unsigned count,
+                        Found found, Done done) {
+   const unsigned n = g.idBound();
+   const unsigned words = Lanes::width / 64;
+   Lanes none;
+   std::fill(none.word, none.word + words, 0);
+   std::vector<Lanes> seen(n, none), visit(n, none), next(n, none);
+
+   for(unsigned i = 0; i < count; ++i) {
+      seen[sources[i]].set(i);
+      visit[sources[i]].set(i);
+   }
+   for(unsigned v = 0; v < n; ++v) {
+      if(visit[v].any())
+         found(0u, v, visit[v]);
+   }
+
+   for(unsigned depth = 1; !done(); ++depth) {
+      for(unsigned v = 0; v < n; ++v) {
+         if(!visit[v].any())
+            continue;
+         g.forEachOut(v, [&](unsigned w, double) {
+            Lanes& target = next[w];
+            for(unsigned i = 0; i < words; ++i)
+               target.word[i] |= visit[v].word[i];
+         });
+      }
+
+      bool advanced = false;
+      for(unsigned v = 0; v < n; ++v) {
+         for(unsigned i = 0; i < words; ++i) {
+            visit[v].word[i] = next[v].word[i] & ~seen[v].word[i];
+            seen[v].word[i] |= visit[v].word[i];
+            next[v].word[i] = 0;
+         }
+         if(visit[v].any()) {
+            found(depth, v, visit[v]);
+            advanced = true;
+         }
+      }
+      if(!advanced)
+         break;
+   }
+}
+
+/**
+   Hop distances from every source. The sources are split in batches of
+   Lanes::width that share one multi-source BFS pass; batches run in
+   parallel
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  sources node ids
+   @param  threads worker threads, 0 = all cores
+   @return distance[i][v] from sources[i] to v, CompactGraph::unreachable
+           if not reached; empty if the scope of the caller stopped it
+*/
+template<typename G> std::vector<std::vector<unsigned> >
+kernels::distances(const G& g, const std::vector<unsigned>& sources, unsigned threads) {
+   GRAPH_STAT_TIMER("distances");
+   std::vector<std::vector<unsigned> > distance(sources.size(),
+                                                std::vector<unsigned>(g.idBound(),
+                                                                      CompactGraph::unreachable));
+   std::vector<unsigned> valid;
+   for(unsigned i = 0; i < sources.size(); ++i) {
+      if(g.contains(sources[i]))
+         valid.push_back(i);
+   }
+   std::size_t batches = (valid.size() + Lanes::width - 1) / Lanes::width;
+   std::atomic<bool> stopped(false);
+
+   parallel::forRange(0, batches, threads, 1, [&](std::size_t from, std::size_t to, unsigned) {
+      for(std::size_t b = from; b < to; ++b) {
+         if(parallel::stopping()) {
+            stopped = true;
+            break;
+         }
+         std::size_t first = b * Lanes::width;
+         unsigned count = std::min<std::size_t>(Lanes::width, valid.size() - first);
+         std::vector<unsigned> batch(count);
+         for(unsigned i = 0; i < count; ++i)
+            batch[i] = sources[valid[first + i]];
+         multiSourceBFS(g, &batch[0], count,
+                        [&](unsigned depth, unsigned v, const Lanes& lanes) {
+                           lanes.forEach([&](unsigned lane) {
+                              distance[valid[first + lane]][v] = depth;
+                           });
+                        },
+                        []() { return false; });
+      }
+   });
+   if(stopped)
+      return std::vector<std::vector<unsigned> >();
+   return distance;
+}
+
+/**
+   Answer a batch of "can u reach v?" queries. Queries are grouped by
+   source, Lanes::width distinct sources per multi-source BFS pass, and
+   a pass stops as soon as all of its queries are answered
+
+   @param  g       graph with the neighbour iteration of Kernels.hh
+   @param  queries (u, v) node id pairs
+   @param  threads worker threads, 0 = all cores
+   @return 1 if u reaches v, for every query in order; empty if the scope
+           of the caller stopped it before every query was answered
+*/
+template<typename G> std::vector<char>
+kernels::reachable(const G& g, const std::vector<std::pair<unsigned, unsigned> >& queries,
+                   unsigned threads) {
+   GRAPH_STAT_TIMER("reachable");
+   std::vector<char> answer(queries.size(), 0);
+   /** distinct sources, and the queries of every source */
+   std::map<unsigned, std::vector<std::size_t> > bySource;
+   for(std::size_t q = 0; q < queries.size(); ++q) {
+      if(g.contains(queries[q].first) && g.contains(queries[q].second))
+         bySource[queries[q].first].push_back(q);
+   }
+   std::vector<std::pair<unsigned, const std::vector<std::size_t>*> > sources;
+   for(auto s = bySource.begin(); s != bySource.end(); ++s)
+      sources.push_back(std::make_pair(s->first, &s->second));
+   std::size_t batches = (sources.size() + Lanes::width - 1) / Lanes::width;
+   std::atomic<bool> stopped(false);
+
+   parallel::forRange(0, batches, threads, 1, [&](std::size_t from, std::size_t to, unsigned) {
+      for(std::size_t b = from; b < to; ++b) {
+         if(parallel::stopping()) {
+            stopped = true;
+            break;
+         }
+         std::size_t first = b * Lanes::width;
+         unsigned count = std::min<std::size_t>(Lanes::width, sources.size() - first);
+         std::vector<unsigned> batch(count);
+         /** (lane, query) pairs asking about each target */
+         std::map<unsigned, std::vector<std::pair<unsigned, std::size_t> > > askers;
+         std::size_t pending = 0;
+         for(unsigned i = 0; i < count; ++i) {
+            batch[i] = sources[first + i].first;
+            const std::vector<std::size_t>& asked = *sources[first + i].second;
+            for(auto q = asked.begin(); q != asked.end(); ++q) {
+               askers[queries[*q].second].push_back(std::make_pair(i, *q));
+               ++pending;
+            }
+         }
+         multiSourceBFS(g, &batch[0], count,
+                        [&](unsigned, unsigned v, const Lanes& lanes) {
+                           auto a = askers.find(v);
+                           if(a == askers.end())
+                              return;
+                           for(auto q = a->second.begin(); q != a->second.end(); ++q) {
+                              if(lanes.test(q->first)) {
+                                 answer[q->second] = 1;
+                                 --pending;
+                              }
+                           }
+                        },
+                        [&]() { return pending == 0; });
+      }
+   });
+   if(stopped)
+      return std::vector<char>();
+   return answer;
+}
+
+#endif
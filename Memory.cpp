@@ -0,0 +1,222 @@
+/*
+   @file    Memory.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include "Memory.hh"
+#include "Stats.hh"
+
+using namespace GraphLib;
+
+/**
+   @param  bytes     size of the block
+   @param  alignment alignment of the block
+   @return pointer to the block
+*/
+void* MemoryResource::allocate(std::size_t bytes, std::size_t alignment) {
+   GRAPH_STAT_COUNT("memory", allocations, 1);
+   return _allocate(bytes, alignment);
+}
+
+/**
+   @param  p         block returned by allocate
+   @param  bytes     size of the block
+   @param  alignment alignment of the block
+   @return void
+*/
+void MemoryResource::deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+   _deallocate(p, bytes, alignment);
+}
+
+/**
+   @return can memory allocated by other be freed by this resource?
+*/
+bool MemoryResource::isEqual(const MemoryResource& other) const {
+   return _isEqual(other);
+}
+
+/**
+   By default only a resource can free its own memory
+
+   @return bool
+*/
+bool MemoryResource::_isEqual(const MemoryResource& other) const {
+   return this == &other;
+}
+
+namespace {
+   /** operator new/delete behind the MemoryResource interface */
+   class NewDeleteResource : public MemoryResource {
+      void* _allocate(std::size_t bytes, std::size_t) {
+         return ::operator new(bytes);
+      }
+      void _deallocate(void* p, std::size_t, std::size_t) {
+         ::operator delete(p);
+      }
+   };
+
+   /** round p up to a multiple of alignment */
+   char* alignUp(char* p, std::size_t alignment) {
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+      return p + (alignment - address % alignment) % alignment;
+   }
+}
+
+/**
+   @return MemoryResource
+*/
+MemoryResource* GraphLib::newDeleteResource() {
+   static NewDeleteResource resource;
+   return &resource;
+}
+
+/**
+   @return MemoryResource
+*/
+MemoryResource* GraphLib::scratchResource() {
+   static thread_local PoolResource pool;
+   return &pool;
+}
+
+/**
+   Constructor
+
+   @param  initialSize size of the first block
+   @param  upstream    where the blocks come from
+*/
+MonotonicResource::MonotonicResource(std::size_t initialSize, MemoryResource* upstream)
+   : _upstream(upstream), _nextSize(initialSize), _current(0), _left(0) {
+}
+
+/**
+   Distructor, frees every block
+*/
+MonotonicResource::~MonotonicResource() {
+   release();
+}
+
+/**
+   Give every block back to the upstream resource
+
+   @return void
+*/
+void MonotonicResource::release() {
+   for(auto b = _blocks.begin(); b != _blocks.end(); ++b)
+      _upstream->deallocate(b->first, b->second);
+   _blocks.clear();
+   _current = 0;
+   _left = 0;
+}
+
+/**
+   Carve the next bytes out of the current block, starting a block twice
+   as big when it is exhausted
+
+   @return void*
+*/
+void* MonotonicResource::_allocate(std::size_t bytes, std::size_t alignment) {
+   char* p = _current ? alignUp(_current, alignment) : 0;
+   if(!p || static_cast<std::size_t>(p - _current) + bytes > _left) {
+      std::size_t size = std::max(_nextSize, bytes + alignment);
+      _current = static_cast<char*>(_upstream->allocate(size));
+      _blocks.push_back(std::make_pair(static_cast<void*>(_current), size));
+      _left = size;
+      _nextSize = size * 2;
+      p = alignUp(_current, alignment);
+   }
+   _left -= (p - _current) + bytes;
+   _current = p + bytes;
+   return p;
+}
+
+/**
+   Nothing to do, the memory is reclaimed by release()
+
+   @return void
+*/
+void MonotonicResource::_deallocate(void*, std::size_t, std::size_t) {
+}
+
+/**
+   Constructor
+
+   @param  upstream where the chunks come from
+*/
+PoolResource::PoolResource(MemoryResource* upstream) : _upstream(upstream) {
+   for(unsigned i = 0; i < pools; ++i)
+      _free[i] = 0;
+}
+
+/**
+   Distructor, frees every chunk
+*/
+PoolResource::~PoolResource() {
+   release();
+}
+
+/**
+   Give every chunk back to the upstream resource
+
+   @return void
+*/
+void PoolResource::release() {
+   for(auto c = _chunks.begin(); c != _chunks.end(); ++c)
+      _upstream->deallocate(*c, chunkSize);
+   _chunks.clear();
+   for(unsigned i = 0; i < pools; ++i)
+      _free[i] = 0;
+}
+
+/**
+   @param  bytes size of the block
+   @return size class (block size 16 << class), pools if too big
+*/
+unsigned PoolResource::_pool(std::size_t bytes) {
+   unsigned pool = 0;
+   while(pool < pools && (std::size_t(16) << pool) < bytes)
+      ++pool;
+   return pool;
+}
+
+/**
+   Pop a block from the free list of its size class, cutting a new chunk
+   into blocks when the list is empty
+
+   @return void*
+*/
+void* PoolResource::_allocate(std::size_t bytes, std::size_t alignment) {
+   unsigned pool = _pool(bytes);
+   if(pool == pools || alignment > 16)
+      return _upstream->allocate(bytes, alignment);
+
+   if(!_free[pool]) {
+      std::size_t block = std::size_t(16) << pool;
+      char* chunk = static_cast<char*>(_upstream->allocate(chunkSize));
+      _chunks.push_back(chunk);
+      for(std::size_t offset = 0; offset + block <= chunkSize; offset += block) {
+         *reinterpret_cast<void**>(chunk + offset) = _free[pool];
+         _free[pool] = chunk + offset;
+      }
+   }
+   void* p = _free[pool];
+   _free[pool] = *static_cast<void**>(p);
+   return p;
+}
+
+/**
+   Push the block back on the free list of its size class
+
+   @return void
+*/
+void PoolResource::_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+   unsigned pool = _pool(bytes);
+   if(pool == pools || alignment > 16) {
+      _upstream->deallocate(p, bytes, alignment);
+      return;
+   }
+   *static_cast<void**>(p) = _free[pool];
+   _free[pool] = p;
+}
@@ -0,0 +1,142 @@
+/*
+   @file    Memory.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef GRAPH_MEMORY_HH
+#define GRAPH_MEMORY_HH 1
+
+#include <cstddef>
+#include <vector>
+
+namespace GraphLib {
+
+/** Source of memory for the containers of a Graph, modelled on
+    std::pmr::memory_resource (which needs C++17)
+*/
+class MemoryResource {
+
+public:
+   virtual ~MemoryResource() {}
+
+   void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+   void  deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+   bool  isEqual(const MemoryResource& other) const;
+
+private:
+   virtual void* _allocate(std::size_t bytes, std::size_t alignment) = 0;
+   virtual void  _deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+   virtual bool  _isEqual(const MemoryResource& other) const;
+
+/** class MemoryResource */
+};
+
+/** global operator new/delete */
+MemoryResource* newDeleteResource();
+/** per thread pool used by the algorithms for their scratch containers */
+MemoryResource* scratchResource();
+
+/** Arena for build-once graphs: memory is carved sequentially out of
+    growing blocks, deallocate does nothing and everything is given back
+    at once by release() or by the destructor. The arena must outlive
+    every Graph that uses it
+*/
+class MonotonicResource : public MemoryResource {
+
+public:
+   explicit MonotonicResource(std::size_t initialSize = 4096,
+                              MemoryResource* upstream = newDeleteResource());
+   MonotonicResource(const MonotonicResource&) = delete;
+   MonotonicResource& operator=(const MonotonicResource&) = delete;
+   ~MonotonicResource();
+
+   void release();
+
+private:
+   MemoryResource* _upstream;
+   /** eg. {<block1, size1>, <block2, size2>, ...} */
+   std::vector<std::pair<void*, std::size_t> > _blocks;
+   std::size_t _nextSize;
+   char*       _current;
+   std::size_t _left;
+
+   void* _allocate(std::size_t bytes, std::size_t alignment);
+   void  _deallocate(void* p, std::size_t bytes, std::size_t alignment);
+
+/** class MonotonicResource */
+};
+
+/** Pool of fixed size blocks: freed blocks go to a free list per size
+    class and are handed out again, so containers that are rebuilt over
+    and over (BFS/DFS visited sets, queues) stop hitting malloc.
+    Not thread safe: use one pool per thread
+*/
+class PoolResource : public MemoryResource {
+
+public:
+   explicit PoolResource(MemoryResource* upstream = newDeleteResource());
+   PoolResource(const PoolResource&) = delete;
+   PoolResource& operator=(const PoolResource&) = delete;
+   ~PoolResource();
+
+   void release();
+
+private:
+   /** size classes 16, 32, ..., 4096 bytes; larger blocks go upstream */
+   static const unsigned    pools = 9;
+   static const std::size_t chunkSize = 64 * 1024;
+
+   MemoryResource*    _upstream;
+   void*              _free[pools];
+   std::vector<void*> _chunks;
+
+   static unsigned _pool(std::size_t bytes);
+   void* _allocate(std::size_t bytes, std::size_t alignment);
+   void  _deallocate(void* p, std::size_t bytes, std::size_t alignment);
+
+/** class PoolResource */
+};
+
+/** Allocator drawing from a MemoryResource, modelled on
+    std::pmr::polymorphic_allocator. Copies share the resource
+*/
+template<typename T>
+class ResourceAllocator {
+
+public:
+   typedef T value_type;
+
+   ResourceAllocator() : _resource(newDeleteResource()) {}
+   ResourceAllocator(MemoryResource* resource) : _resource(resource) {}
+   template<typename U>
+   ResourceAllocator(const ResourceAllocator<U>& other) : _resource(other.resource()) {}
+
+   T* allocate(std::size_t n) {
+      return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+   }
+   void deallocate(T* p, std::size_t n) {
+      _resource->deallocate(p, n * sizeof(T), alignof(T));
+   }
+
+   MemoryResource* resource() const { return _resource; }
+
+private:
+   MemoryResource* _resource;
+
+/** class ResourceAllocator */
+};
+
+template<typename T, typename U>
+inline bool operator==(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b) {
+   return a.resource() == b.resource() || a.resource()->isEqual(*b.resource());
+}
+
+template<typename T, typename U>
+inline bool operator!=(const ResourceAllocator<T>& a, const ResourceAllocator<U>& b) {
+   return !(a == b);
+}
+
+/** namespace GraphLib */
+}
+
+#endif //GRAPH_MEMORY_HH
@@ -0,0 +1,322 @@
+/*
+   @file    Parallel.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include "Parallel.hh"
+
+using namespace GraphLib;
+using namespace GraphLib::parallel;
+
+namespace {
+   /** pool and deque of the calling thread, if it is a worker */
+   thread_local const Scheduler* currentPool = 0;
+   thread_local unsigned         currentQueue = 0;
+
+   /**
+      @return one thread per core
+   */
+   unsigned cores() {
+      unsigned n = std::thread::hardware_concurrency();
+      return n > 0 ? n : 1;
+   }
+}
+
+/**
+   @return limits of the calling thread
+*/
+Context& parallel::context() {
+   static thread_local Context current;
+   return current;
+}
+
+/**
+   @return was a scope of the caller cancelled, or is its deadline past?
+*/
+bool parallel::cancelled() {
+   const Context& c = context();
+   for(auto flag = c.cancel.begin(); flag != c.cancel.end(); ++flag) {
+      if((*flag)->load())
+         return true;
+   }
+   return c.deadline != clock::time_point::max() && clock::now() >= c.deadline;
+}
+
+/**
+   @return cancelled(); if true, every scope of the caller is marked
+           interrupted
+*/
+bool parallel::stopping() {
+   if(!cancelled())
+      return false;
+   const Context& c = context();
+   for(auto flag = c.interrupted.begin(); flag != c.interrupted.end(); ++flag)
+      (*flag)->store(true);
+   return true;
+}
+
+/**
+   @param  requested number of threads asked by the caller, 0 = all of the pool
+   @return number of threads to use, within the limit of the scope
+*/
+unsigned parallel::threads(unsigned requested) {
+   unsigned n = requested > 0 ? requested : Scheduler::instance().size();
+   if(context().limit > 0)
+      n = std::min(n, context().limit);
+   return std::max(n, 1u);
+}
+
+/**
+   @param  threads number of threads of the pool, 0 = one per core
+   @return void
+*/
+void parallel::configure(unsigned threads) {
+   Scheduler::instance().resize(threads);
+}
+
+/**
+   Constructor
+
+   @param  limit most threads per parallel call, 0 = as the enclosing scope
+*/
+Scope::Scope(unsigned limit) : _previous(context()) {
+   _enter(limit, 0, 0);
+}
+
+/**
+   Constructor
+
+   @param  limit        most threads per parallel call, 0 = as the enclosing scope
+   @param  cancellation stops the calls made in the scope once cancelled
+*/
+Scope::Scope(unsigned limit, const Cancellation& cancellation) : _previous(context()) {
+   _enter(limit, &cancellation, 0);
+}
+
+/**
+   Constructor
+
+   @param  limit   most threads per parallel call, 0 = as the enclosing scope
+   @param  timeout the calls made in the scope stop once it has elapsed
+*/
+Scope::Scope(unsigned limit, clock::duration timeout) : _previous(context()) {
+   _enter(limit, 0, &timeout);
+}
+
+/**
+   Constructor
+
+   @param  limit        most threads per parallel call, 0 = as the enclosing scope
+   @param  cancellation stops the calls made in the scope once cancelled
+   @param  timeout      the calls made in the scope stop once it has elapsed
+*/
+Scope::Scope(unsigned limit, const Cancellation& cancellation, clock::duration timeout)
+   : _previous(context()) {
+   _enter(limit, &cancellation, &timeout);
+}
+
+/**
+   Destructor, the limits of the enclosing scope apply again
+*/
+Scope::~Scope() {
+   context() = _previous;
+}
+
+/**
+   @return void
+*/
+void Scope::_enter(unsigned limit, const Cancellation* cancellation,
+                   const clock::duration* timeout) {
+   Context& c = context();
+   _interrupted = std::make_shared<std::atomic<bool> >(false);
+   c.interrupted.push_back(_interrupted);
+   if(limit > 0)
+      c.limit = c.limit > 0 ? std::min(c.limit, limit) : limit;
+   if(cancellation)
+      c.cancel.push_back(cancellation->_flag);
+   if(timeout) {
+      clock::time_point now = clock::now();
+      if(*timeout < clock::time_point::max() - now)
+         c.deadline = std::min(c.deadline, now + *timeout);
+   }
+}
+
+/**
+   @return the pool shared by the library, one thread per core by default
+*/
+Scheduler& Scheduler::instance() {
+   static Scheduler pool(cores());
+   return pool;
+}
+
+/**
+   Constructor
+
+   @param  threads number of workers, 0 = one per core
+*/
+Scheduler::Scheduler(unsigned threads) : _next(0), _pending(0), _stop(false) {
+   _start(threads);
+}
+
+/**
+   Destructor, runs the queued tasks and joins the workers
+*/
+Scheduler::~Scheduler() {
+   _stopAll();
+}
+
+/**
+   @param  threads number of workers, 0 = one per core
+   @return void
+*/
+void Scheduler::resize(unsigned threads) {
+   _stopAll();
+   _start(threads);
+}
+
+/**
+   @return void
+*/
+void Scheduler::_start(unsigned threads) {
+   if(threads == 0)
+      threads = cores();
+   _stop = false;
+   _queues.clear();
+   for(unsigned i = 0; i < threads; ++i)
+      _queues.push_back(std::unique_ptr<Queue>(new Queue()));
+   for(unsigned i = 0; i < threads; ++i)
+      _threads.push_back(std::thread(&Scheduler::_work, this, i));
+}
+
+/**
+   @return void
+*/
+void Scheduler::_stopAll() {
+   {
+      std::lock_guard<std::mutex> lock(_sleep);
+      _stop = true;
+   }
+   _wake.notify_all();
+   for(auto t = _threads.begin(); t != _threads.end(); ++t)
+      t->join();
+   _threads.clear();
+}
+
+/**
+   Queue a task: a worker pushes on its own deque, other threads spread
+   their tasks over the deques
+
+   @param  task callable without arguments
+   @return void
+*/
+void Scheduler::submit(std::function<void()> task) {
+   Context caller = context();
+   std::function<void()> scoped = [caller, task]() {
+      Context saved = context();
+      context() = caller;
+      task();
+      context() = saved;
+   };
+   unsigned q = currentPool == this ? currentQueue : _next++ % _queues.size();
+   {
+      std::lock_guard<std::mutex> lock(_sleep);
+      ++_pending;
+   }
+   {
+      std::lock_guard<std::mutex> lock(_queues[q]->lock);
+      _queues[q]->tasks.push_back(scoped);
+   }
+   _wake.notify_one();
+}
+
+/**
+   Take the newest task of the own deque, else steal the oldest of another
+
+   @param  task the task taken
+   @return false if every deque was empty
+*/
+bool Scheduler::_take(std::function<void()>& task) {
+   const unsigned n = _queues.size();
+   const bool worker = currentPool == this;
+   if(worker) {
+      Queue& own = *_queues[currentQueue];
+      std::lock_guard<std::mutex> lock(own.lock);
+      if(!own.tasks.empty()) {
+         task.swap(own.tasks.back());
+         own.tasks.pop_back();
+      }
+   }
+   unsigned start = worker ? currentQueue + 1 : _next.load();
+   for(unsigned i = 0; !task && i < n; ++i) {
+      Queue& other = *_queues[(start + i) % n];
+      std::lock_guard<std::mutex> lock(other.lock);
+      if(!other.tasks.empty()) {
+         task.swap(other.tasks.front());
+         other.tasks.pop_front();
+      }
+   }
+   if(!task)
+      return false;
+   std::lock_guard<std::mutex> lock(_sleep);
+   --_pending;
+   return true;
+}
+
+/**
+   @return false if there was no task to run
+*/
+bool Scheduler::runOne() {
+   std::function<void()> task;
+   if(!_take(task))
+      return false;
+   task();
+   return true;
+}
+
+/**
+   Worker loop: run tasks, sleep while there are none
+
+   @param  index deque of the worker
+   @return void
+*/
+void Scheduler::_work(unsigned index) {
+   currentPool = this;
+   currentQueue = index;
+   while(true) {
+      if(runOne())
+         continue;
+      std::unique_lock<std::mutex> lock(_sleep);
+      _wake.wait(lock, [this]() { return _stop || _pending > 0; });
+      if(_stop && _pending == 0)
+         return;
+   }
+}
+
+/**
+   @return void
+*/
+void Latch::done() {
+   std::lock_guard<std::mutex> lock(_lock);
+   if(--_left == 0)
+      _zero.notify_all();
+}
+
+/**
+   Run queued tasks while some are left, then sleep until the last done()
+
+   @return void
+*/
+void Latch::wait() {
+   Scheduler& pool = Scheduler::instance();
+   while(true) {
+      {
+         std::lock_guard<std::mutex> lock(_lock);
+         if(_left == 0)
+            return;
+      }
+      if(!pool.runOne())
+         break;
+   }
+   std::unique_lock<std::mutex> lock(_lock);
+   _zero.wait(lock, [this]() { return _left == 0; });
+}
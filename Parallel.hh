@@ -0,0 +1,243 @@
+/*
+   @file    Parallel.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef GRAPH_PARALLEL_HH
+#define GRAPH_PARALLEL_HH 1
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace GraphLib {
+
+/** helpers to split the loops of the algorithms over threads. Every
+    parallel loop of the library runs on one shared work-stealing pool,
+    so concurrent calls share its threads instead of each starting their
+    own; a Scope bounds the threads, the time and the life of the calls
+    made inside it
+*/
+namespace parallel {
+
+   typedef std::chrono::steady_clock clock;
+
+   /** cancelled by whoever holds a copy, eg. a request handler */
+   class Cancellation {
+   public:
+      Cancellation() : _flag(std::make_shared<std::atomic<bool> >(false)) {}
+      void cancel() { _flag->store(true); }
+      bool cancelled() const { return _flag->load(); }
+
+   private:
+      friend class Scope;
+      std::shared_ptr<std::atomic<bool> > _flag;
+   };
+
+   /** limits in force on a thread, carried over to the tasks it schedules */
+   struct Context {
+      /** most threads per parallel call, 0 = no limit */
+      unsigned                                          limit;
+      /** cancellations of the enclosing scopes */
+      std::vector<std::shared_ptr<std::atomic<bool> > > cancel;
+      /** set when a call of the enclosing scopes stopped early */
+      std::vector<std::shared_ptr<std::atomic<bool> > > interrupted;
+      clock::time_point                                 deadline;
+
+      Context() : limit(0), deadline(clock::time_point::max()) {}
+   };
+
+   /** Limits of the calls made on this thread (and on the tasks they
+       schedule) while the scope lives; scopes nest, the inner limits can
+       only tighten the outer ones. Long running algorithms check
+       stopping() between their iterations; a call that stops early marks
+       its scopes interrupted(). Iterative ones (PageRank, Pregel) then
+       return their last iterate, the ones whose partial answer would read
+       as a real one (reachable, distances, betweenness) return an empty
+       result. Open a scope per call to tell which one stopped
+   */
+   class Scope {
+   public:
+      explicit Scope(unsigned limit = 0);
+      Scope(unsigned limit, const Cancellation& cancellation);
+      Scope(unsigned limit, clock::duration timeout);
+      Scope(unsigned limit, const Cancellation& cancellation, clock::duration timeout);
+      ~Scope();
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+      /** did a call made in the scope stop before its end? */
+      bool interrupted() const { return _interrupted->load(); }
+
+   private:
+      Context _previous;
+      std::shared_ptr<std::atomic<bool> > _interrupted;
+
+      void _enter(unsigned limit, const Cancellation* cancellation,
+                  const clock::duration* timeout);
+   };
+
+   /** limits of the calling thread */
+   Context& context();
+
+   /** did the scope of the caller get cancelled or pass its deadline? */
+   bool cancelled();
+
+   /** cancelled(), marking the scopes of the caller interrupted if so: the
+       check of the loops that stop early on it */
+   bool stopping();
+
+   /**
+      @param  requested number of threads asked by the caller, 0 = all of the pool
+      @return number of threads to use, within the limit of the scope
+   */
+   unsigned threads(unsigned requested);
+
+   /** resize the pool (default: one thread per core); only while no
+       parallel call is running */
+   void configure(unsigned threads);
+
+   /** Work-stealing pool: one task deque per worker, the owner takes
+       from the back (last in, first out: nested loops stay on one core)
+       and idle workers steal from the front of the others. Threads that
+       wait for their tasks run queued ones meanwhile, so nested parallel
+       calls and calls from many threads can't deadlock the pool
+   */
+   class Scheduler {
+   public:
+      static Scheduler& instance();
+
+      explicit Scheduler(unsigned threads);
+      ~Scheduler();
+
+      Scheduler(const Scheduler&) = delete;
+      Scheduler& operator=(const Scheduler&) = delete;
+
+      unsigned size() const { return _threads.size(); }
+      void     resize(unsigned threads);
+      /** runs task on the pool with the context of the caller */
+      void     submit(std::function<void()> task);
+      /** runs one queued task on the calling thread, false if none */
+      bool     runOne();
+
+   private:
+      struct Queue {
+         std::mutex                         lock;
+         std::deque<std::function<void()> > tasks;
+      };
+
+      std::vector<std::unique_ptr<Queue> > _queues;
+      std::vector<std::thread>             _threads;
+      std::atomic<unsigned>                _next;
+      /** tasks queued and not taken yet (counted before they are queued) */
+      unsigned long                        _pending;
+      std::mutex                           _sleep;
+      std::condition_variable              _wake;
+      bool                                 _stop;
+
+      void _start(unsigned threads);
+      void _stopAll();
+      void _work(unsigned index);
+      bool _take(std::function<void()>& task);
+   };
+
+   /** waits until count tasks called done(), running queued tasks meanwhile */
+   class Latch {
+   public:
+      explicit Latch(unsigned count) : _left(count) {}
+      void done();
+      void wait();
+
+   private:
+      unsigned                _left;
+      std::mutex              _lock;
+      std::condition_variable _zero;
+   };
+
+   /**
+      Split [begin, end) in one contiguous range per thread and call
+      fn(from, to, worker) on each of them; returns when all are done.
+      The first range runs on the calling thread, the others are tasks
+      of the pool. A range is only made for every grain indices, so small
+      ranges run on the calling thread
+
+      @param  begin   first index
+      @param  end     one past the last index
+      @param  workers number of threads, 0 = all of the pool
+      @param  grain   fewest indices worth a thread
+      @param  fn      callable invoked as fn(std::size_t, std::size_t, unsigned)
+      @return number of ranges (workers actually used)
+   */
+   template<typename F>
+   unsigned forRange(std::size_t begin, std::size_t end, unsigned workers,
+                     std::size_t grain, F fn) {
+      grain = std::max<std::size_t>(grain, 1);
+      std::size_t size = end > begin ? end - begin : 0;
+      unsigned n = std::min<std::size_t>(threads(workers), (size + grain - 1) / grain);
+      if(n <= 1) {
+         fn(begin, end, 0u);
+         return 1;
+      }
+
+      Scheduler& pool = Scheduler::instance();
+      Latch latch(n - 1);
+      std::size_t chunk = (size + n - 1) / n;
+      for(unsigned w = 1; w < n; ++w) {
+         std::size_t from = std::min(end, begin + w * chunk);
+         std::size_t to = std::min(end, from + chunk);
+         pool.submit([&fn, &latch, from, to, w]() {
+            fn(from, to, w);
+            latch.done();
+         });
+      }
+      fn(begin, std::min(end, begin + chunk), 0u);
+      latch.wait();
+      return n;
+   }
+
+   /**
+      forRange with a grain of 1024 indices, for cheap loop bodies
+
+      @return number of ranges (workers actually used)
+   */
+   template<typename F>
+   unsigned forRange(std::size_t begin, std::size_t end, unsigned workers, F fn) {
+      return forRange(begin, end, workers, 1024, fn);
+   }
+
+   /**
+      Run fn() on the pool, eg. independent queries on the same read-only
+      graph; the scope of the caller applies to it. Don't wait for the
+      future from inside a task of the pool
+
+      @param  fn callable without arguments
+      @return future of its result
+   */
+   template<typename F>
+   std::future<typename std::result_of<F()>::type> async(F fn) {
+      typedef typename std::result_of<F()>::type result;
+      std::shared_ptr<std::packaged_task<result()> > task =
+         std::make_shared<std::packaged_task<result()> >(fn);
+      std::future<result> future = task->get_future();
+      Scheduler::instance().submit([task]() { (*task)(); });
+      return future;
+   }
+
+/** namespace parallel */
+}
+
+/** namespace GraphLib */
+}
+
+#endif //GRAPH_PARALLEL_HH
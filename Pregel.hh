@@ -0,0 +1,143 @@
+/*
+   @file    Pregel.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef PREGEL_HH
+#define PREGEL_HH 1
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "CompactGraph.hh"
+#include "Parallel.hh"
+
+namespace GraphLib {
+
+/** Vertex-centric bulk synchronous engine (Pregel). The nodes of a
+    CompactGraph are split in contiguous ranges of about the same number
+    of edges, one per worker thread. In every superstep each worker runs
+    the vertex program on its active nodes and on those that received
+    messages; messages sent during a superstep are delivered at the start
+    of the next one (merged by the combiner if there is one), and
+    aggregator values reduced over all nodes become visible then too.
+    A node that votes to halt stays inactive until a message wakes it up;
+    the run ends when every node is halted and no message is in flight.
+    Value must not be bool (the values are handed out by reference)
+*/
+template<typename Value, typename Message>
+class Pregel {
+
+public:
+   /** messages received by a node, as a range */
+   class Messages;
+   /** what the vertex program sees of its node and of the engine */
+   class Context;
+
+   typedef std::function<void(Context&, const Messages&)> Program;
+   /** merges the second message into the first */
+   typedef std::function<void(Message&, const Message&)> Combiner;
+   typedef std::function<double(double, double)>          Reducer;
+
+   explicit Pregel(const CompactGraph& C, unsigned threads = 0);
+
+   void     combiner(Combiner combine);
+   /** id of a new aggregator, reduce must be associative and commutative */
+   unsigned aggregator(Reducer reduce, double identity);
+
+   /** runs program until it halts, values are resized to nodes();
+       returns the number of supersteps */
+   unsigned run(Program program, std::vector<Value>& values, unsigned maxSupersteps = 1000);
+
+   /** value of an aggregator over the last superstep of the last run */
+   inline double aggregated(unsigned id) const;
+   /** messages sent during the last run */
+   inline unsigned long messages() const;
+   inline const CompactGraph& graph() const;
+   inline unsigned workers() const;
+
+private:
+   const CompactGraph* _graph;
+   unsigned            _workers;
+   /** worker w runs the nodes [_first[w], _first[w + 1]) */
+   std::vector<unsigned> _first;
+   Combiner              _combine;
+
+   std::vector<Reducer> _reduce;
+   std::vector<double>  _identity;
+   std::vector<double>  _aggregated;
+
+   /** state of a run */
+   std::vector<Value>*  _values;
+   unsigned             _superstep;
+   std::vector<char>    _halted;
+   unsigned long        _messages;
+   /** _outbox[from][to]: (target, message) sent by worker from to worker to */
+   std::vector<std::vector<std::vector<std::pair<unsigned, Message> > > > _outbox;
+   /** messages of node _first[w] + i: _inbox[w][_offset[w][i] ... _offset[w][i + 1]) */
+   std::vector<std::vector<Message> >       _inbox;
+   std::vector<std::vector<unsigned long> > _offset;
+
+   inline unsigned _owner(unsigned v) const;
+   unsigned long _compute(unsigned w, const Program& program, std::vector<double>& partial);
+   unsigned long _deliver(unsigned w);
+
+/** class Pregel */
+};
+
+template<typename Value, typename Message>
+class Pregel<Value, Message>::Messages {
+
+public:
+   inline const Message* begin() const;
+   inline const Message* end() const;
+   inline std::size_t    size() const;
+   inline bool           empty() const;
+
+private:
+   friend class Pregel;
+   const Message* _begin;
+   const Message* _end;
+
+/** class Messages */
+};
+
+template<typename Value, typename Message>
+class Pregel<Value, Message>::Context {
+
+public:
+   inline unsigned vertex() const;
+   inline unsigned superstep() const;
+   inline Value&   value();
+   inline const CompactGraph& graph() const;
+
+   /** delivered at the next superstep, ignored if target is not a node */
+   inline void sendMessage(unsigned target, const Message& message);
+   /** message to the target of every out-edge */
+   inline void sendToNeighbours(const Message& message);
+   /** inactive from the next superstep on, until a message arrives */
+   inline void voteToHalt();
+
+   /** adds x to the aggregator of this superstep */
+   inline void   aggregate(unsigned id, double x);
+   /** aggregator over the previous superstep (identity at superstep 0) */
+   inline double aggregated(unsigned id) const;
+
+private:
+   friend class Pregel;
+   Pregel*              _engine;
+   unsigned             _worker;
+   unsigned             _vertex;
+   std::vector<double>* _partial;
+
+/** class Context */
+};
+
+/** include inline functions */
+#include "Pregel_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //PREGEL_HH
@@ -0,0 +1,388 @@
+/*
+   @file    Pregel_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef PREGEL_INLINES_HH
+#define PREGEL_INLINES_HH 1
+
+/**
+   Constructor, splits the nodes between the workers
+
+   @param  C       graph to run on, must outlive the engine
+   @param  threads number of workers, 0 = all cores
+*/
+template<typename Value, typename Message>
+Pregel<Value, Message>::Pregel(const CompactGraph& C, unsigned threads)
+   : _graph(&C), _values(0), _superstep(0), _messages(0) {
+   const unsigned n = C.nodes();
+   _workers = std::max(1u, std::min(parallel::threads(threads), n));
+   /** ranges of about the same number of nodes + edges */
+   const unsigned long total = C.edges() + n;
+   _first.assign(_workers + 1, n);
+   _first[0] = 0;
+   unsigned v = 0;
+   for(unsigned w = 1; w < _workers; ++w) {
+      unsigned long target = total * w / _workers;
+      while(v < n && C.begin(v) + v < target)
+         ++v;
+      _first[w] = v;
+   }
+}
+
+/**
+   @param  combine merges the second message into the first, so a node
+                   receives at most one message per superstep
+   @return void
+*/
+template<typename Value, typename Message>
+void Pregel<Value, Message>::combiner(Combiner combine) {
+   _combine = combine;
+}
+
+/**
+   @param  reduce   combines two partial values
+   @param  identity value of the aggregator when nothing was aggregated
+   @return id of the aggregator
+*/
+template<typename Value, typename Message>
+unsigned Pregel<Value, Message>::aggregator(Reducer reduce, double identity) {
+   _reduce.push_back(reduce);
+   _identity.push_back(identity);
+   _aggregated.push_back(identity);
+   return _reduce.size() - 1;
+}
+
+/**
+   Supersteps until every node has halted and no message is in flight,
+   two barriers per superstep: after the programs ran and after the
+   messages were delivered
+
+   @param  program       vertex program, called as program(context, messages)
+   @param  values        value of every node, indexed by id
+   @param  maxSupersteps upper bound on the supersteps
+   @return number of supersteps run
+*/
+template<typename Value, typename Message>
+unsigned Pregel<Value, Message>::run(Program program, std::vector<Value>& values,
+                                     unsigned maxSupersteps) {
+   GRAPH_STAT_TIMER("pregel");
+   const unsigned n = _graph->nodes();
+   values.resize(n);
+   _values = &values;
+   _halted.assign(n, 0);
+   _messages = 0;
+   _aggregated = _identity;
+   _outbox.assign(_workers, std::vector<std::vector<std::pair<unsigned, Message> > >(_workers));
+   _inbox.assign(_workers, std::vector<Message>());
+   _offset.resize(_workers);
+   for(unsigned w = 0; w < _workers; ++w)
+      _offset[w].assign(_first[w + 1] - _first[w] + 1, 0);
+
+   std::vector<std::vector<double> > partial(_workers);
+   std::vector<unsigned long> active(_workers), delivered(_workers);
+   unsigned step = 0;
+   while(step < maxSupersteps && !parallel::stopping()) {
+      _superstep = step++;
+      parallel::forRange(0, _workers, _workers, 1,
+                         [&](std::size_t from, std::size_t to, unsigned) {
+         for(std::size_t w = from; w < to; ++w) {
+            partial[w] = _identity;
+            active[w] = _compute(w, program, partial[w]);
+         }
+      });
+      for(unsigned id = 0; id < _reduce.size(); ++id) {
+         _aggregated[id] = _identity[id];
+         for(unsigned w = 0; w < _workers; ++w)
+            _aggregated[id] = _reduce[id](_aggregated[id], partial[w][id]);
+      }
+      parallel::forRange(0, _workers, _workers, 1,
+                         [&](std::size_t from, std::size_t to, unsigned) {
+         for(std::size_t w = from; w < to; ++w)
+            delivered[w] = _deliver(w);
+      });
+
+      unsigned long running = 0, sent = 0;
+      for(unsigned w = 0; w < _workers; ++w) {
+         running += active[w];
+         sent += delivered[w];
+      }
+      _messages += sent;
+      if(running == 0 && sent == 0)
+         break;
+   }
+   _values = 0;
+   return step;
+}
+
+/**
+   Run the program on the nodes of worker w that are active or received
+   messages
+
+   @param  w       worker
+   @param  program vertex program
+   @param  partial aggregators of the worker
+   @return number of nodes still active
+*/
+template<typename Value, typename Message>
+unsigned long Pregel<Value, Message>::_compute(unsigned w, const Program& program,
+                                               std::vector<double>& partial) {
+   const std::vector<unsigned long>& offset = _offset[w];
+   const Message* inbox = _inbox[w].data();
+   Context context;
+   context._engine = this;
+   context._worker = w;
+   context._partial = &partial;
+   unsigned long active = 0;
+   for(unsigned v = _first[w]; v < _first[w + 1]; ++v) {
+      unsigned i = v - _first[w];
+      Messages messages;
+      messages._begin = inbox + offset[i];
+      messages._end = inbox + offset[i + 1];
+      if(_superstep > 0 && _halted[v] && messages.empty())
+         continue;
+      _halted[v] = 0;
+      context._vertex = v;
+      program(context, messages);
+      if(!_halted[v])
+         ++active;
+   }
+   return active;
+}
+
+/**
+   Gather the messages sent to the nodes of worker w, grouped by node
+   (counting sort) or merged by the combiner
+
+   @param  w worker
+   @return number of messages received
+*/
+template<typename Value, typename Message>
+unsigned long Pregel<Value, Message>::_deliver(unsigned w) {
+   const unsigned first = _first[w], size = _first[w + 1] - first;
+   std::vector<unsigned long>& offset = _offset[w];
+   std::vector<Message>& inbox = _inbox[w];
+   std::fill(offset.begin(), offset.end(), 0);
+   inbox.clear();
+   unsigned long received = 0;
+
+   if(_combine) {
+      std::vector<Message> slot(size);
+      std::vector<char> has(size, 0);
+      for(unsigned from = 0; from < _workers; ++from) {
+         const std::vector<std::pair<unsigned, Message> >& out = _outbox[from][w];
+         for(auto m = out.begin(); m != out.end(); ++m) {
+            unsigned i = m->first - first;
+            if(has[i])
+               _combine(slot[i], m->second);
+            else {
+               slot[i] = m->second;
+               has[i] = 1;
+            }
+         }
+         received += out.size();
+      }
+      for(unsigned i = 0; i < size; ++i) {
+         offset[i + 1] = offset[i] + has[i];
+         if(has[i])
+            inbox.push_back(slot[i]);
+      }
+   }
+   else {
+      for(unsigned from = 0; from < _workers; ++from) {
+         const std::vector<std::pair<unsigned, Message> >& out = _outbox[from][w];
+         for(auto m = out.begin(); m != out.end(); ++m)
+            ++offset[m->first - first + 1];
+         received += out.size();
+      }
+      for(unsigned i = 0; i < size; ++i)
+         offset[i + 1] += offset[i];
+      inbox.resize(offset[size]);
+      std::vector<unsigned long> next(offset.begin(), offset.end() - 1);
+      for(unsigned from = 0; from < _workers; ++from) {
+         const std::vector<std::pair<unsigned, Message> >& out = _outbox[from][w];
+         for(auto m = out.begin(); m != out.end(); ++m)
+            inbox[next[m->first - first]++] = m->second;
+      }
+   }
+   for(unsigned from = 0; from < _workers; ++from)
+      _outbox[from][w].clear();
+   return received;
+}
+
+/**
+   @param  v node id
+   @return worker running v
+*/
+template<typename Value, typename Message>
+inline unsigned
+Pregel<Value, Message>::_owner(unsigned v) const {
+   return std::upper_bound(_first.begin(), _first.end(), v) - _first.begin() - 1;
+}
+
+/**
+   @param  id aggregator id
+   @return its value over the last superstep, 0 for an unknown id
+*/
+template<typename Value, typename Message>
+inline double
+Pregel<Value, Message>::aggregated(unsigned id) const {
+   return id < _aggregated.size() ? _aggregated[id] : 0;
+}
+
+/**
+   @return number of messages sent during the last run
+*/
+template<typename Value, typename Message>
+inline unsigned long
+Pregel<Value, Message>::messages() const {
+   return _messages;
+}
+
+/**
+   @return graph the engine runs on
+*/
+template<typename Value, typename Message>
+inline const CompactGraph&
+Pregel<Value, Message>::graph() const {
+   return *_graph;
+}
+
+/**
+   @return number of worker threads
+*/
+template<typename Value, typename Message>
+inline unsigned
+Pregel<Value, Message>::workers() const {
+   return _workers;
+}
+
+/**
+   @return first message
+*/
+template<typename Value, typename Message>
+inline const Message*
+Pregel<Value, Message>::Messages::begin() const {
+   return _begin;
+}
+
+/**
+   @return one past the last message
+*/
+template<typename Value, typename Message>
+inline const Message*
+Pregel<Value, Message>::Messages::end() const {
+   return _end;
+}
+
+/**
+   @return number of messages
+*/
+template<typename Value, typename Message>
+inline std::size_t
+Pregel<Value, Message>::Messages::size() const {
+   return _end - _begin;
+}
+
+/**
+   @return no message?
+*/
+template<typename Value, typename Message>
+inline bool
+Pregel<Value, Message>::Messages::empty() const {
+   return _begin == _end;
+}
+
+/**
+   @return node the program runs on
+*/
+template<typename Value, typename Message>
+inline unsigned
+Pregel<Value, Message>::Context::vertex() const {
+   return _vertex;
+}
+
+/**
+   @return current superstep, from 0
+*/
+template<typename Value, typename Message>
+inline unsigned
+Pregel<Value, Message>::Context::superstep() const {
+   return _engine->_superstep;
+}
+
+/**
+   @return value of the node
+*/
+template<typename Value, typename Message>
+inline Value&
+Pregel<Value, Message>::Context::value() {
+   return (*_engine->_values)[_vertex];
+}
+
+/**
+   @return graph the engine runs on
+*/
+template<typename Value, typename Message>
+inline const CompactGraph&
+Pregel<Value, Message>::Context::graph() const {
+   return *_engine->_graph;
+}
+
+/**
+   @param  target  node id
+   @param  message message to deliver at the next superstep
+   @return void
+*/
+template<typename Value, typename Message>
+inline void
+Pregel<Value, Message>::Context::sendMessage(unsigned target, const Message& message) {
+   if(target >= _engine->_graph->nodes())
+      return;
+   _engine->_outbox[_worker][_engine->_owner(target)].push_back(std::make_pair(target, message));
+}
+
+/**
+   @param  message message to deliver to every out-neighbour
+   @return void
+*/
+template<typename Value, typename Message>
+inline void
+Pregel<Value, Message>::Context::sendToNeighbours(const Message& message) {
+   const CompactGraph& C = *_engine->_graph;
+   for(unsigned long e = C.begin(_vertex); e < C.end(_vertex); ++e)
+      sendMessage(C.target(e), message);
+}
+
+/**
+   @return void
+*/
+template<typename Value, typename Message>
+inline void
+Pregel<Value, Message>::Context::voteToHalt() {
+   _engine->_halted[_vertex] = 1;
+}
+
+/**
+   @param  id aggregator id, ignored if unknown
+   @param  x  value to reduce into the aggregator
+   @return void
+*/
+template<typename Value, typename Message>
+inline void
+Pregel<Value, Message>::Context::aggregate(unsigned id, double x) {
+   if(id < _partial->size())
+      (*_partial)[id] = _engine->_reduce[id]((*_partial)[id], x);
+}
+
+/**
+   @param  id aggregator id
+   @return its value over the previous superstep, 0 for an unknown id
+*/
+template<typename Value, typename Message>
+inline double
+Pregel<Value, Message>::Context::aggregated(unsigned id) const {
+   return _engine->aggregated(id);
+}
+
+#endif
@@ -0,0 +1,288 @@
+/*
+   @file    ReachabilityIndex.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <random>
+#include <set>
+#include "ReachabilityIndex.hh"
+
+using namespace GraphLib;
+
+/**
+   Constructor
+
+   @param  C            graph to index, node ids are those of C
+   @param  traversals   interval labels per component (at least 1)
+   @param  closureLimit DAGs up to this many components get closure bitsets
+*/
+ReachabilityIndex::ReachabilityIndex(const CompactGraph& C, unsigned traversals,
+                                     unsigned closureLimit)
+   : _traversals(std::max(traversals, 1u)), _words(0) {
+   _build(C, closureLimit);
+}
+
+/**
+   Constructor, queries by node name
+
+   @param  G            graph to index
+   @param  traversals   interval labels per component (at least 1)
+   @param  closureLimit DAGs up to this many components get closure bitsets
+*/
+ReachabilityIndex::ReachabilityIndex(const Graph& G, unsigned traversals,
+                                     unsigned closureLimit)
+   : _traversals(std::max(traversals, 1u)), _words(0) {
+   CompactGraph C(G);
+   for(unsigned v = 0; v < C.nodes(); ++v)
+      _id[C.name(v)] = v;
+   _build(C, closureLimit);
+}
+
+/**
+   @return void
+*/
+void ReachabilityIndex::_build(const CompactGraph& C, unsigned closureLimit) {
+   GRAPH_STAT_TIMER("reachabilityIndex");
+   _condense(C);
+   _label();
+
+   const unsigned n = components();
+   if(n == 0 || n > closureLimit)
+      return;
+   /** components are in topological order: fill the closure backwards */
+   _words = (n + 63) / 64;
+   _closure.assign(static_cast<unsigned long>(n) * _words, 0);
+   for(unsigned x = n; x-- > 0; ) {
+      std::uint64_t* reach = &_closure[static_cast<unsigned long>(x) * _words];
+      reach[x / 64] |= std::uint64_t(1) << (x % 64);
+      for(unsigned long e = _offset[x]; e < _offset[x + 1]; ++e) {
+         const std::uint64_t* child = &_closure[static_cast<unsigned long>(_target[e]) * _words];
+         for(unsigned i = x / 64; i < _words; ++i)
+            reach[i] |= child[i];
+      }
+   }
+}
+
+/**
+   Strongly connected components (iterative Tarjan) and the DAG between
+   them. Tarjan closes the components sinks first, so numbering them
+   backwards gives a topological order
+
+   @return void
+*/
+void ReachabilityIndex::_condense(const CompactGraph& C) {
+   const unsigned n = C.nodes();
+   const unsigned none = n;
+   std::vector<unsigned> index(n, none), low(n), stack, component(n, none);
+   std::vector<char> onStack(n, 0);
+   /** call stack of the DFS: node and next out-edge to look at */
+   std::vector<std::pair<unsigned, unsigned long> > calls;
+   unsigned counter = 0, closed = 0;
+
+   for(unsigned root = 0; root < n; ++root) {
+      if(index[root] != none)
+         continue;
+      calls.push_back(std::make_pair(root, C.begin(root)));
+      index[root] = low[root] = counter++;
+      stack.push_back(root);
+      onStack[root] = 1;
+
+      while(!calls.empty()) {
+         unsigned v = calls.back().first;
+         unsigned long& e = calls.back().second;
+         if(e < C.end(v)) {
+            unsigned w = C.target(e++);
+            if(index[w] == none) {
+               index[w] = low[w] = counter++;
+               stack.push_back(w);
+               onStack[w] = 1;
+               calls.push_back(std::make_pair(w, C.begin(w)));
+            }
+            else if(onStack[w])
+               low[v] = std::min(low[v], index[w]);
+            continue;
+         }
+         calls.pop_back();
+         if(!calls.empty())
+            low[calls.back().first] = std::min(low[calls.back().first], low[v]);
+         if(low[v] == index[v]) {
+            unsigned w;
+            do {
+               w = stack.back();
+               stack.pop_back();
+               onStack[w] = 0;
+               component[w] = closed;
+            } while(w != v);
+            ++closed;
+         }
+      }
+   }
+
+   _component.resize(n);
+   for(unsigned v = 0; v < n; ++v)
+      _component[v] = closed - 1 - component[v];
+
+   std::vector<std::vector<unsigned> > dag(closed);
+   for(unsigned v = 0; v < n; ++v) {
+      for(unsigned long e = C.begin(v); e < C.end(v); ++e) {
+         unsigned x = _component[v], y = _component[C.target(e)];
+         if(x != y)
+            dag[x].push_back(y);
+      }
+   }
+   _offset.assign(closed + 1, 0);
+   _target.clear();
+   for(unsigned x = 0; x < closed; ++x) {
+      std::sort(dag[x].begin(), dag[x].end());
+      dag[x].erase(std::unique(dag[x].begin(), dag[x].end()), dag[x].end());
+      _target.insert(_target.end(), dag[x].begin(), dag[x].end());
+      _offset[x + 1] = _target.size();
+   }
+}
+
+/**
+   GRAIL labels: for every traversal, a DFS of the DAG from its roots
+   gives each component its post-order rank and the lowest rank below
+   it. The first traversal follows the edge order, the others visit roots
+   and children in random order so their labels exclude other pairs
+
+   @return void
+*/
+void ReachabilityIndex::_label() {
+   const unsigned n = components();
+   _low.assign(static_cast<unsigned long>(n) * _traversals, 0);
+   _post.assign(static_cast<unsigned long>(n) * _traversals, 0);
+
+   std::vector<char> hasParent(n, 0);
+   for(unsigned long e = 0; e < _target.size(); ++e)
+      hasParent[_target[e]] = 1;
+   std::vector<unsigned> roots;
+   for(unsigned x = 0; x < n; ++x) {
+      if(!hasParent[x])
+         roots.push_back(x);
+   }
+
+   std::mt19937 random(1);
+   std::vector<char> visited(n);
+   std::vector<unsigned> children;
+   std::vector<std::pair<unsigned, std::vector<unsigned> > > calls;
+   for(unsigned t = 0; t < _traversals; ++t) {
+      unsigned* low = &_low[static_cast<unsigned long>(t) * n];
+      unsigned* post = &_post[static_cast<unsigned long>(t) * n];
+      if(t > 0)
+         std::shuffle(roots.begin(), roots.end(), random);
+      std::fill(visited.begin(), visited.end(), 0);
+      unsigned rank = 0;
+
+      for(auto r = roots.begin(); r != roots.end(); ++r) {
+         /** every call holds the children it still has to visit */
+         calls.push_back(std::make_pair(*r, std::vector<unsigned>()));
+         visited[*r] = 1;
+         low[*r] = n;
+         for(bool expand = true; !calls.empty(); ) {
+            unsigned x = calls.back().first;
+            if(expand) {
+               children.assign(_target.begin() + _offset[x], _target.begin() + _offset[x + 1]);
+               if(t > 0)
+                  std::shuffle(children.begin(), children.end(), random);
+               calls.back().second.assign(children.rbegin(), children.rend());
+            }
+            std::vector<unsigned>& left = calls.back().second;
+            expand = false;
+            while(!left.empty() && visited[left.back()]) {
+               low[x] = std::min(low[x], low[left.back()]);
+               left.pop_back();
+            }
+            if(!left.empty()) {
+               unsigned y = left.back();
+               visited[y] = 1;
+               low[y] = n;
+               calls.push_back(std::make_pair(y, std::vector<unsigned>()));
+               expand = true;
+               continue;
+            }
+            post[x] = rank++;
+            low[x] = std::min(low[x], post[x]);
+            calls.pop_back();
+            if(!calls.empty()) {
+               unsigned parent = calls.back().first;
+               low[parent] = std::min(low[parent], low[x]);
+               calls.back().second.pop_back();
+            }
+         }
+      }
+   }
+}
+
+/**
+   @param  u node id
+   @param  v node id
+   @return is there a path from u to v? (every node reaches itself)
+*/
+bool ReachabilityIndex::reachable(unsigned u, unsigned v) const {
+   if(u >= _component.size() || v >= _component.size())
+      return false;
+   unsigned x = _component[u], y = _component[v];
+   if(x == y)
+      return true;
+   /** topological order and labels rule out most pairs */
+   if(x > y || !_contains(x, y))
+      return false;
+   if(!_closure.empty())
+      return (_closure[static_cast<unsigned long>(x) * _words + y / 64] >> (y % 64)) & 1;
+
+   /** DFS of the DAG, only into components that can still reach y */
+   std::set<unsigned> visited;
+   std::vector<unsigned> stack(1, x);
+   visited.insert(x);
+   while(!stack.empty()) {
+      unsigned z = stack.back();
+      stack.pop_back();
+      for(unsigned long e = _offset[z]; e < _offset[z + 1]; ++e) {
+         unsigned w = _target[e];
+         if(w == y)
+            return true;
+         if(w < y && _contains(w, y) && visited.insert(w).second)
+            stack.push_back(w);
+      }
+   }
+   return false;
+}
+
+/**
+   @param  u node name
+   @param  v node name
+   @return is there a path from u to v? false if a node is unknown
+           (eg. added to the Graph after the index was built) and not v
+*/
+bool ReachabilityIndex::reachable(const std::string& u, const std::string& v) const {
+   if(u == v)
+      return true;
+   std::map<std::string, unsigned>::const_iterator a = _id.find(u), b = _id.find(v);
+   if(a == _id.end() || b == _id.end())
+      return false;
+   return reachable(a->second, b->second);
+}
+
+/**
+   @param  v node name
+   @return was v in the graph when the index was built?
+*/
+bool ReachabilityIndex::knows(const std::string& v) const {
+   return _id.find(v) != _id.end();
+}
+
+/**
+   @return heap bytes held by the index (labels, DAG, closure, components)
+*/
+unsigned long ReachabilityIndex::memoryUsage() const {
+   unsigned long bytes = _component.capacity() * sizeof(unsigned)
+                       + _offset.capacity() * sizeof(unsigned long)
+                       + _target.capacity() * sizeof(unsigned)
+                       + (_low.capacity() + _post.capacity()) * sizeof(unsigned)
+                       + _closure.capacity() * sizeof(std::uint64_t);
+   for(auto i = _id.begin(); i != _id.end(); ++i)
+      bytes += sizeof(*i) + i->first.capacity() + 3 * sizeof(void*);
+   return bytes;
+}
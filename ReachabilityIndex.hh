@@ -0,0 +1,79 @@
+/*
+   @file    ReachabilityIndex.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef REACHABILITY_INDEX_HH
+#define REACHABILITY_INDEX_HH 1
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "CompactGraph.hh"
+
+namespace GraphLib {
+
+/** Answers "can u reach v?" without traversing the graph in most cases.
+    The strongly connected components are collapsed into a DAG numbered
+    in topological order, and every component gets interval labels from
+    a few DFS traversals of the DAG (GRAIL): if u reaches v, the labels
+    of v are nested in those of u. Queries that pass both tests are
+    answered from transitive closure bitsets when the DAG is small
+    enough, by a label-pruned DFS of the DAG otherwise.
+    The index is immutable: it stays valid across the changes that keep
+    the reachability relation (see Graph::removeEdge), rebuild it after
+    any other change
+*/
+class ReachabilityIndex {
+
+public:
+   /** traversals: number of interval labels per component (more labels,
+       fewer DFS fallbacks); closureLimit: largest DAG given bitsets */
+   explicit ReachabilityIndex(const CompactGraph& C, unsigned traversals = 2,
+                              unsigned closureLimit = 4096);
+   explicit ReachabilityIndex(const Graph& G, unsigned traversals = 2,
+                              unsigned closureLimit = 4096);
+
+   bool reachable(unsigned u, unsigned v) const;
+   bool reachable(const std::string& u, const std::string& v) const;
+   bool knows(const std::string& v) const;
+
+   inline unsigned component(unsigned v) const;
+   inline unsigned components() const;
+   unsigned long   memoryUsage() const;
+
+private:
+   /** node name -> node id, only when built from a Graph */
+   std::map<std::string, unsigned> _id;
+   /** node id -> component, components in topological order */
+   std::vector<unsigned> _component;
+
+   /** DAG of the components, CSR */
+   std::vector<unsigned long> _offset;
+   std::vector<unsigned>      _target;
+
+   /** _low / _post of component x in traversal t at t * components() + x */
+   unsigned              _traversals;
+   std::vector<unsigned> _low;
+   std::vector<unsigned> _post;
+
+   /** reachable components of x: bits [x * _words, (x + 1) * _words) */
+   unsigned                   _words;
+   std::vector<std::uint64_t> _closure;
+
+   void _build(const CompactGraph& C, unsigned closureLimit);
+   void _condense(const CompactGraph& C);
+   void _label();
+   inline bool _contains(unsigned x, unsigned y) const;
+
+/** class ReachabilityIndex */
+};
+
+/** include inline functions */
+#include "ReachabilityIndex_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //REACHABILITY_INDEX_HH
@@ -0,0 +1,39 @@
+/*
+   @file    ReachabilityIndex_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef REACHABILITY_INDEX_INLINES_HH
+#define REACHABILITY_INDEX_INLINES_HH 1
+
+/**
+   @param  v node id
+   @return component of v (topological number)
+*/
+inline unsigned
+ReachabilityIndex::component(unsigned v) const {
+   return _component[v];
+}
+
+/**
+   @return number of strongly connected components
+*/
+inline unsigned
+ReachabilityIndex::components() const {
+   return _offset.size() - 1;
+}
+
+/**
+   @return are the labels of component y nested in those of x?
+*/
+inline bool
+ReachabilityIndex::_contains(unsigned x, unsigned y) const {
+   for(unsigned t = 0; t < _traversals; ++t) {
+      unsigned long i = static_cast<unsigned long>(t) * components();
+      if(_low[i + y] < _low[i + x] || _post[i + y] > _post[i + x])
+         return false;
+   }
+   return true;
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+   @file    SparseMatrix.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include "SparseMatrix.hh"
+
+using namespace GraphLib;
+
+/**
+   Constructor, no entry
+
+   @param  rows    number of rows
+   @param  columns number of columns
+*/
+SparseMatrix::SparseMatrix(unsigned rows, unsigned columns)
+   : _rows(rows), _columns(columns), _offset(rows + 1, 0) {
+}
+
+/**
+   Constructor from a list of entries in any order
+
+   @param  rows    number of rows
+   @param  columns number of columns
+   @param  entries (row, column, value) triples
+*/
+SparseMatrix::SparseMatrix(unsigned rows, unsigned columns, std::vector<Entry> entries)
+   : _rows(rows), _columns(columns), _offset(rows + 1, 0) {
+   entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& e) {
+      return e.row >= rows || e.column >= columns;
+   }), entries.end());
+   std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+      return a.row != b.row ? a.row < b.row : a.column < b.column;
+   });
+   for(auto e = entries.begin(); e != entries.end(); ++e) {
+      if(e != entries.begin() && e->row == (e - 1)->row && e->column == (e - 1)->column)
+         continue;
+      _column.push_back(e->column);
+      _value.push_back(e->value);
+      ++_offset[e->row + 1];
+   }
+   for(unsigned i = 0; i < rows; ++i)
+      _offset[i + 1] += _offset[i];
+}
+
+/**
+   Constructor, adjacency matrix of C: A(u, v) = weight of u -> v
+
+   @param  C graph, both directions are stored when undirected
+*/
+SparseMatrix::SparseMatrix(const CompactGraph& C)
+   : _rows(C.nodes()), _columns(C.nodes()), _offset(C.nodes() + 1, 0) {
+   std::vector<std::pair<unsigned, double> > row;
+   for(unsigned v = 0; v < C.nodes(); ++v) {
+      row.clear();
+      for(unsigned long e = C.begin(v); e < C.end(v); ++e)
+         row.push_back(std::make_pair(C.target(e), C.weight(e)));
+      std::stable_sort(row.begin(), row.end(),
+                       [](const std::pair<unsigned, double>& a,
+                          const std::pair<unsigned, double>& b) { return a.first < b.first; });
+      for(auto e = row.begin(); e != row.end(); ++e) {
+         if(e == row.begin() || e->first != (e - 1)->first) {
+            _column.push_back(e->first);
+            _value.push_back(e->second);
+         }
+      }
+      _offset[v + 1] = _column.size();
+   }
+}
+
+/**
+   Counting sort of the entries by column
+
+   @return A^T, the CSC form of A
+*/
+SparseMatrix SparseMatrix::transpose() const {
+   SparseMatrix T(_columns, _rows);
+   for(unsigned long e = 0; e < entries(); ++e)
+      ++T._offset[_column[e] + 1];
+   for(unsigned j = 0; j < _columns; ++j)
+      T._offset[j + 1] += T._offset[j];
+   T._column.resize(entries());
+   T._value.resize(entries());
+   std::vector<unsigned long> next(T._offset.begin(), T._offset.end() - 1);
+   for(unsigned i = 0; i < _rows; ++i) {
+      for(unsigned long e = _offset[i]; e < _offset[i + 1]; ++e) {
+         unsigned long slot = next[_column[e]]++;
+         T._column[slot] = i;
+         T._value[slot] = _value[e];
+      }
+   }
+   return T;
+}
+
+/**
+   Level synchronous: the frontier is a sparse vector, its product with
+   A over or-and masked by the nodes already visited is the next level
+
+   @param  A      adjacency matrix
+   @param  source node to start from
+   @return hop distance of every node from source
+*/
+std::vector<unsigned> algebra::BFS(const SparseMatrix& A, unsigned source) {
+   GRAPH_STAT_TIMER("algebraBFS");
+   std::vector<unsigned> level(A.rows(), CompactGraph::unreachable);
+   if(source >= A.rows() || A.rows() != A.columns())
+      return level;
+   std::vector<char> visited(A.rows(), 0);
+   SparseVector frontier;
+   frontier.size = A.rows();
+   frontier.index.push_back(source);
+   frontier.value.push_back(1);
+   for(unsigned depth = 0; !frontier.index.empty(); ++depth) {
+      for(auto v = frontier.index.begin(); v != frontier.index.end(); ++v) {
+         level[*v] = depth;
+         visited[*v] = 1;
+      }
+      frontier = A.vxm<semiring::OrAnd>(frontier, &visited, true);
+   }
+   return level;
+}
+
+/**
+   Bellman-Ford: the distances that changed are multiplied by A over
+   min-plus, the ones that improve form the next vector; stops after
+   rows() rounds if a negative cycle keeps improving them
+
+   @param  A      adjacency matrix, weights as lengths
+   @param  source node to start from
+   @return length of a shortest path to every node, infinity if not reached
+*/
+std::vector<double> algebra::shortestPaths(const SparseMatrix& A, unsigned source) {
+   GRAPH_STAT_TIMER("algebraShortestPaths");
+   std::vector<double> distance(A.rows(), semiring::MinPlus::zero());
+   if(source >= A.rows() || A.rows() != A.columns())
+      return distance;
+   distance[source] = 0;
+   SparseVector changed;
+   changed.size = A.rows();
+   changed.index.push_back(source);
+   changed.value.push_back(0);
+   for(unsigned round = 0; round < A.rows() && !changed.index.empty(); ++round) {
+      SparseVector reached = A.vxm<semiring::MinPlus>(changed);
+      changed.index.clear();
+      changed.value.clear();
+      for(std::size_t k = 0; k < reached.index.size(); ++k) {
+         unsigned v = reached.index[k];
+         if(reached.value[k] < distance[v]) {
+            distance[v] = reached.value[k];
+            changed.index.push_back(v);
+            changed.value.push_back(distance[v]);
+         }
+      }
+   }
+   return distance;
+}
+
+/**
+   Every triangle i > j > k is counted once by L(i, j) L(j, k) L(i, k)
+
+   @param  A       adjacency matrix, directions and weights ignored
+   @param  threads worker threads, 0 = all cores
+   @return number of triangles
+*/
+unsigned long algebra::triangles(const SparseMatrix& A, unsigned threads) {
+   GRAPH_STAT_TIMER("algebraTriangles");
+   std::vector<SparseMatrix::Entry> lower;
+   for(unsigned i = 0; i < A.rows(); ++i) {
+      for(unsigned long e = A.begin(i); e < A.end(i); ++e) {
+         unsigned j = A.column(e);
+         if(j != i) {
+            SparseMatrix::Entry entry = { std::max(i, j), std::min(i, j), 1 };
+            lower.push_back(entry);
+         }
+      }
+   }
+   SparseMatrix L(A.rows(), A.columns(), lower);
+   SparseMatrix C = L.mxm<semiring::PlusTimes>(L, &L, threads);
+   double total = 0;
+   for(unsigned long e = 0; e < C.entries(); ++e)
+      total += C.value(e);
+   return static_cast<unsigned long>(total + 0.5);
+}
+
+/**
+   @param  A       adjacency matrix
+   @param  sources nodes to start from, one row of the result each
+   @param  threads worker threads, 0 = all cores
+   @return R, R(i, v) = 1 if v is reachable from sources[i] (itself included)
+*/
+SparseMatrix algebra::reachability(const SparseMatrix& A, const std::vector<unsigned>& sources,
+                                   unsigned threads) {
+   GRAPH_STAT_TIMER("algebraReachability");
+   std::vector<SparseMatrix::Entry> start;
+   for(unsigned i = 0; i < sources.size(); ++i) {
+      SparseMatrix::Entry entry = { i, sources[i], 1 };
+      start.push_back(entry);
+   }
+   SparseMatrix R(sources.size(), A.columns(), start);
+   if(A.rows() != A.columns())
+      return R;
+   /** frontier F: the entries of R found in the last round */
+   SparseMatrix F = R;
+   while(F.entries() > 0) {
+      SparseMatrix next = F.mxm<semiring::OrAnd>(A, 0, threads);
+      std::vector<SparseMatrix::Entry> merged, found;
+      for(unsigned i = 0; i < R.rows(); ++i) {
+         unsigned long e = R.begin(i), f = next.begin(i);
+         while(e < R.end(i) || f < next.end(i)) {
+            if(f == next.end(i) || (e < R.end(i) && R.column(e) < next.column(f))) {
+               SparseMatrix::Entry entry = { i, R.column(e++), 1 };
+               merged.push_back(entry);
+            }
+            else {
+               SparseMatrix::Entry entry = { i, next.column(f), 1 };
+               merged.push_back(entry);
+               if(e < R.end(i) && R.column(e) == next.column(f))
+                  ++e;
+               else
+                  found.push_back(entry);
+               ++f;
+            }
+         }
+      }
+      R = SparseMatrix(R.rows(), R.columns(), merged);
+      F = SparseMatrix(R.rows(), R.columns(), found);
+   }
+   return R;
+}
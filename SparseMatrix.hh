@@ -0,0 +1,146 @@
+/*
+   @file    SparseMatrix.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef SPARSE_MATRIX_HH
+#define SPARSE_MATRIX_HH 1
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "CompactGraph.hh"
+#include "Parallel.hh"
+
+namespace GraphLib {
+
+/** Semirings (add, multiply) the kernels of SparseMatrix are templated
+    on: zero() is the identity of add and what a missing entry stands for
+*/
+namespace semiring {
+
+   /** counting paths, PageRank-like sums */
+   struct PlusTimes {
+      static double zero() { return 0; }
+      static double add(double a, double b) { return a + b; }
+      static double multiply(double a, double b) { return a * b; }
+   };
+
+   /** shortest paths */
+   struct MinPlus {
+      static double zero() { return std::numeric_limits<double>::infinity(); }
+      static double add(double a, double b) { return std::min(a, b); }
+      static double multiply(double a, double b) { return a + b; }
+   };
+
+   /** reachability, values are 0 or 1 */
+   struct OrAnd {
+      static double zero() { return 0; }
+      static double add(double a, double b) { return a != 0 || b != 0; }
+      static double multiply(double a, double b) { return a != 0 && b != 0; }
+   };
+
+   /** widest (bottleneck) paths */
+   struct MaxMin {
+      static double zero() { return -std::numeric_limits<double>::infinity(); }
+      static double add(double a, double b) { return std::max(a, b); }
+      static double multiply(double a, double b) { return std::min(a, b); }
+   };
+
+/** namespace semiring */
+}
+
+/** vector holding only some of its entries, by increasing index */
+struct SparseVector {
+   unsigned              size;
+   std::vector<unsigned> index;
+   std::vector<double>   value;
+};
+
+/** Sparse matrix in compressed sparse row form (the CSC form of A is the
+    CSR form of transpose()), with the GraphBLAS kernels over any semiring:
+    mxv (matrix times dense vector, pull, parallel over the rows), vxm
+    (sparse vector times matrix, push over the entries of the vector) and
+    mxm (sparse times sparse, parallel over the rows). Every kernel takes
+    an optional mask of the output: only the entries the mask allows (or,
+    complemented, forbids) are computed. The adjacency matrix of a graph
+    has A(u, v) = weight of u -> v, so x^T A moves a frontier x along the
+    edges and A x pulls along them
+*/
+class SparseMatrix {
+
+public:
+   /** entry (row, column) = value */
+   struct Entry {
+      unsigned row;
+      unsigned column;
+      double   value;
+   };
+
+   SparseMatrix(unsigned rows, unsigned columns);
+   /** out of range entries are ignored, a repeated entry keeps its first value */
+   SparseMatrix(unsigned rows, unsigned columns, std::vector<Entry> entries);
+   /** adjacency matrix, parallel edges merged keeping the first weight */
+   explicit SparseMatrix(const CompactGraph& C);
+
+   inline unsigned      rows() const;
+   inline unsigned      columns() const;
+   inline unsigned long entries() const;
+
+   /** entries of row i */
+   inline unsigned long begin(unsigned i) const;
+   inline unsigned long end(unsigned i) const;
+   inline unsigned      column(unsigned long e) const;
+   inline double        value(unsigned long e) const;
+   /** A(i, j), S::zero() if missing */
+   template<typename S> double get(unsigned i, unsigned j) const;
+
+   SparseMatrix transpose() const;
+
+   /** y = A x over S, y(i) = S::zero() where the mask forbids */
+   template<typename S>
+   std::vector<double> mxv(const std::vector<double>& x, const std::vector<char>* mask = 0,
+                           bool complement = false, unsigned threads = 0) const;
+   /** y = x^T A over S */
+   template<typename S>
+   SparseVector vxm(const SparseVector& x, const std::vector<char>* mask = 0,
+                    bool complement = false) const;
+   /** C = A B over S, computed only where mask has an entry */
+   template<typename S>
+   SparseMatrix mxm(const SparseMatrix& B, const SparseMatrix* mask = 0,
+                    unsigned threads = 0) const;
+
+private:
+   unsigned _rows;
+   unsigned _columns;
+   /** row i: _column[_offset[i]] ... _column[_offset[i + 1] - 1], increasing */
+   std::vector<unsigned long> _offset;
+   std::vector<unsigned>      _column;
+   std::vector<double>        _value;
+
+/** class SparseMatrix */
+};
+
+/** Graph algorithms written with the kernels above, A an adjacency matrix */
+namespace algebra {
+
+   /** hops from source, CompactGraph::unreachable if not reached: x^T A over or-and */
+   std::vector<unsigned> BFS(const SparseMatrix& A, unsigned source);
+   /** Bellman-Ford, x^T A over min-plus on the nodes whose distance changed */
+   std::vector<double>   shortestPaths(const SparseMatrix& A, unsigned source);
+   /** sum of L .* (L L), L the lower triangle of the undirected simple graph */
+   unsigned long         triangles(const SparseMatrix& A, unsigned threads = 0);
+   /** R(i, v) = 1 if sources[i] reaches v: R = R + R A over or-and until it stays put */
+   SparseMatrix          reachability(const SparseMatrix& A, const std::vector<unsigned>& sources,
+                                      unsigned threads = 0);
+
+/** namespace algebra */
+}
+
+/** include inline functions */
+#include "SparseMatrix_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //SPARSE_MATRIX_HH
@@ -0,0 +1,259 @@
+/*
+   @file    SparseMatrix_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef SPARSE_MATRIX_INLINES_HH
+#define SPARSE_MATRIX_INLINES_HH 1
+
+/**
+   @return number of rows
+*/
+inline unsigned
+SparseMatrix::rows() const {
+   return _rows;
+}
+
+/**
+   @return number of columns
+*/
+inline unsigned
+SparseMatrix::columns() const {
+   return _columns;
+}
+
+/**
+   @return number of stored entries
+*/
+inline unsigned long
+SparseMatrix::entries() const {
+   return _column.size();
+}
+
+/**
+   @param  i row
+   @return index of the first entry of row i
+*/
+inline unsigned long
+SparseMatrix::begin(unsigned i) const {
+   return _offset[i];
+}
+
+/**
+   @param  i row
+   @return one past the index of the last entry of row i
+*/
+inline unsigned long
+SparseMatrix::end(unsigned i) const {
+   return _offset[i + 1];
+}
+
+/**
+   @param  e entry index
+   @return column of the entry
+*/
+inline unsigned
+SparseMatrix::column(unsigned long e) const {
+   return _column[e];
+}
+
+/**
+   @param  e entry index
+   @return value of the entry
+*/
+inline double
+SparseMatrix::value(unsigned long e) const {
+   return _value[e];
+}
+
+/**
+   @param  i row
+   @param  j column
+   @return A(i, j), S::zero() if there is no such entry
+*/
+template<typename S>
+double SparseMatrix::get(unsigned i, unsigned j) const {
+   if(i >= _rows)
+      return S::zero();
+   auto first = _column.begin() + _offset[i], last = _column.begin() + _offset[i + 1];
+   auto found = std::lower_bound(first, last, j);
+   return found != last && *found == j ? _value[found - _column.begin()] : S::zero();
+}
+
+/**
+   @param  x          dense vector of columns() values
+   @param  mask       rows to compute (mask[i] != 0), null for every row
+   @param  complement compute the rows the mask forbids instead
+   @param  threads    worker threads, 0 = all cores
+   @return A x over S, S::zero() everywhere if x is too short
+*/
+template<typename S>
+std::vector<double> SparseMatrix::mxv(const std::vector<double>& x, const std::vector<char>* mask,
+                                      bool complement, unsigned threads) const {
+   std::vector<double> y(_rows, S::zero());
+   if(x.size() < _columns)
+      return y;
+   parallel::forRange(0, _rows, threads, 256, [&](std::size_t from, std::size_t to, unsigned) {
+      for(std::size_t i = from; i < to; ++i) {
+         if(mask && (i < mask->size() && (*mask)[i]) == complement)
+            continue;
+         double sum = S::zero();
+         for(unsigned long e = _offset[i]; e < _offset[i + 1]; ++e)
+            sum = S::add(sum, S::multiply(_value[e], x[_column[e]]));
+         y[i] = sum;
+      }
+   });
+   return y;
+}
+
+/**
+   Push the entries of x along their rows: products gathered and sorted
+   when they are few, accumulated in a dense array otherwise
+
+   @param  x          sparse vector of rows() entries
+   @param  mask       columns to compute (mask[j] != 0), null for every column
+   @param  complement compute the columns the mask forbids instead
+   @return x^T A over S
+*/
+template<typename S>
+SparseVector SparseMatrix::vxm(const SparseVector& x, const std::vector<char>* mask,
+                               bool complement) const {
+   SparseVector y;
+   y.size = _columns;
+   auto allowed = [&](unsigned j) {
+      return !mask || (j < mask->size() && (*mask)[j]) != complement;
+   };
+   unsigned long work = 0;
+   for(std::size_t k = 0; k < x.index.size(); ++k) {
+      if(x.index[k] < _rows)
+         work += _offset[x.index[k] + 1] - _offset[x.index[k]];
+   }
+
+   if(work < _columns / 16) {
+      std::vector<std::pair<unsigned, double> > products;
+      products.reserve(work);
+      for(std::size_t k = 0; k < x.index.size(); ++k) {
+         unsigned i = x.index[k];
+         if(i >= _rows)
+            continue;
+         for(unsigned long e = _offset[i]; e < _offset[i + 1]; ++e) {
+            if(allowed(_column[e]))
+               products.push_back(std::make_pair(_column[e], S::multiply(x.value[k], _value[e])));
+         }
+      }
+      std::stable_sort(products.begin(), products.end(),
+                       [](const std::pair<unsigned, double>& a,
+                          const std::pair<unsigned, double>& b) { return a.first < b.first; });
+      for(auto p = products.begin(); p != products.end(); ++p) {
+         if(!y.index.empty() && y.index.back() == p->first)
+            y.value.back() = S::add(y.value.back(), p->second);
+         else {
+            y.index.push_back(p->first);
+            y.value.push_back(p->second);
+         }
+      }
+      return y;
+   }
+
+   std::vector<double> sum(_columns);
+   std::vector<char> seen(_columns, 0);
+   for(std::size_t k = 0; k < x.index.size(); ++k) {
+      unsigned i = x.index[k];
+      if(i >= _rows)
+         continue;
+      for(unsigned long e = _offset[i]; e < _offset[i + 1]; ++e) {
+         unsigned j = _column[e];
+         if(!allowed(j))
+            continue;
+         double product = S::multiply(x.value[k], _value[e]);
+         sum[j] = seen[j] ? S::add(sum[j], product) : product;
+         seen[j] = 1;
+      }
+   }
+   for(unsigned j = 0; j < _columns; ++j) {
+      if(seen[j]) {
+         y.index.push_back(j);
+         y.value.push_back(sum[j]);
+      }
+   }
+   return y;
+}
+
+/**
+   Gustavson's row by row product: row i of A B is the sum of the rows k
+   of B scaled by A(i, k), accumulated in a dense array per worker; every
+   worker builds the rows of its range, concatenated at the end
+
+   @param  B       matrix of columns() rows
+   @param  mask    entries to compute, of the shape of the product; null
+                   (or of another shape) for every entry
+   @param  threads worker threads, 0 = all cores
+   @return A B over S, empty if the shapes don't match
+*/
+template<typename S>
+SparseMatrix SparseMatrix::mxm(const SparseMatrix& B, const SparseMatrix* mask,
+                               unsigned threads) const {
+   GRAPH_STAT_TIMER("mxm");
+   SparseMatrix C(_rows, B._columns);
+   if(_columns != B._rows)
+      return C;
+   if(mask && (mask->_rows != _rows || mask->_columns != B._columns))
+      mask = 0;
+
+   const unsigned workers = parallel::threads(threads);
+   std::vector<std::vector<unsigned long> > count(workers);
+   std::vector<std::vector<unsigned> > column(workers);
+   std::vector<std::vector<double> > value(workers);
+   std::vector<std::size_t> first(workers, _rows);
+   unsigned used = parallel::forRange(0, _rows, workers, 64,
+                                      [&](std::size_t from, std::size_t to, unsigned w) {
+      std::vector<double> sum(B._columns);
+      std::vector<char> seen(B._columns, 0), allowed(mask ? B._columns : 0, 0);
+      std::vector<unsigned> touched;
+      first[w] = from;
+      for(std::size_t i = from; i < to; ++i) {
+         if(mask) {
+            for(unsigned long e = mask->_offset[i]; e < mask->_offset[i + 1]; ++e)
+               allowed[mask->_column[e]] = 1;
+         }
+         for(unsigned long e = _offset[i]; e < _offset[i + 1]; ++e) {
+            unsigned k = _column[e];
+            for(unsigned long f = B._offset[k]; f < B._offset[k + 1]; ++f) {
+               unsigned j = B._column[f];
+               if(mask && !allowed[j])
+                  continue;
+               double product = S::multiply(_value[e], B._value[f]);
+               if(seen[j])
+                  sum[j] = S::add(sum[j], product);
+               else {
+                  sum[j] = product;
+                  seen[j] = 1;
+                  touched.push_back(j);
+               }
+            }
+         }
+         std::sort(touched.begin(), touched.end());
+         for(auto j = touched.begin(); j != touched.end(); ++j) {
+            column[w].push_back(*j);
+            value[w].push_back(sum[*j]);
+            seen[*j] = 0;
+         }
+         count[w].push_back(touched.size());
+         touched.clear();
+         if(mask) {
+            for(unsigned long e = mask->_offset[i]; e < mask->_offset[i + 1]; ++e)
+               allowed[mask->_column[e]] = 0;
+         }
+      }
+   });
+
+   for(unsigned w = 0; w < used; ++w) {
+      for(std::size_t r = 0; r < count[w].size(); ++r)
+         C._offset[first[w] + r + 1] = C._offset[first[w] + r] + count[w][r];
+      C._column.insert(C._column.end(), column[w].begin(), column[w].end());
+      C._value.insert(C._value.end(), value[w].begin(), value[w].end());
+   }
+   return C;
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+   @file    Stats.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <mutex>
+#include <cmath>
+#include "Stats.hh"
+
+using namespace GraphLib;
+
+namespace {
+   /** statistics collected so far, shared by every thread */
+   std::mutex        registryLock;
+   stats::Snapshot   registry;
+}
+
+/**
+   Empty histogram
+*/
+stats::Histogram::Histogram() : calls(0), totalNs(0), maxNs(0) {
+   for(unsigned i = 0; i < buckets; ++i)
+      count[i] = 0;
+}
+
+/**
+   @param  ns duration of a call in nanoseconds
+   @return void
+*/
+void stats::Histogram::add(double ns) {
+   unsigned i = ns < 1 ? 0 : static_cast<unsigned>(std::log2(ns));
+   ++count[i < buckets ? i : buckets - 1];
+   ++calls;
+   totalNs += ns;
+   if(ns > maxNs)
+      maxNs = ns;
+}
+
+/**
+   @param  p percentile in [0, 1], eg. 0.99
+   @return upper bound in nanoseconds of the bucket holding the percentile
+*/
+double stats::Histogram::percentile(double p) const {
+   unsigned long seen = 0;
+   for(unsigned i = 0; i < buckets; ++i) {
+      seen += count[i];
+      if(seen > 0 && seen >= p * calls)
+         return std::ldexp(1.0, i + 1);
+   }
+   return maxNs;
+}
+
+/**
+   Operation with no calls
+*/
+stats::Operation::Operation() {
+   for(unsigned i = 0; i < counters; ++i)
+      counter[i] = 0;
+}
+
+/**
+   @return copy of the statistics collected so far
+*/
+stats::Snapshot stats::snapshot() {
+   std::lock_guard<std::mutex> lock(registryLock);
+   return registry;
+}
+
+/**
+   Forget the statistics collected so far
+
+   @return void
+*/
+void stats::reset() {
+   std::lock_guard<std::mutex> lock(registryLock);
+   registry.clear();
+}
+
+/**
+   @param  operation name of the method
+   @param  ns        duration of the call
+   @return void
+*/
+void stats::record(const char* operation, double ns) {
+   std::lock_guard<std::mutex> lock(registryLock);
+   registry[operation].latency.add(ns);
+}
+
+/**
+   @param  operation name of the method
+   @param  counter   what was touched
+   @param  n         how many
+   @return void
+*/
+void stats::count(const char* operation, Counter counter, unsigned long n) {
+   std::lock_guard<std::mutex> lock(registryLock);
+   registry[operation].counter[counter] += n;
+}
+
+/**
+   Print the snapshot as JSON
+
+   @param  os ostream object
+   @param  s  statistics to print
+   @return void
+*/
+void stats::print(std::ostream& os, const Snapshot& s) {
+   static const char* names[counters] = { "lookups", "nodesVisited",
+                                          "edgesScanned", "allocations" };
+   os << "{";
+   for(auto op = s.begin(); op != s.end(); ++op) {
+      const Histogram& h = op->second.latency;
+      os << (op == s.begin() ? "\n" : ",\n")
+         << "  \"" << op->first << "\": {\"calls\": " << h.calls
+         << ", \"totalNs\": " << h.totalNs
+         << ", \"meanNs\": " << (h.calls ? h.totalNs / h.calls : 0)
+         << ", \"p50Ns\": " << h.percentile(0.5)
+         << ", \"p99Ns\": " << h.percentile(0.99)
+         << ", \"maxNs\": " << h.maxNs;
+      for(unsigned i = 0; i < counters; ++i)
+         os << ", \"" << names[i] << "\": " << op->second.counter[i];
+      os << "}";
+   }
+   os << "\n}" << std::endl;
+}
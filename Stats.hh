@@ -0,0 +1,88 @@
+/*
+   @file    Stats.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef GRAPH_STATS_HH
+#define GRAPH_STATS_HH 1
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <map>
+
+namespace GraphLib {
+
+/** Runtime instrumentation of the Graph operations.
+    Compiled in only when GRAPH_STATS is defined (make DEFINES=-DGRAPH_STATS),
+    otherwise the GRAPH_STAT_* macros expand to nothing and cost nothing
+*/
+namespace stats {
+
+   /** what an operation touched */
+   enum Counter { lookups, nodesVisited, edgesScanned, allocations, counters };
+
+   /** latency histogram with power of two buckets in nanoseconds */
+   struct Histogram {
+      static const unsigned buckets = 40;
+      /** bucket i counts the calls that took [2^i, 2^(i+1)) ns */
+      unsigned long count[buckets];
+      unsigned long calls;
+      double        totalNs;
+      double        maxNs;
+
+      Histogram();
+      void   add(double ns);
+      double percentile(double p) const;
+   };
+
+   /** statistics of one public method */
+   struct Operation {
+      Histogram     latency;
+      unsigned long counter[counters];
+
+      Operation();
+   };
+
+   /** copy of the statistics at some point in time */
+   typedef std::map<std::string, Operation> Snapshot;
+
+   Snapshot snapshot();
+   void     reset();
+   void     record(const char* operation, double ns);
+   void     count(const char* operation, Counter counter, unsigned long n);
+   void     print(std::ostream& os, const Snapshot& s);
+
+   /** time the enclosing scope and record it under operation */
+   class ScopedTimer {
+   public:
+      explicit ScopedTimer(const char* operation)
+         : _operation(operation), _start(std::chrono::steady_clock::now()) {}
+      ~ScopedTimer() {
+         std::chrono::duration<double, std::nano> ns =
+            std::chrono::steady_clock::now() - _start;
+         record(_operation, ns.count());
+      }
+
+   private:
+      const char* _operation;
+      std::chrono::steady_clock::time_point _start;
+   };
+
+/** namespace stats */
+}
+
+/** namespace GraphLib */
+}
+
+#ifdef GRAPH_STATS
+#define GRAPH_STAT_TIMER(operation) \
+   GraphLib::stats::ScopedTimer _graphStatTimer(operation)
+#define GRAPH_STAT_COUNT(operation, counter, n) \
+   GraphLib::stats::count(operation, GraphLib::stats::counter, n)
+#else
+#define GRAPH_STAT_TIMER(operation) ((void)0)
+#define GRAPH_STAT_COUNT(operation, counter, n) ((void)0)
+#endif
+
+#endif //GRAPH_STATS_HH
@@ -0,0 +1,241 @@
+/*
+   @file    TemporalGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include "TemporalGraph.hh"
+
+using namespace GraphLib;
+
+/**
+   Constructor, empty graph
+
+   @param  graphType Graph::directed or Graph::undirected
+*/
+TemporalGraph::TemporalGraph(bool graphType)
+   : _directed(graphType), _edges(0),
+     _earliest(std::numeric_limits<double>::infinity()),
+     _latest(-std::numeric_limits<double>::infinity()) {
+}
+
+/**
+   @param  node name of the node
+   @return its id, the next one if the node is new
+*/
+unsigned TemporalGraph::addNode(const std::string& node) {
+   auto inserted = _id.insert(std::make_pair(node, _name.size()));
+   if(inserted.second) {
+      _name.push_back(node);
+      _out.push_back(std::vector<Tier>());
+   }
+   return inserted.first->second;
+}
+
+/**
+   @param  fromNode source node, added if missing
+   @param  toNode   target node, added if missing
+   @param  start    first instant the edge exists
+   @param  end      last instant the edge exists
+   @param  cost     weight of the edge
+   @return void
+*/
+void TemporalGraph::addEdge(const std::string& fromNode, const std::string& toNode,
+                            double start, double end, double cost) {
+   if(!(start <= end))
+      return;
+   unsigned u = addNode(fromNode), v = addNode(toNode);
+   Contact c = { v, start, end, cost };
+   _append(u, c);
+   if(!_directed && u != v) {
+      c.target = u;
+      _append(v, c);
+   }
+   ++_edges;
+   _earliest = std::min(_earliest, start);
+   _latest = std::max(_latest, end);
+}
+
+/**
+   @param  node name of the node
+   @return its id, nodes() if the node is unknown
+*/
+unsigned TemporalGraph::id(const std::string& node) const {
+   auto found = _id.find(node);
+   return found != _id.end() ? found->second : nodes();
+}
+
+/**
+   @param  node name of the node
+   @param  t0   first instant of the window
+   @param  t1   last instant of the window
+   @return nodes linked from node at some time in [t0, t1], each once
+*/
+std::list<std::string> TemporalGraph::adjacent(const std::string& node, double t0,
+                                               double t1) const {
+   std::vector<unsigned> targets;
+   forEachOut(id(node), t0, t1, [&](unsigned w, double, double, double) {
+      targets.push_back(w);
+   });
+   std::sort(targets.begin(), targets.end());
+   targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+   std::list<std::string> adjacent;
+   for(auto w = targets.begin(); w != targets.end(); ++w)
+      adjacent.push_back(_name[*w]);
+   return adjacent;
+}
+
+/**
+   @param  source node id to start from
+   @param  t0     first instant of the window
+   @param  t1     last instant of the window
+   @return hop distance of every node from source, ~0u if not reached
+*/
+std::vector<unsigned> TemporalGraph::BFS(unsigned source, double t0, double t1) const {
+   GRAPH_STAT_TIMER("temporalBFS");
+   const unsigned unreachable = ~0u;
+   std::vector<unsigned> level(nodes(), unreachable);
+   if(source >= nodes())
+      return level;
+   std::vector<unsigned> queue(1, source);
+   level[source] = 0;
+   for(std::size_t i = 0; i < queue.size(); ++i) {
+      unsigned v = queue[i];
+      forEachOut(v, t0, t1, [&](unsigned w, double, double, double) {
+         if(level[w] == unreachable) {
+            level[w] = level[v] + 1;
+            queue.push_back(w);
+         }
+      });
+   }
+   return level;
+}
+
+/**
+   Dijkstra on the edges valid in the window
+
+   @param  source node id to start from
+   @param  t0     first instant of the window
+   @param  t1     last instant of the window
+   @return length of a shortest path to every node
+*/
+std::vector<double> TemporalGraph::shortestPaths(unsigned source, double t0, double t1) const {
+   GRAPH_STAT_TIMER("temporalShortestPaths");
+   const double infinity = std::numeric_limits<double>::infinity();
+   std::vector<double> distance(nodes(), infinity);
+   if(source >= nodes())
+      return distance;
+   typedef std::pair<double, unsigned> entry;
+   std::priority_queue<entry, std::vector<entry>, std::greater<entry> > queue;
+   distance[source] = 0;
+   queue.push(entry(0, source));
+   while(!queue.empty()) {
+      entry top = queue.top();
+      queue.pop();
+      if(top.first > distance[top.second])
+         continue;
+      forEachOut(top.second, t0, t1, [&](unsigned w, double weight, double, double) {
+         if(top.first + weight < distance[w]) {
+            distance[w] = top.first + weight;
+            queue.push(entry(distance[w], w));
+         }
+      });
+   }
+   return distance;
+}
+
+/**
+   Label setting on arrival times: a node is settled at its earliest
+   arrival a, then an edge valid during [start, end] with end >= a
+   reaches its target at max(a, start)
+
+   @param  source node id to start from
+   @param  t0     earliest departure from source
+   @param  t1     latest instant an edge may be taken
+   @return earliest arrival time at every node, t0 for the source
+*/
+std::vector<double> TemporalGraph::earliestArrival(unsigned source, double t0, double t1) const {
+   GRAPH_STAT_TIMER("temporalEarliestArrival");
+   const double infinity = std::numeric_limits<double>::infinity();
+   std::vector<double> arrival(nodes(), infinity);
+   if(source >= nodes() || t1 < t0)
+      return arrival;
+   typedef std::pair<double, unsigned> entry;
+   std::priority_queue<entry, std::vector<entry>, std::greater<entry> > queue;
+   arrival[source] = t0;
+   queue.push(entry(t0, source));
+   while(!queue.empty()) {
+      entry top = queue.top();
+      queue.pop();
+      if(top.first > arrival[top.second])
+         continue;
+      /** only the edges still valid when we get there */
+      forEachOut(top.second, top.first, t1, [&](unsigned w, double, double start, double) {
+         double time = std::max(top.first, start);
+         if(time < arrival[w]) {
+            arrival[w] = time;
+            queue.push(entry(time, w));
+         }
+      });
+   }
+   return arrival;
+}
+
+/**
+   Insert in the tier of the duration of c, keeping its edges sorted by
+   start, after the edges with the same start
+
+   @return void
+*/
+void TemporalGraph::_append(unsigned u, const Contact& c) {
+   const double infinity = std::numeric_limits<double>::infinity();
+   double duration = c.end - c.start;
+   int scale;
+   if(duration == 0)
+      scale = std::numeric_limits<int>::min();
+   else if(!(duration < infinity))
+      scale = std::numeric_limits<int>::max();
+   else
+      std::frexp(duration, &scale);
+
+   std::vector<Tier>& tiers = _out[u];
+   auto tier = std::lower_bound(tiers.begin(), tiers.end(), scale,
+                                [](const Tier& t, int s) { return t.scale < s; });
+   if(tier == tiers.end() || tier->scale != scale) {
+      Tier created = { scale, 0, std::vector<Contact>() };
+      tier = tiers.insert(tier, created);
+   }
+   std::vector<Contact>& out = tier->contacts;
+   if(out.empty() || out.back().start <= c.start)
+      out.push_back(c);
+   else {
+      auto position = std::upper_bound(out.begin(), out.end(), c,
+                                       [](const Contact& a, const Contact& b) {
+                                          return a.start < b.start;
+                                       });
+      out.insert(position, c);
+   }
+   if(scale != std::numeric_limits<int>::max())
+      tier->span = std::max(tier->span, duration);
+}
+
+/**
+   @return range of the edges of the tier that start in [t0 - span, t1]:
+           every edge of the tier valid in [t0, t1] is in it. The
+           infinite tier is read from its first edge
+*/
+std::pair<std::size_t, std::size_t> TemporalGraph::_window(const Tier& tier, double t0,
+                                                           double t1) {
+   const std::vector<Contact>& out = tier.contacts;
+   auto before = [](const Contact& c, double t) { return c.start < t; };
+   auto after = [](double t, const Contact& c) { return t < c.start; };
+   std::size_t first = 0;
+   if(tier.scale != std::numeric_limits<int>::max())
+      first = std::lower_bound(out.begin(), out.end(), t0 - tier.span, before) - out.begin();
+   std::size_t last = std::upper_bound(out.begin(), out.end(), t1, after) - out.begin();
+   return std::make_pair(first, std::max(first, last));
+}
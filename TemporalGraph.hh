@@ -0,0 +1,108 @@
+/*
+   @file    TemporalGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef TEMPORAL_GRAPH_HH
+#define TEMPORAL_GRAPH_HH 1
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "Graph.hh"
+
+namespace GraphLib {
+
+/** Graph whose edges exist during a time interval [start, end] (start =
+    end for an instant). The out-edges of a node are split in tiers of
+    durations within a factor of 2 (instants and unbounded intervals get
+    their own tier), each sorted by start time with the longest duration
+    of the tier, span: a window [t0, t1] reads in a tier only the edges
+    starting in [t0 - span, t1]. All those starting in [t0 - span / 2, t1]
+    are valid in the window, so the edges read for nothing are bounded by
+    the edges of the same tier starting in the half span before; a few
+    long-lived edges no longer make every window read all the edges of
+    the node, unless a node links edges of about the same long duration
+    starting just before every window. Queries run on
+    the edges valid in a window without building a Graph per window, or
+    follow time-respecting paths (earliestArrival). The same pair of nodes
+    may be linked during several intervals. Edges are appended in about
+    increasing start time at O(1), out of order at O(degree)
+*/
+class TemporalGraph {
+
+public:
+   explicit TemporalGraph(bool graphType = Graph::directed);
+
+   unsigned addNode(const std::string& node);
+   /** fromNode -> toNode valid during [start, end], ignored if end < start */
+   void     addEdge(const std::string& fromNode, const std::string& toNode,
+                    double start, double end, double cost = 1);
+
+   inline unsigned      nodes() const;
+   /** edges counted like Graph::edges(), once per interval */
+   inline unsigned long edges() const;
+   inline bool          isOriented() const;
+   inline const std::string& name(unsigned v) const;
+   /** nodes() if the node is unknown */
+   unsigned id(const std::string& node) const;
+
+   /** time span of the edges: earliest start, latest end */
+   inline double earliest() const;
+   inline double latest() const;
+
+   /** fn(w, weight, start, end) for every edge v -> w valid at some time in [t0, t1] */
+   template<typename F> void forEachOut(unsigned v, double t0, double t1, F fn) const;
+   std::list<std::string> adjacent(const std::string& node, double t0, double t1) const;
+
+   /** on the edges valid in [t0, t1], as if they formed one graph;
+       hops are ~0u and lengths infinity for the nodes not reached */
+   std::vector<unsigned> BFS(unsigned source, double t0, double t1) const;
+   /** weights as lengths, they must be non-negative */
+   std::vector<double>   shortestPaths(unsigned source, double t0, double t1) const;
+
+   /** earliest time each node can be reached from source leaving at t0 or
+       later, along edges taken in non-decreasing time within [t0, t1];
+       an edge takes no time to cross. Infinity if not reached */
+   std::vector<double> earliestArrival(unsigned source, double t0, double t1) const;
+
+private:
+   /** edge valid during [start, end] */
+   struct Contact {
+      unsigned target;
+      double   start;
+      double   end;
+      double   weight;
+   };
+   /** out-edges whose end - start lies in [2^(scale - 1), 2^scale), by
+       increasing start, with span their longest end - start; scale is
+       INT_MIN for instants and INT_MAX for infinite durations */
+   struct Tier {
+      int    scale;
+      double span;
+      std::vector<Contact> contacts;
+   };
+
+   bool          _directed;
+   unsigned long _edges;
+   double        _earliest;
+   double        _latest;
+   std::vector<std::string>        _name;
+   std::map<std::string, unsigned> _id;
+   /** tiers of every node, by increasing scale */
+   std::vector<std::vector<Tier> > _out;
+
+   void _append(unsigned u, const Contact& c);
+   static std::pair<std::size_t, std::size_t> _window(const Tier& tier, double t0, double t1);
+
+/** class TemporalGraph */
+};
+
+/** include inline functions */
+#include "TemporalGraph_Inlines.hh"
+
+/** namespace GraphLib */
+}
+
+#endif //TEMPORAL_GRAPH_HH
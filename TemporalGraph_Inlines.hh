@@ -0,0 +1,79 @@
+/*
+   @file    TemporalGraph_Inlines.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef TEMPORAL_GRAPH_INLINES_HH
+#define TEMPORAL_GRAPH_INLINES_HH 1
+
+/**
+   @return number of nodes
+*/
+inline unsigned
+TemporalGraph::nodes() const {
+   return _name.size();
+}
+
+/**
+   @return number of edges
+*/
+inline unsigned long
+TemporalGraph::edges() const {
+   return _edges;
+}
+
+/**
+   @return graph oriented or not?
+*/
+inline bool
+TemporalGraph::isOriented() const {
+   return _directed;
+}
+
+/**
+   @param  v node id
+   @return name of v
+*/
+inline const std::string&
+TemporalGraph::name(unsigned v) const {
+   return _name[v];
+}
+
+/**
+   @return start of the earliest edge, infinity if there is none
+*/
+inline double
+TemporalGraph::earliest() const {
+   return _earliest;
+}
+
+/**
+   @return end of the latest edge, -infinity if there is none
+*/
+inline double
+TemporalGraph::latest() const {
+   return _latest;
+}
+
+/**
+   @param  v  node id
+   @param  t0 first instant of the window
+   @param  t1 last instant of the window
+   @param  fn callable invoked as fn(unsigned, double, double, double)
+   @return void
+*/
+template<typename F>
+void TemporalGraph::forEachOut(unsigned v, double t0, double t1, F fn) const {
+   if(v >= nodes())
+      return;
+   for(auto tier = _out[v].begin(); tier != _out[v].end(); ++tier) {
+      std::pair<std::size_t, std::size_t> range = _window(*tier, t0, t1);
+      const std::vector<Contact>& out = tier->contacts;
+      for(std::size_t i = range.first; i < range.second; ++i) {
+         if(out[i].end >= t0)
+            fn(out[i].target, out[i].weight, out[i].start, out[i].end);
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+   @file    VersionedGraph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#include "VersionedGraph.hh"
+
+using namespace GraphLib;
+
+/**
+   Constructor
+
+   @param  graphType  directed/undirect graph
+*/
+VersionedGraph::VersionedGraph(bool graphType)
+   : _current(new Graph(graphType)), _version(0) {
+}
+
+/**
+   Start the history from a copy of G
+
+   @param  G  initial graph
+*/
+VersionedGraph::VersionedGraph(const Graph& G)
+   : _current(new Graph(G)), _version(0) {
+}
+
+/**
+   Snapshot of the last published version. The snapshot stays valid and
+   unchanged while the caller holds it, whatever the writer does
+
+   @return snapshot_ptr
+*/
+VersionedGraph::snapshot_ptr VersionedGraph::snapshot() const {
+   return std::atomic_load(&_current);
+}
+
+/**
+   @return number of published updates
+*/
+unsigned long VersionedGraph::version() const {
+   return _version.load(std::memory_order_acquire);
+}
+
+/**
+   Replace the current snapshot with G; the previous one is destroyed
+   when its last reader releases it
+
+   @param  G  new graph, owned by the snapshot from now on
+   @return void
+*/
+void VersionedGraph::_publish(const Graph* G) {
+   std::atomic_store(&_current, snapshot_ptr(G));
+   _version.fetch_add(1, std::memory_order_release);
+}
+
+/**
+   @param  node node to add
+   @return void
+*/
+void VersionedGraph::addNode(std::string node) {
+   update([&node](Graph& G) { G.addNode(node); });
+}
+
+/**
+   @param  node node to remove
+   @return void
+*/
+void VersionedGraph::removeNode(std::string node) {
+   update([&node](Graph& G) { G.removeNode(node); });
+}
+
+/**
+   @param  fromNode edge from node
+   @param  toNode   edge to node
+   @param  cost     weight of the edge, default is 1
+   @return void
+*/
+void VersionedGraph::addEdge(std::string fromNode, std::string toNode, double cost) {
+   update([&](Graph& G) { G.addEdge(fromNode, toNode, cost); });
+}
+
+/**
+   @param  fromNode edge from node
+   @param  toNode   edge to node
+   @return void
+*/
+void VersionedGraph::removeEdge(std::string fromNode, std::string toNode) {
+   update([&](Graph& G) { G.removeEdge(fromNode, toNode); });
+}
+
+/**
+   @param  fromNode edge from node
+   @param  toNode   edge to node
+   @param  cost     new weight
+   @return void
+*/
+void VersionedGraph::setWeight(std::string fromNode, std::string toNode, double cost) {
+   update([&](Graph& G) { G.setWeight(fromNode, toNode, cost); });
+}
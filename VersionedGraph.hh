@@ -0,0 +1,80 @@
+/*
+   @file    VersionedGraph.hh
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+*/
+#ifndef VERSIONED_GRAPH_HH
+#define VERSIONED_GRAPH_HH 1
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include "Graph.hh"
+
+namespace GraphLib {
+
+/** Graph shared between one writer and many reader threads.
+    Every update is applied to a private copy of the current graph that is
+    then published as a new immutable snapshot. Readers take a snapshot and
+    run any const algorithm (BFS, isConnected, weight, ...) on it without
+    locks; a snapshot is reclaimed when the last reader holding it lets go
+*/
+class VersionedGraph {
+
+public:
+   /** immutable view of the graph at some version */
+   typedef std::shared_ptr<const Graph> snapshot_ptr;
+
+   explicit VersionedGraph(bool graphType = Graph::directed);
+   explicit VersionedGraph(const Graph& G);
+
+   /** a VersionedGraph owns its history, it can't be copied */
+   VersionedGraph(const VersionedGraph&) = delete;
+   VersionedGraph& operator=(const VersionedGraph&) = delete;
+   /** default Distructor*/
+   ~VersionedGraph() = default;
+
+   snapshot_ptr  snapshot() const;
+   unsigned long version() const;
+
+   void addNode(std::string node);
+   void removeNode(std::string node);
+   void addEdge(std::string fromNode, std::string toNode, double cost = 1);
+   void removeEdge(std::string fromNode, std::string toNode);
+   void setWeight(std::string fromNode, std::string toNode, double cost);
+
+   template<typename Mutation> void update(Mutation mutation);
+
+private:
+   /** last published snapshot, read/written with std::atomic_load/store */
+   snapshot_ptr _current;
+   /** number of snapshots published so far */
+   std::atomic<unsigned long> _version;
+   /** serializes the writers */
+   std::mutex _writer;
+
+   void _publish(const Graph* G);
+
+/** class VersionedGraph */
+};
+
+/**
+   Apply a batch of mutations and publish the result as one snapshot.
+   Use it to amortize the copy when many edges change together
+
+   @param  mutation callable invoked as mutation(Graph&)
+   @return void
+*/
+template<typename Mutation> void
+VersionedGraph::update(Mutation mutation) {
+   std::lock_guard<std::mutex> lock(_writer);
+   std::unique_ptr<Graph> next(new Graph(*std::atomic_load(&_current)));
+   mutation(*next);
+   _publish(next.release());
+}
+
+/** namespace GraphLib */
+}
+
+#endif //VERSIONED_GRAPH_HH
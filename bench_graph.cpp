@@ -0,0 +1,489 @@
+/*
+   @file    bench_graph.cpp
+   @author  Ayoub Ouarrak, ouarrakayoub@gmail.com
+   @version 1.0
+
+   Benchmark harness: times the main Graph operations on sparse, dense
+   and power-law graphs of growing size and writes the results as JSON
+   on the standard output, e.g.  ./bench 2 > bench_output.txt
+*/
+#include "Graph.hh"
+#include "CompactGraph.hh"
+#include "GraphView.hh"
+#include "DistanceOracle.hh"
+#include "ExternalGraph.hh"
+#include "CompressedGraph.hh"
+#include "DeltaGraph.hh"
+#include "TemporalGraph.hh"
+#include "SparseMatrix.hh"
+#include "Pregel.hh"
+#include "Parallel.hh"
+#include <sys/resource.h>
+#include <algorithm>
+#include <streambuf>
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+
+using namespace GraphLib;
+
+/** edge list of a generated graph, node names are "0" ... "n-1" */
+typedef std::vector<std::pair<std::string, std::string> > edgeList;
+
+/** discard everything written to it, used to silence BFS/DFS/... */
+class NullBuffer : public std::streambuf {
+protected:
+   int overflow(int c) { return c; }
+};
+
+/** fixed seed: every run generates the same graphs */
+static std::mt19937 generator(20161019);
+
+/**
+   Erdos-Renyi like graph with n nodes and about n * degree edges
+*/
+edgeList randomEdges(unsigned n, unsigned degree) {
+   edgeList E;
+   std::uniform_int_distribution<unsigned> node(0, n - 1);
+   for(unsigned i = 0; i < n * degree; ++i)
+      E.push_back(std::make_pair(std::to_string(node(generator)),
+                                 std::to_string(node(generator))));
+   return E;
+}
+
+/**
+   Barabasi-Albert graph: every new node links to m nodes chosen with
+   probability proportional to their degree
+*/
+edgeList powerLawEdges(unsigned n, unsigned m) {
+   edgeList E;
+   std::vector<unsigned> endpoints;
+   for(unsigned v = 1; v < n; ++v) {
+      for(unsigned k = 0; k < m; ++k) {
+         unsigned u = endpoints.empty() ? 0 :
+            endpoints[std::uniform_int_distribution<unsigned>(0, endpoints.size() - 1)(generator)];
+         E.push_back(std::make_pair(std::to_string(v), std::to_string(u)));
+         endpoints.push_back(u);
+         endpoints.push_back(v);
+      }
+   }
+   return E;
+}
+
+/**
+   @param  name field of /proc/self/status, eg. "VmRSS:"
+   @return its value in KB, -1 where there is no such file (not Linux)
+*/
+long statusMemory(const char* name) {
+   std::FILE* status = std::fopen("/proc/self/status", "r");
+   if(!status)
+      return -1;
+   long kb = -1;
+   char line[256];
+   while(std::fgets(line, sizeof(line), status)) {
+      if(std::strncmp(line, name, std::strlen(name)) == 0)
+         std::sscanf(line + std::strlen(name), "%ld", &kb);
+   }
+   std::fclose(status);
+   return kb;
+}
+
+/**
+   @return current resident set size of the process in KB
+*/
+long residentMemory() {
+   return statusMemory("VmRSS:");
+}
+
+/**
+   Start a new peak: the kernel sets the high water mark of the process
+   back to its current resident set size
+
+   @return false if the kernel does not allow it
+*/
+bool resetPeakMemory() {
+   std::FILE* clear = std::fopen("/proc/self/clear_refs", "w");
+   if(!clear)
+      return false;
+   bool reset = std::fputs("5", clear) >= 0;
+   return std::fclose(clear) == 0 && reset;
+}
+
+/**
+   @return peak resident set size in KB since the last resetPeakMemory(),
+           or since the process started if it could not reset it
+*/
+long peakMemory() {
+   long kb = statusMemory("VmHWM:");
+   if(kb >= 0)
+      return kb;
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+/** one JSON record per (graph, operation). Memory of the operation
+    alone: rss_before_kb is what the process held when it started (the
+    graphs built so far, freed pages the allocator keeps), peak_rss_kb
+    the most it held while running it and peak_growth_kb the difference.
+    Where the peak can't be reset (not Linux) peak_rss_kb is the peak of
+    the whole process and peak_reset is false */
+class Report {
+public:
+   explicit Report(std::ostream& os) : _os(os), _first(true) {}
+
+   void record(const std::string& shape, unsigned nodes, unsigned edges,
+               const std::string& operation, unsigned long ops, double seconds,
+               long before, long peak, bool reset) {
+      _os << (_first ? "\n" : ",\n")
+          << "    {\"shape\": \"" << shape << "\", \"nodes\": " << nodes
+          << ", \"edges\": " << edges << ", \"operation\": \"" << operation
+          << "\", \"ops\": " << ops << ", \"seconds\": " << seconds
+          << ", \"ops_per_sec\": " << (seconds > 0 ? ops / seconds : 0)
+          << ", \"rss_before_kb\": " << before << ", \"peak_rss_kb\": " << peak
+          << ", \"peak_growth_kb\": " << (before >= 0 ? std::max(peak - before, 0l) : 0)
+          << ", \"peak_reset\": " << (reset ? "true" : "false") << "}";
+      _first = false;
+   }
+
+private:
+   std::ostream& _os;
+   bool          _first;
+};
+
+/**
+   Time fn(), which performs ops operations, and take the peak of the
+   memory it uses
+*/
+template<typename F>
+void measure(Report& report, const std::string& shape, const Graph& G,
+             const std::string& operation, unsigned long ops, F fn) {
+   long before = residentMemory();
+   bool reset = resetPeakMemory();
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   fn();
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+   report.record(shape, G.nodes(), G.edges(), operation, ops, elapsed.count(),
+                 before, peakMemory(), reset);
+}
+
+/**
+   Run every benchmark on the graph described by E
+*/
+void benchGraph(Report& report, const std::string& shape, unsigned n, const edgeList& E) {
+   Graph G;
+   for(unsigned v = 0; v < n; ++v)
+      G.addNode(std::to_string(v));
+
+   measure(report, shape, G, "addEdge", E.size(), [&]() {
+      for(auto e = E.begin(); e != E.end(); ++e)
+         G.addEdge(e->first, e->second, 1 + (e - E.begin()) % 10);
+   });
+
+   measure(report, shape, G, "adjacent", n, [&]() {
+      unsigned long total = 0;
+      for(unsigned v = 0; v < n; ++v)
+         total += G.adjacent(std::to_string(v)).size();
+      if(total != G.edges())
+         std::cerr << "adjacent: unexpected edge count" << std::endl;
+   });
+
+   /** the printing algorithms write to a discarded stream */
+   NullBuffer null;
+   std::streambuf* out = std::cout.rdbuf(&null);
+
+   measure(report, shape, G, "BFS", 1, [&]() { G.BFS("0"); });
+   measure(report, shape, G, "DFS", 1, [&]() { G.DFS("0"); });
+   measure(report, shape, G, "coloring", 1, [&]() { G.coloring(); });
+   if(n <= 256) {
+      measure(report, shape, G, "floydWarshell", 1, [&]() {
+         double** W = G.weightMatrix();
+         G.floydWarshell(W);
+         for(unsigned i = 0; i < G.nodes(); ++i)
+            delete[] W[i];
+         delete[] W;
+      });
+   }
+   std::cout.rdbuf(out);
+
+   measure(report, shape, G, "isCyclic", 1, [&]() { G.isCyclic(); });
+   /** the first call computes, the next ones hit the cache */
+   measure(report, shape, G, "isConnected", 1, [&]() { G.isConnected(); });
+   measure(report, shape, G, "isConnectedCached", 1000, [&]() {
+      for(unsigned i = 0; i < 1000; ++i)
+         G.isConnected();
+   });
+   measure(report, shape, G, "pageRank", 1, [&]() { G.pageRank(); });
+   measure(report, shape, G, "triangles", 1, [&]() { G.triangles(); });
+   measure(report, shape, G, "kruskal", 1, [&]() { G.minimumSpanningForest(Graph::kruskal); });
+   measure(report, shape, G, "boruvka", 1, [&]() { G.minimumSpanningForest(Graph::boruvka); });
+   measure(report, shape, G, "maxFlow", 1, [&]() {
+      G.maxFlow("0", std::to_string(n - 1));
+   });
+   measure(report, shape, G, "approximateBetweenness", 1, [&]() {
+      G.approximateBetweenness(0.05, 0.1);
+   });
+   measure(report, shape, G, "coreNumbers", 1, [&]() { G.coreNumbers(); });
+   measure(report, shape, G, "coreNumbersParallel", 1, [&]() { G.coreNumbers(0); });
+   /** a DFS per query without the index, time a sample */
+   measure(report, shape, G, "reachableDFS", 100, [&]() {
+      for(unsigned q = 0; q < 100; ++q)
+         G.reachable(std::to_string(q * 7919 % n), std::to_string(q * 104729 % n));
+   });
+   {
+      Graph indexed(G);
+      measure(report, shape, G, "indexReachability", 1, [&]() { indexed.indexReachability(); });
+      measure(report, shape, G, "reachableIndexed", 1000, [&]() {
+         for(unsigned q = 0; q < 1000; ++q)
+            indexed.reachable(std::to_string(q * 7919 % n), std::to_string(q * 104729 % n));
+      });
+      /** the index survives the removals that another path goes around */
+      unsigned long removed = std::min<unsigned long>(E.size(), 100);
+      measure(report, shape, G, "removeEdgeIndexed", removed, [&]() {
+         for(unsigned long i = 0; i < removed; ++i) {
+            indexed.removeEdge(E[i].first, E[i].second);
+            indexed.reachable(E[i].first, E[i].second);
+         }
+      });
+   }
+
+   CompactGraph C(G);
+   measure(report, shape, G, "distances256", 256, [&]() {
+      std::vector<unsigned> sources;
+      for(unsigned s = 0; s < 256; ++s)
+         sources.push_back(s % n);
+      C.distances(sources);
+   });
+   /** point-to-point queries, plain bidirectional Dijkstra against ALT */
+   {
+      DistanceOracle dijkstra(C, 0);
+      measure(report, shape, G, "distanceNoLandmarks", 100, [&]() {
+         for(unsigned q = 0; q < 100; ++q)
+            dijkstra.distance(q * 7919 % n, q * 104729 % n);
+      });
+      DistanceOracle* oracle = 0;
+      measure(report, shape, G, "distanceOracle", 1, [&]() { oracle = new DistanceOracle(C); });
+      measure(report, shape, G, "distanceALT", 100, [&]() {
+         for(unsigned q = 0; q < 100; ++q)
+            oracle->distance(q * 7919 % n, q * 104729 % n);
+      });
+      delete oracle;
+   }
+   /** the same graph streamed from disk, 4 partitions */
+   {
+      measure(report, shape, G, "externalWrite", 1, [&]() {
+         ExternalGraph::write(C, "bench_external", 4);
+      });
+      ExternalGraph X("bench_external");
+      measure(report, shape, G, "externalBFS", 1, [&]() { X.BFS(0); });
+      measure(report, shape, G, "externalComponents", 1, [&]() {
+         std::vector<unsigned> component;
+         X.components(component);
+      });
+      measure(report, shape, G, "externalPageRank", 1, [&]() { X.pageRank(); });
+      std::remove("bench_external.graph");
+      for(unsigned p = 0; p < X.partitions(); ++p)
+         std::remove(("bench_external." + std::to_string(p) + ".edges").c_str());
+   }
+   /** label propagation as a vertex program: every node ends with the
+       smallest id that reaches it */
+   measure(report, shape, G, "pregelMinLabel", 1, [&]() {
+      typedef Pregel<unsigned, unsigned> Engine;
+      Engine engine(C);
+      engine.combiner([](unsigned& kept, const unsigned& other) { kept = std::min(kept, other); });
+      std::vector<unsigned> label;
+      engine.run([](Engine::Context& node, const Engine::Messages& in) {
+         unsigned best = node.superstep() == 0 ? node.vertex() : node.value();
+         for(auto m = in.begin(); m != in.end(); ++m)
+            best = std::min(best, *m);
+         if(node.superstep() == 0 || best < node.value()) {
+            node.value() = best;
+            node.sendToNeighbours(best);
+         }
+         node.voteToHalt();
+      }, label);
+   });
+   /** the same queries as semiring kernels on the adjacency matrix */
+   {
+      SparseMatrix A(C);
+      measure(report, shape, G, "algebraBFS", 1, [&]() { algebra::BFS(A, 0); });
+      measure(report, shape, G, "algebraShortestPaths", 1, [&]() {
+         algebra::shortestPaths(A, 0);
+      });
+      measure(report, shape, G, "compactTriangles", 1, [&]() { C.triangles(); });
+      measure(report, shape, G, "algebraTriangles", 1, [&]() { algebra::triangles(A); });
+   }
+   /** same PageRank on the compact storage before and after reordering */
+   measure(report, shape, G, "compactPageRank", 1, [&]() { C.pageRank(); });
+   /** the same kernel through an unfiltered view */
+   measure(report, shape, G, "viewPageRank", 1, [&]() { GraphView(C).pageRank(); });
+   /** independent queries sharing the pool, one thread each */
+   measure(report, shape, G, "asyncPageRank", 8, [&]() {
+      parallel::Scope query(1);
+      std::vector<std::future<std::vector<double> > > ranks;
+      for(unsigned q = 0; q < 8; ++q)
+         ranks.push_back(parallel::async([&]() { return C.pageRank(); }));
+      for(auto r = ranks.begin(); r != ranks.end(); ++r)
+         r->get();
+   });
+   measure(report, shape, G, "reorderRCM", 1, [&]() {
+      C.reorder(CompactGraph::reverseCuthillMcKee);
+   });
+   measure(report, shape, G, "compactPageRankRCM", 1, [&]() { C.pageRank(); });
+   /** compressed lists of the reordered graph, decoded on every visit */
+   {
+      CompressedGraph* Z = 0;
+      measure(report, shape, G, "compress", 1, [&]() { Z = new CompressedGraph(C); });
+      measure(report, shape, G, "compressedBFS", 1, [&]() { Z->BFS(0); });
+      measure(report, shape, G, "compressedPageRank", 1, [&]() { Z->pageRank(); });
+      delete Z;
+   }
+   measure(report, shape, G, "copy", 1, [&]() { Graph copy(G); });
+   /** updates absorbed by the delta layers, then traversals over them */
+   {
+      DeltaGraph D(G);
+      unsigned long updates = std::min<unsigned long>(E.size(), 100000);
+      measure(report, shape, G, "deltaUpdate", updates, [&]() {
+         for(unsigned long i = 0; i < updates; ++i) {
+            if(i % 4 == 3)
+               D.removeEdge(E[i].first, E[i].second);
+            else
+               D.addEdge(E[i].second, E[i].first, 2);
+         }
+      });
+      D.waitCompaction();
+      DeltaGraph::Snapshot S = D.snapshot();
+      measure(report, shape, G, "deltaBFS", 1, [&]() { S.BFS(0); });
+      measure(report, shape, G, "deltaCompact", 1, [&]() { D.compact(); });
+      measure(report, shape, G, "deltaBFSCompacted", 1, [&]() { D.snapshot().BFS(0); });
+   }
+   /** edge i exists during [i, i + n): 10 windows queried in place against
+       a Graph rebuilt per window */
+   {
+      TemporalGraph T(G.isOriented());
+      measure(report, shape, G, "temporalBuild", E.size(), [&]() {
+         for(unsigned long i = 0; i < E.size(); ++i)
+            T.addEdge(E[i].first, E[i].second, i, i + n);
+      });
+      const double span = E.size() / 10.0;
+      measure(report, shape, G, "temporalWindowBFS", 10, [&]() {
+         for(unsigned w = 0; w < 10; ++w)
+            T.BFS(T.id("0"), w * span, (w + 1) * span);
+      });
+      measure(report, shape, G, "rebuildWindowBFS", 10, [&]() {
+         for(unsigned w = 0; w < 10; ++w) {
+            Graph window;
+            for(unsigned long i = 0; i < E.size(); ++i) {
+               if(i <= (w + 1) * span && i + n >= w * span)
+                  window.addEdge(E[i].first, E[i].second);
+            }
+            window.addNode("0");
+            window.BFS("0");
+         }
+      });
+      measure(report, shape, G, "temporalEarliestArrival", 1, [&]() {
+         T.earliestArrival(T.id("0"), 0, E.size() + n);
+      });
+      /** a hub with a short edge per instant and one long-lived edge:
+          the long one must not make every window read all the others */
+      TemporalGraph H(G.isOriented());
+      for(unsigned long i = 0; i < E.size(); ++i)
+         H.addEdge("hub", E[i].second, i, i + 1);
+      H.addEdge("hub", E[0].first, 0, 1e12);
+      measure(report, shape, G, "temporalWindowLongLived", 1000, [&]() {
+         for(unsigned w = 0; w < 1000; ++w)
+            H.adjacent("hub", w * span / 100, w * span / 100 + 1);
+      });
+   }
+
+   /** a query after every removal: a replacement edge keeps the
+       union-find usable, a split makes the queries share one rebuild */
+   {
+      Graph H(G);
+      unsigned long queried = std::min<unsigned long>(E.size(), 200);
+      measure(report, shape, G, "removeEdgeConnected", queried, [&]() {
+         for(unsigned long i = 0; i < queried; ++i) {
+            H.removeEdge(E[i].first, E[i].second);
+            H.connected(E[i].first, E[i].second);
+         }
+      });
+   }
+
+   /** removals leave tombstones, vacuumed once a quarter are dead */
+   unsigned long removals = std::min<unsigned long>(E.size(), 2000);
+   measure(report, shape, G, "removeEdge", removals, [&]() {
+      for(unsigned long i = 0; i < removals; ++i)
+         G.removeEdge(E[i].first, E[i].second);
+   });
+   unsigned purged = n / 2;
+   measure(report, shape, G, "removeNode", purged, [&]() {
+      for(unsigned v = 0; v < purged; ++v)
+         G.removeNode(std::to_string(v));
+   });
+}
+
+/**
+   Point-to-point distances on a side x side grid with random weights:
+   landmarks pay off on such geometric graphs, much less on the random
+   graphs above whose small diameter makes every bound weak
+*/
+void benchGridDistances(Report& report, unsigned side) {
+   Graph G(Graph::undirected);
+   std::uniform_int_distribution<unsigned> weight(1, 10);
+   for(unsigned v = 0; v < side * side; ++v) {
+      if(v % side + 1 < side)
+         G.addEdge(std::to_string(v), std::to_string(v + 1), weight(generator));
+      if(v + side < side * side)
+         G.addEdge(std::to_string(v), std::to_string(v + side), weight(generator));
+   }
+   CompactGraph C(G);
+   const unsigned n = C.nodes();
+   DistanceOracle dijkstra(C, 0);
+   measure(report, "grid", G, "distanceNoLandmarks", 100, [&]() {
+      for(unsigned q = 0; q < 100; ++q)
+         dijkstra.distance(q * 7919 % n, q * 104729 % n);
+   });
+   DistanceOracle* oracle = 0;
+   measure(report, "grid", G, "distanceOracle", 1, [&]() { oracle = new DistanceOracle(C); });
+   measure(report, "grid", G, "distanceALT", 100, [&]() {
+      for(unsigned q = 0; q < 100; ++q)
+         oracle->distance(q * 7919 % n, q * 104729 % n);
+   });
+   delete oracle;
+}
+
+/**
+   usage: bench [scale]   graph sizes are multiplied by scale (default 1)
+*/
+int main(int argc, char** argv) {
+   unsigned scale = argc > 1 ? std::atoi(argv[1]) : 1;
+   if(scale == 0)
+      scale = 1;
+
+   /** own stream on stdout: std::cout is silenced while timing BFS/DFS */
+   std::ostream json(std::cout.rdbuf());
+   json << "{\n  \"benchmark\": \"GraphLib\",\n  \"scale\": " << scale
+        << ",\n  \"results\": [";
+   Report report(json);
+
+   unsigned sizes[] = { 1000, 10000 };
+   for(unsigned i = 0; i < 2; ++i) {
+      unsigned n = sizes[i] * scale;
+      benchGraph(report, "sparse", n, randomEdges(n, 4));
+      benchGraph(report, "power-law", n, powerLawEdges(n, 3));
+   }
+   unsigned dense[] = { 100, 250 };
+   for(unsigned i = 0; i < 2; ++i) {
+      unsigned n = dense[i] * scale;
+      benchGraph(report, "dense", n, randomEdges(n, n / 4));
+   }
+   benchGridDistances(report, 100 * scale);
+
+   json << "\n  ]\n}" << std::endl;
+   return 0;
+}
@@ -4,10 +4,25 @@
    @version 1.0
 */
 #include "Graph.hh"
+#include "VersionedGraph.hh"
+#include "CompactGraph.hh"
+#include "GraphView.hh"
+#include "DistanceOracle.hh"
+#include "ExternalGraph.hh"
+#include "CompressedGraph.hh"
+#include "DeltaGraph.hh"
+#include "TemporalGraph.hh"
+#include "SparseMatrix.hh"
+#include "Pregel.hh"
+#include "Parallel.hh"
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <string>
 #include <ctime>
 #include <list>
+#include <limits>
+#include <cstdio>
 
 using namespace GraphLib;
 
@@ -290,6 +305,632 @@ void testFloydWarshell() {
    g.floydWarshell(g.transpose().weightMatrix());
 
 }
+void testVersionedGraph() {
+   std::cout << "**** test 20: concurrent readers on graph snapshots" << std::endl;
+   VersionedGraph vg(Graph::undirected);
+   vg.addEdge("0", "1");
+
+   /** readers check that every snapshot they see is consistent:
+       an undirected graph always stores an even number of edges */
+   std::vector<std::thread> readers;
+   std::vector<int> inconsistent(4, 0);
+   for(int r = 0; r < 4; ++r) {
+      readers.push_back(std::thread([&vg, &inconsistent, r]() {
+         for(int i = 0; i < 200; ++i) {
+            VersionedGraph::snapshot_ptr G = vg.snapshot();
+            if(G->edges() % 2 != 0 || !G->isConnected())
+               ++inconsistent[r];
+         }
+      }));
+   }
+   for(int i = 2; i < 50; ++i)
+      vg.addEdge(std::to_string(i - 1), std::to_string(i), i);
+   for(auto t = readers.begin(); t != readers.end(); ++t)
+      t->join();
+
+   int errors = 0;
+   for(auto e = inconsistent.begin(); e != inconsistent.end(); ++e)
+      errors += *e;
+   std::cout << "versions published: " << vg.version()
+             << ", edges: " << vg.snapshot()->edges()
+             << ", inconsistent snapshots: " << errors << std::endl;
+}
+
+void testIncrementalCycle() {
+   std::cout << "**** test 21: incremental cycle detection and connectivity" << std::endl;
+   Graph g;
+   g.addEdge("fetch", "build");
+   g.addEdge("build", "test");
+   g.addEdge("test", "deploy");
+   g.addNode("notify");
+   std::cout << "components: " << g.components() << std::endl;
+   std::cout << "deploy -> fetch creates a cycle? "
+             << g.wouldCreateCycle("deploy", "fetch") << std::endl;
+   std::cout << "fetch -> deploy creates a cycle? "
+             << g.wouldCreateCycle("fetch", "deploy") << std::endl;
+   g.addEdge("deploy", "fetch");
+   std::cout << "cyclic after deploy -> fetch: " << g.isCyclic() << std::endl;
+   g.removeEdge("build", "test");
+   std::cout << "cyclic after removing build -> test: " << g.isCyclic() << std::endl;
+   std::cout << "build and test connected: " << g.connected("build", "test") << std::endl;
+}
+
+void testInstrumentation() {
+   std::cout << "**** test 22: memory usage and runtime statistics" << std::endl;
+   stats::reset();
+   Graph g("1-40", Graph::circular);
+   g.BFS("1");
+   std::cout << std::endl;
+   g.memoryUsage().print(std::cout);
+   /** empty unless compiled with -DGRAPH_STATS */
+   stats::print(std::cout, stats::snapshot());
+}
+
+void testMemoryResource() {
+   std::cout << "**** test 23: graph built inside an arena" << std::endl;
+   /** everything is released at once when the arena goes out of scope */
+   MonotonicResource arena;
+   Graph g(Graph::directed, &arena);
+   for(int i = 0; i < 100; ++i)
+      g.addEdge(std::to_string(i), std::to_string((i + 1) % 100), i);
+   std::cout << "nodes: " << g.nodes() << ", edges: " << g.edges()
+             << ", cyclic: " << g.isCyclic() << std::endl;
+   g.BFS("0");
+   std::cout << std::endl;
+}
+
+void testPageRank() {
+   std::cout << "**** test 24: PageRank" << std::endl;
+   Graph g;
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("c", "a");
+   g.addEdge("a", "c", 3);
+   g.addEdge("d", "a");
+   g.addEdge("c", "e");   // e is dangling
+   std::map<std::string, double> rank = g.pageRank();
+   for(auto r = rank.begin(); r != rank.end(); ++r)
+      std::cout << r->first << ": " << r->second << std::endl;
+
+   std::cout << "personalized on d, approximated by local pushes" << std::endl;
+   rank = g.approximatePageRank("d");
+   for(auto r = rank.begin(); r != rank.end(); ++r)
+      std::cout << r->first << ": " << r->second << std::endl;
+}
+
+void testTriangles() {
+   std::cout << "**** test 25: triangles, clustering coefficient, k-truss" << std::endl;
+   Graph g(Graph::undirected);
+   // two triangles sharing b-c (a 4-clique minus a-d), plus a tail d-e
+   g.addEdge("a", "b");
+   g.addEdge("a", "c");
+   g.addEdge("b", "c");
+   g.addEdge("b", "d");
+   g.addEdge("c", "d");
+   g.addEdge("d", "e");
+   std::cout << "triangles: " << g.triangles() << std::endl;
+   std::map<std::string, unsigned long> count = g.triangleCount();
+   std::map<std::string, double> coefficient = g.clusteringCoefficient();
+   for(auto c = count.begin(); c != count.end(); ++c)
+      std::cout << c->first << ": " << c->second << " triangles, clustering "
+                << coefficient[c->first] << std::endl;
+
+   std::cout << "3-truss:";
+   std::list<std::pair<std::string, std::string> > truss = g.kTruss(3);
+   for(auto e = truss.begin(); e != truss.end(); ++e)
+      std::cout << " " << e->first << "-" << e->second;
+   std::cout << std::endl;
+
+   /** two triangles sharing b-c: a 3-truss, but no 4-truss */
+   Graph diamond(Graph::undirected);
+   diamond.addEdge("a", "b");
+   diamond.addEdge("a", "c");
+   diamond.addEdge("b", "c");
+   diamond.addEdge("d", "b");
+   diamond.addEdge("d", "c");
+   std::cout << "diamond 3-truss: " << diamond.kTruss(3).size() << " edges, 4-truss: "
+             << diamond.kTruss(4).size() << " edges" << std::endl;
+}
+
+void testSpanningForest() {
+   std::cout << "**** test 26: minimum spanning forest" << std::endl;
+   Graph g(Graph::undirected);
+   g.addEdge("a", "b", 4);
+   g.addEdge("a", "c", 1);
+   g.addEdge("b", "c", 2);
+   g.addEdge("b", "d", 5);
+   g.addEdge("c", "d", 8);
+   g.addEdge("e", "f", 3);   // second tree of the forest
+   Graph::SpanningForest kruskal = g.minimumSpanningForest(Graph::kruskal);
+   Graph::SpanningForest boruvka = g.minimumSpanningForest(Graph::boruvka);
+   std::cout << "kruskal:";
+   for(auto e = kruskal.edges.begin(); e != kruskal.edges.end(); ++e)
+      std::cout << " " << e->first << "-" << e->second;
+   std::cout << " weight " << kruskal.weight << std::endl;
+   std::cout << "boruvka:";
+   for(auto e = boruvka.edges.begin(); e != boruvka.edges.end(); ++e)
+      std::cout << " " << e->first << "-" << e->second;
+   std::cout << " weight " << boruvka.weight << std::endl;
+}
+
+void testMaxFlow() {
+   std::cout << "**** test 27: maximum flow / minimum cut" << std::endl;
+   Graph g;
+   g.addEdge("s", "a", 10);
+   g.addEdge("s", "b", 5);
+   g.addEdge("a", "b", 15);
+   g.addEdge("a", "t", 4);
+   g.addEdge("b", "t", 10);
+   std::cout << "max flow s -> t: " << g.maxFlow("s", "t") << std::endl;
+   Graph::Cut cut = g.minCut("s", "t");
+   std::cout << "min cut (" << cut.capacity << "):";
+   for(auto e = cut.edges.begin(); e != cut.edges.end(); ++e)
+      std::cout << " " << e->first << "->" << e->second;
+   std::cout << std::endl;
+}
+
+void testBetweenness() {
+   std::cout << "**** test 28: betweenness centrality" << std::endl;
+   Graph g(Graph::undirected);
+   // two triangles joined by the bridge c-d
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("a", "c");
+   g.addEdge("c", "d");
+   g.addEdge("d", "e");
+   g.addEdge("e", "f");
+   g.addEdge("d", "f");
+   std::map<std::string, double> exact = g.betweenness();
+   for(auto b = exact.begin(); b != exact.end(); ++b)
+      std::cout << b->first << ": " << b->second << std::endl;
+
+   g.setWeight("c", "d", 10);
+   std::cout << "weighted, c-d of length 10, c: " << g.betweenness(true)["c"] << std::endl;
+}
+
+void testCoreNumbers() {
+   std::cout << "**** test 29: k-core decomposition" << std::endl;
+   Graph g(Graph::undirected);
+   // a 4-clique a-b-c-d, e hanging on two of its nodes, f on e
+   g.addEdge("a", "b");
+   g.addEdge("a", "c");
+   g.addEdge("a", "d");
+   g.addEdge("b", "c");
+   g.addEdge("b", "d");
+   g.addEdge("c", "d");
+   g.addEdge("e", "a");
+   g.addEdge("e", "b");
+   g.addEdge("f", "e");
+   std::map<std::string, unsigned> core = g.coreNumbers();
+   std::map<std::string, unsigned> parallel = g.coreNumbers(0);
+   for(auto c = core.begin(); c != core.end(); ++c)
+      std::cout << c->first << ": " << c->second << " (parallel " << parallel[c->first]
+                << ")" << std::endl;
+   std::list<std::string> order = g.degeneracyOrder();
+   std::cout << "degeneracy order:";
+   for(auto v = order.begin(); v != order.end(); ++v)
+      std::cout << " " << *v;
+   std::cout << std::endl;
+}
+
+void testReorder() {
+   std::cout << "**** test 30: vertex reordering" << std::endl;
+   // path a-b-c-d-e-f added out of order
+   Graph g(Graph::undirected);
+   g.addEdge("c", "d");
+   g.addEdge("a", "b");
+   g.addEdge("e", "f");
+   g.addEdge("b", "c");
+   g.addEdge("d", "e");
+   CompactGraph C = g.compact();
+   int strategies[] = { CompactGraph::reverseCuthillMcKee, CompactGraph::degreeSort,
+                        CompactGraph::hubClustering, CompactGraph::gorder };
+   const char* names[] = { "rcm", "degree", "hub", "gorder" };
+   for(unsigned s = 0; s < 4; ++s) {
+      CompactGraph R(C);
+      R.reorder(strategies[s]);
+      unsigned bandwidth = 0;
+      for(unsigned v = 0; v < R.nodes(); ++v) {
+         for(unsigned long e = R.begin(v); e < R.end(v); ++e)
+            bandwidth = std::max(bandwidth, v > R.target(e) ? v - R.target(e) : R.target(e) - v);
+      }
+      std::cout << names[s] << ":";
+      for(unsigned v = 0; v < R.nodes(); ++v)
+         std::cout << " " << R.name(v);
+      std::cout << " (bandwidth " << bandwidth << ")" << std::endl;
+   }
+}
+
+void testGraphView() {
+   std::cout << "**** test 31: filtered views" << std::endl;
+   Graph g;
+   g.addEdge("a", "b", 1);
+   g.addEdge("b", "c", 5);
+   g.addEdge("c", "d", 1);
+   g.addEdge("d", "a", 5);
+   g.addEdge("a", "e", 1);
+   CompactGraph C = g.compact();
+   GraphView all(C);
+
+   auto print = [&](const char* label, const std::vector<unsigned>& order) {
+      std::cout << label << ":";
+      for(auto v = order.begin(); v != order.end(); ++v)
+         std::cout << " " << C.name(*v);
+      std::cout << std::endl;
+   };
+   print("BFS from a", all.BFS(C.id("a")));
+   print("reversed, BFS from a", all.reversed().BFS(C.id("a")));
+   GraphView light = all.filterEdges([](double w) { return w < 2; });
+   print("weight < 2, BFS from a", light.BFS(C.id("a")));
+   print("weight < 2, undirected, DFS from d", light.undirected().DFS(C.id("d")));
+   GraphView noB = all.induced([&](unsigned v) { return C.name(v) != "b"; });
+   print("without b, BFS from a", noB.BFS(C.id("a")));
+
+   std::vector<unsigned> component;
+   std::cout << "components with weight < 2: " << light.components(component) << std::endl;
+
+   /** the CompactGraph analytics run on the view as they are */
+   GraphView both = noB.undirected();
+   std::vector<unsigned> order;
+   std::vector<unsigned> core = both.coreNumbers(order);
+   std::vector<double> rank = noB.pageRank(0.85, 1e-9, 100, 2);
+   std::cout << "without b, undirected: triangles " << both.triangles()
+             << ", core of a " << core[C.id("a")] << ", peeled " << order.size()
+             << ", rank of b " << rank[C.id("b")] << std::endl;
+}
+
+void testMultiSourceBFS() {
+   std::cout << "**** test 32: multi-source BFS" << std::endl;
+   Graph g;
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("c", "d");
+   g.addEdge("e", "c");
+   std::list<std::string> sources;
+   sources.push_back("a");
+   sources.push_back("e");
+   std::map<std::string, std::map<std::string, unsigned> > distance = g.distances(sources);
+   for(auto s = distance.begin(); s != distance.end(); ++s) {
+      std::cout << s->first << ":";
+      for(auto d = s->second.begin(); d != s->second.end(); ++d)
+         std::cout << " " << d->first << "=" << d->second;
+      std::cout << std::endl;
+   }
+
+   std::list<std::pair<std::string, std::string> > queries;
+   queries.push_back(std::make_pair("a", "d"));
+   queries.push_back(std::make_pair("e", "b"));
+   queries.push_back(std::make_pair("d", "a"));
+   std::list<bool> answer = g.reachable(queries);
+   auto r = answer.begin();
+   for(auto q = queries.begin(); q != queries.end(); ++q, ++r)
+      std::cout << q->first << " reaches " << q->second << ": " << *r << std::endl;
+}
+
+void testReachabilityIndex() {
+   std::cout << "**** test 33: reachability index" << std::endl;
+   Graph g;
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("c", "a");   // a, b, c form one component
+   g.addEdge("c", "d");
+   g.addEdge("e", "d");
+   g.indexReachability();
+   std::cout << "a reaches d: " << g.reachable("a", "d")
+             << ", d reaches a: " << g.reachable("d", "a")
+             << ", e reaches b: " << g.reachable("e", "b") << std::endl;
+   g.addEdge("d", "e");
+   std::cout << "after d -> e, e reaches b: " << g.reachable("e", "b") << std::endl;
+   g.removeEdge("c", "d");
+   std::cout << "after removing c -> d, a reaches d: " << g.reachable("a", "d") << std::endl;
+   g.addEdge("a", "c");
+   g.removeEdge("a", "c");   // a -> b -> c still goes around it
+   std::cout << "after a -> c and back, a reaches c: " << g.reachable("a", "c");
+   g.removeEdge("b", "c");   // splits the component
+   std::cout << ", after removing b -> c, b reaches a: " << g.reachable("b", "a") << std::endl;
+}
+
+void testDistanceOracle() {
+   std::cout << "**** test 34: landmark distance oracle" << std::endl;
+   Graph g;
+   g.addEdge("a", "b", 4);
+   g.addEdge("a", "c", 1);
+   g.addEdge("c", "b", 2);
+   g.addEdge("b", "d", 1);
+   g.addEdge("c", "d", 5);
+   g.addEdge("d", "e", 3);
+   g.addEdge("f", "a", 1);
+   DistanceOracle oracle(g, 2, 8);
+   std::cout << "a -> e: " << oracle.distance("a", "e") << " via";
+   std::list<std::string> path = oracle.path("a", "e");
+   for(auto v = path.begin(); v != path.end(); ++v)
+      std::cout << " " << *v;
+   std::cout << std::endl;
+   std::cout << "e -> a: " << oracle.distance("e", "a")
+             << ", f -> d: " << oracle.distance("f", "d") << std::endl;
+}
+
+void testExternalGraph() {
+   std::cout << "**** test 35: semi-external graph" << std::endl;
+   ExternalGraph::Writer writer("test_external", 6, 3);
+   writer.addEdge(0, 1);
+   writer.addEdge(1, 2);
+   writer.addEdge(2, 0);
+   writer.addEdge(4, 3);
+   writer.addEdge(4, 5);
+   writer.close();
+
+   ExternalGraph g("test_external");
+   std::vector<unsigned> level = g.BFS(0);
+   std::cout << g.partitions() << " partitions, BFS from 0:";
+   for(unsigned v = 0; v < g.nodes(); ++v) {
+      if(level[v] == CompactGraph::unreachable)
+         std::cout << " -";
+      else
+         std::cout << " " << level[v];
+   }
+   std::vector<unsigned> component;
+   std::cout << std::endl << g.components(component) << " components, PageRank:";
+   std::vector<double> rank = g.pageRank();
+   for(unsigned v = 0; v < g.nodes(); ++v)
+      std::cout << " " << rank[v];
+   std::cout << std::endl;
+
+   std::remove("test_external.graph");
+   for(unsigned p = 0; p < g.partitions(); ++p)
+      std::remove(("test_external." + std::to_string(p) + ".edges").c_str());
+
+   /** a path over 3 partitions, the middle one lost: no partial answer */
+   ExternalGraph::Writer path("test_external", 9, 3, Graph::undirected);
+   for(unsigned v = 0; v + 1 < 9; ++v)
+      path.addEdge(v, v + 1);
+   path.close();
+   std::remove("test_external.1.edges");
+   ExternalGraph lost("test_external");
+   std::cout << "without partition 1: good " << lost.good();
+   std::cout << ", BFS " << lost.BFS(0).size() << " nodes";
+   std::cout << ", good " << lost.good();
+   std::cout << ", " << lost.components(component) << " components";
+   std::cout << ", PageRank " << lost.pageRank().size() << " nodes" << std::endl;
+   std::remove("test_external.graph");
+   for(unsigned p = 0; p < lost.partitions(); ++p)
+      std::remove(("test_external." + std::to_string(p) + ".edges").c_str());
+}
+
+void testPregel() {
+   std::cout << "**** test 36: vertex-centric engine" << std::endl;
+   Graph g;
+   g.addEdge("a", "b", 4);
+   g.addEdge("a", "c", 1);
+   g.addEdge("c", "b", 2);
+   g.addEdge("b", "d", 1);
+   g.addEdge("e", "d", 1);
+   CompactGraph C(g);
+
+   /** single source shortest paths from a, the smallest distance wins */
+   typedef Pregel<double, double> Engine;
+   Engine engine(C, 2);
+   engine.combiner([](double& kept, const double& other) { kept = std::min(kept, other); });
+   unsigned updates = engine.aggregator([](double x, double y) { return x + y; }, 0);
+   const double unreached = 1e300;
+   std::vector<double> distance;
+   unsigned supersteps = engine.run([&](Engine::Context& node, const Engine::Messages& in) {
+      if(node.superstep() == 0)
+         node.value() = unreached;
+      double best = node.superstep() == 0 && node.vertex() == C.id("a") ? 0 : unreached;
+      for(auto m = in.begin(); m != in.end(); ++m)
+         best = std::min(best, *m);
+      if(best < node.value()) {
+         node.value() = best;
+         node.aggregate(updates, 1);
+         for(unsigned long e = C.begin(node.vertex()); e < C.end(node.vertex()); ++e)
+            node.sendMessage(C.target(e), best + C.weight(e));
+      }
+      node.voteToHalt();
+   }, distance);
+
+   std::cout << supersteps << " supersteps, " << engine.messages() << " messages:";
+   for(unsigned v = 0; v < C.nodes(); ++v) {
+      std::cout << " " << C.name(v) << "=";
+      if(distance[v] == unreached)
+         std::cout << "-";
+      else
+         std::cout << distance[v];
+   }
+   std::cout << std::endl;
+}
+
+void testScheduler() {
+   std::cout << "**** test 37: shared scheduler, scopes and futures" << std::endl;
+   parallel::configure(4);
+   Graph g;
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("c", "a");
+   g.addEdge("c", "d");
+   CompactGraph C(g);
+
+   /** a request bounded to 2 threads, its queries run concurrently */
+   parallel::Scope request(2);
+   std::cout << "threads in the scope: " << parallel::threads(0) << std::endl;
+   std::future<std::vector<double> > rank = parallel::async([&]() { return C.pageRank(); });
+   std::future<unsigned long> triangles = parallel::async([&]() { return C.triangles(); });
+   std::cout << "PageRank of d: " << rank.get()[C.id("d")]
+             << ", triangles: " << triangles.get() << std::endl;
+
+   parallel::Cancellation cancellation;
+   parallel::Scope cancellable(0, cancellation);
+   cancellation.cancel();
+   std::cout << "cancelled: " << parallel::cancelled()
+             << ", PageRank of d after no iteration: " << C.pageRank()[C.id("d")]
+             << ", interrupted: " << cancellable.interrupted() << std::endl;
+   /** unanswered queries are not reported as "no" */
+   std::list<std::pair<std::string, std::string> > queries;
+   queries.push_back(std::make_pair("a", "d"));
+   std::cout << "answers after the cancellation: " << g.reachable(queries).size()
+             << ", outer scope interrupted: " << request.interrupted() << std::endl;
+}
+
+void testCompressedGraph() {
+   std::cout << "**** test 38: compressed adjacency" << std::endl;
+   Graph g;
+   for(unsigned v = 0; v < 8; ++v)
+      g.addNode(std::to_string(v));
+   /** consecutive lists that mostly repeat each other */
+   for(unsigned v = 0; v < 4; ++v) {
+      for(unsigned w = 4; w < 8; ++w) {
+         if(w != v + 4 || v == 0)
+            g.addEdge(std::to_string(v), std::to_string(w));
+      }
+   }
+   g.addEdge("7", "0");
+   CompactGraph C(g);
+   CompressedGraph Z(C);
+
+   std::vector<unsigned> list;
+   for(unsigned v = 0; v < 4; ++v) {
+      Z.neighbours(C.id(std::to_string(v)), list);
+      std::cout << v << ":";
+      for(auto w = list.begin(); w != list.end(); ++w)
+         std::cout << " " << C.name(*w);
+      std::cout << std::endl;
+   }
+   std::vector<unsigned> level = Z.BFS(C.id("1"));
+   std::cout << "hops from 1 to 0: " << level[C.id("0")]
+             << ", edges: " << Z.edges() << ", bytes: " << Z.bitsPerEdge() * Z.edges() / 8
+             << std::endl;
+}
+
+void testDeltaGraph() {
+   std::cout << "**** test 39: delta layers over a compact base" << std::endl;
+   Graph g;
+   g.addEdge("a", "b");
+   g.addEdge("b", "c");
+   g.addEdge("c", "d");
+   DeltaGraph D(g);
+
+   D.addEdge("a", "c", 2);
+   D.removeEdge("b", "c");
+   DeltaGraph::Snapshot before = D.snapshot();
+   D.addEdge("d", "e");
+   D.removeEdge("a", "b");
+   DeltaGraph::Snapshot after = D.snapshot();
+
+   std::vector<unsigned> hops = before.BFS(D.id("a"));
+   std::cout << "before: " << before.edges() << " edges, " << before.layers()
+             << " layer, a -> d in " << hops[D.id("d")] << " hops, b -> c: "
+             << before.hasEdge(D.id("b"), D.id("c")) << std::endl;
+   hops = after.BFS(D.id("a"));
+   std::cout << "after: " << after.edges() << " edges, " << after.layers()
+             << " layers, a -> e in " << hops[D.id("e")] << " hops, a -> b: "
+             << after.hasEdge(D.id("a"), D.id("b")) << std::endl;
+
+   D.compact();
+   DeltaGraph::Snapshot compacted = D.snapshot();
+   std::cout << "compacted: " << compacted.base().edges() << " edges in the base, "
+             << compacted.layers() << " layers, pending " << D.pending()
+             << ", weight a -> c: " << D.weight("a", "c") << std::endl;
+}
+
+void testTemporalGraph() {
+   std::cout << "**** test 40: time windows and time-respecting paths" << std::endl;
+   TemporalGraph T;
+   T.addEdge("a", "b", 1, 1);
+   T.addEdge("b", "c", 5, 8);
+   T.addEdge("c", "d", 3, 4);
+   T.addEdge("a", "c", 2, 10, 5);
+   T.addEdge("c", "d", 9, 9);
+
+   std::list<std::string> adjacent = T.adjacent("a", 0, 1);
+   std::cout << "a in [0, 1]:";
+   for(auto v = adjacent.begin(); v != adjacent.end(); ++v)
+      std::cout << " " << *v;
+   std::vector<double> length = T.shortestPaths(T.id("a"), 0, 10);
+   std::vector<unsigned> hops = T.BFS(T.id("a"), 5, 10);
+   std::cout << std::endl << "a -> c in [0, 10]: " << length[T.id("c")]
+             << ", hops to d in [5, 10]: " << hops[T.id("d")] << std::endl;
+
+   std::vector<double> arrival = T.earliestArrival(T.id("a"), 0, 10);
+   std::cout << "earliest arrival at c: " << arrival[T.id("c")]
+             << ", at d: " << arrival[T.id("d")]
+             << ", at d leaving a at 5: " << T.earliestArrival(T.id("a"), 5, 10)[T.id("d")]
+             << std::endl;
+
+   /** a link that never ends sits in its own tier, the short ones of b
+       are still found by start */
+   T.addEdge("b", "e", 0, std::numeric_limits<double>::infinity());
+   T.addEdge("b", "d", 20, 21);
+   adjacent = T.adjacent("b", 20, 30);
+   std::cout << "b in [20, 30]:";
+   for(auto v = adjacent.begin(); v != adjacent.end(); ++v)
+      std::cout << " " << *v;
+   std::cout << ", in [6, 6]: " << T.adjacent("b", 6, 6).size() << std::endl;
+}
+
+void testSparseMatrix() {
+   std::cout << "**** test 41: graph algorithms as sparse linear algebra" << std::endl;
+   Graph g(Graph::undirected);
+   g.addEdge("a", "b", 1);
+   g.addEdge("b", "c", 2);
+   g.addEdge("a", "c", 4);
+   g.addEdge("c", "d", 1);
+   g.addNode("e");
+   CompactGraph C(g);
+   SparseMatrix A(C);
+
+   std::vector<unsigned> hops = algebra::BFS(A, C.id("a"));
+   std::vector<double> length = algebra::shortestPaths(A, C.id("a"));
+   std::cout << "a -> d: " << hops[C.id("d")] << " hops, length " << length[C.id("d")]
+             << ", triangles: " << algebra::triangles(A) << std::endl;
+
+   /** paths of two edges: A A over plus-times counts them, over max-min
+       gives the widest one */
+   SparseMatrix paths = A.mxm<semiring::PlusTimes>(A);
+   SparseMatrix widest = A.mxm<semiring::MaxMin>(A);
+   std::cout << "a to a in two steps: " << paths.get<semiring::PlusTimes>(C.id("a"), C.id("a"))
+             << " weighted walks, widest a -> d: "
+             << widest.get<semiring::MaxMin>(C.id("a"), C.id("d")) << std::endl;
+
+   SparseMatrix R = algebra::reachability(A, std::vector<unsigned>(1, C.id("e")));
+   std::cout << "reachable from e: " << R.entries() << " of " << A.rows() << std::endl;
+}
+
+void testTombstones() {
+   std::cout << "**** test 42: removals as tombstones, vacuumed on demand" << std::endl;
+   Graph G;
+   G.setVacuumThreshold(1);
+   for(int i = 0; i < 6; ++i)
+      G.addEdge(std::to_string(i), std::to_string((i + 1) % 6));
+   G.removeNode("2");
+   G.removeEdge("4", "5");
+   std::cout << G.nodes() << " nodes, " << G.edges() << " edges, "
+             << G.tombstones() << " tombstones" << std::endl;
+   std::cout << G;
+   G.addEdge("2", "4");
+   G.vacuum();
+   std::cout << "after vacuum: " << G.tombstones() << " tombstones, "
+             << G.compact().nodes() << " nodes compacted" << std::endl;
+   std::cout << G;
+}
+
+void testPropertyCache() {
+   std::cout << "**** test 43: cached properties and the mutation version" << std::endl;
+   Graph G(Graph::undirected);
+   G.addEdge("a", "b");
+   G.addEdge("b", "c");
+   G.addEdge("c", "a");
+   std::cout << "version " << G.version() << ": connected " << G.isConnected()
+             << ", eulerian " << G.isEulerian() << ", regular " << G.isRegular() << std::endl;
+   /** a new weight keeps the cached connectivity, not the weight checks */
+   G.setWeight("a", "b", -1);
+   std::cout << "version " << G.version() << ": connected " << G.isConnected()
+             << ", negative weight " << G.hasNegativeWeigth() << std::endl;
+   G.addEdge("c", "d");
+   std::cout << "version " << G.version() << ": eulerian " << G.isEulerian()
+             << ", regular " << G.isRegular() << ", min rank " << G.minRank()
+             << ", max rank " << G.maxRank() << std::endl;
+}
+
 int main() {
    testRandomGraphGenerator();
    testGraphInterval();
@@ -304,4 +945,28 @@ int main() {
    testBFS();
    testDFS();
    testFloydWarshell();
+   testVersionedGraph();
+   testIncrementalCycle();
+   testInstrumentation();
+   testMemoryResource();
+   testPageRank();
+   testTriangles();
+   testSpanningForest();
+   testMaxFlow();
+   testBetweenness();
+   testCoreNumbers();
+   testReorder();
+   testGraphView();
+   testMultiSourceBFS();
+   testReachabilityIndex();
+   testDistanceOracle();
+   testExternalGraph();
+   testPregel();
+   testScheduler();
+   testCompressedGraph();
+   testDeltaGraph();
+   testTemporalGraph();
+   testSparseMatrix();
+   testTombstones();
+   testPropertyCache();
 }
\ No newline at end of file